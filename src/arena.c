@@ -0,0 +1,265 @@
+// Far Horizons Game Engine
+// Copyright (C) 2022 Michael D Henderson
+// Copyright (C) 2021 Raven Zachary
+// Copyright (C) 2019 Casey Link, Adam Piggott
+// Copyright (C) 1999 Richard A. Morneau
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+#include "cjson/cJSON.h"
+#include "engine.h"
+
+
+// arena blocks are this big unless a single request needs more
+#define ARENA_BLOCK_SIZE (1024 * 1024)
+
+// every allocation from the arena starts on a multiple of this
+#define ARENA_ALIGNMENT 16
+
+typedef struct arena_block {
+    struct arena_block *next;
+    size_t size;
+    size_t used;
+    unsigned char *data;
+} arena_block_t;
+
+// the bytes and calls counted for one call site
+typedef struct {
+    const char *fn;
+    int line;
+    int from_arena;
+    long calls;
+    size_t bytes;
+} alloc_site_t;
+
+int alloc_stats = FALSE;
+
+static struct {
+    arena_block_t *blocks;   // blocks in use, newest first
+    arena_block_t *spare;    // full-size blocks kept by arenaReset for reuse
+    size_t bytes_in_use;
+    size_t peak_bytes;
+    long resets;
+    pthread_mutex_t lock;
+} arena = {NULL, NULL, 0, 0, 0, PTHREAD_MUTEX_INITIALIZER};
+
+static struct {
+    int num_sites;
+    int max_sites;
+    alloc_site_t *site;      // open addressing on fn and line
+    pthread_mutex_t lock;
+} stats = {0, 0, NULL, PTHREAD_MUTEX_INITIALIZER};
+
+
+static int allocSiteCompare(const void *a, const void *b);
+
+static void allocStatsAtExit(void);
+
+static void *jsonMalloc(size_t size);
+
+
+// allocSiteCompare orders call sites by bytes, largest first, then by name and line.
+static int allocSiteCompare(const void *a, const void *b) {
+    const alloc_site_t *sa = (const alloc_site_t *) a;
+    const alloc_site_t *sb = (const alloc_site_t *) b;
+    if (sa->bytes != sb->bytes) {
+        return sa->bytes > sb->bytes ? -1 : 1;
+    }
+    int cmp = strcmp(sa->fn, sb->fn);
+    if (cmp != 0) {
+        return cmp;
+    }
+    return sa->line - sb->line;
+}
+
+
+// allocStatsAtExit prints the statistics when the program ends, however it ends.
+static void allocStatsAtExit(void) {
+    allocStatsPrint(stderr);
+}
+
+
+// allocStatsEnable starts counting allocations and arranges for the table to be printed at exit.
+// The JSON library is routed through the counters too.
+void allocStatsEnable(void) {
+    static cJSON_Hooks hooks = {jsonMalloc, free};
+    if (alloc_stats) {
+        return;
+    }
+    alloc_stats = TRUE;
+    cJSON_InitHooks(&hooks);
+    atexit(allocStatsAtExit);
+}
+
+
+// allocStatsPrint writes the bytes and calls of every call site, largest first.
+void allocStatsPrint(FILE *fp) {
+    pthread_mutex_lock(&stats.lock);
+    alloc_site_t *sorted = (alloc_site_t *) calloc(stats.num_sites + 1, sizeof(alloc_site_t));
+    int n = 0;
+    size_t total_bytes = 0;
+    long total_calls = 0;
+    for (int i = 0; i < stats.max_sites; i++) {
+        if (stats.site[i].fn != NULL) {
+            sorted[n++] = stats.site[i];
+            total_bytes += stats.site[i].bytes;
+            total_calls += stats.site[i].calls;
+        }
+    }
+    pthread_mutex_unlock(&stats.lock);
+    qsort(sorted, n, sizeof(alloc_site_t), allocSiteCompare);
+
+    fprintf(fp, "alloc-stats: %14s %10s  %-5s  %s\n", "bytes", "calls", "from", "call site");
+    for (int i = 0; i < n; i++) {
+        fprintf(fp, "alloc-stats: %14zu %10ld  %-5s  %s:%d\n", sorted[i].bytes, sorted[i].calls,
+                sorted[i].from_arena ? "arena" : "heap", sorted[i].fn, sorted[i].line);
+    }
+    fprintf(fp, "alloc-stats: %14zu %10ld  total\n", total_bytes, total_calls);
+    fprintf(fp, "alloc-stats: arena peak %zu bytes, %ld resets\n", arena.peak_bytes, arena.resets);
+    free(sorted);
+}
+
+
+// allocStatsRecord counts one allocation of bytes at a call site.
+void allocStatsRecord(const char *fn, int line, size_t bytes, int from_arena) {
+    pthread_mutex_lock(&stats.lock);
+    if (2 * (stats.num_sites + 1) > stats.max_sites) {
+        /* Keep the table at most half full; rehash into one twice the size. */
+        alloc_site_t *old = stats.site;
+        int old_max = stats.max_sites;
+        stats.max_sites = old_max == 0 ? 256 : 2 * old_max;
+        stats.site = (alloc_site_t *) calloc(stats.max_sites, sizeof(alloc_site_t));
+        if (stats.site == NULL) {
+            perror("allocStatsRecord");
+            exit(2);
+        }
+        for (int i = 0; i < old_max; i++) {
+            if (old[i].fn == NULL) {
+                continue;
+            }
+            uint32_t h = ((uint32_t) (uintptr_t) old[i].fn * 31u + (uint32_t) old[i].line * 2u + old[i].from_arena) * 2654435761u;
+            int j = (int) (h & (uint32_t) (stats.max_sites - 1));
+            while (stats.site[j].fn != NULL) {
+                j = (j + 1) & (stats.max_sites - 1);
+            }
+            stats.site[j] = old[i];
+        }
+        free(old);
+    }
+
+    /* Function names are string literals, so the pointer identifies the function. */
+    uint32_t h = ((uint32_t) (uintptr_t) fn * 31u + (uint32_t) line * 2u + from_arena) * 2654435761u;
+    int j = (int) (h & (uint32_t) (stats.max_sites - 1));
+    while (stats.site[j].fn != NULL) {
+        alloc_site_t *s = &stats.site[j];
+        if (s->fn == fn && s->line == line && s->from_arena == from_arena) {
+            break;
+        }
+        j = (j + 1) & (stats.max_sites - 1);
+    }
+    alloc_site_t *s = &stats.site[j];
+    if (s->fn == NULL) {
+        s->fn = fn;
+        s->line = line;
+        s->from_arena = from_arena;
+        stats.num_sites++;
+    }
+    s->calls++;
+    s->bytes += bytes;
+    pthread_mutex_unlock(&stats.lock);
+}
+
+
+// arenaAlloc returns count * size zeroed bytes that live until the next arenaReset.
+// Like ncalloc, it exits if the memory can not be had.
+void *arenaAlloc(const char *fn, int line, int count, int size) {
+    size_t bytes = (size_t) count * (size_t) size;
+    size_t rounded = (bytes + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1);
+    if (rounded == 0) {
+        rounded = ARENA_ALIGNMENT;
+    }
+
+    pthread_mutex_lock(&arena.lock);
+    arena_block_t *block = arena.blocks;
+    if (block == NULL || block->size - block->used < rounded) {
+        if (rounded <= ARENA_BLOCK_SIZE && arena.spare != NULL) {
+            block = arena.spare;
+            arena.spare = block->next;
+        } else {
+            size_t block_size = rounded > ARENA_BLOCK_SIZE ? rounded : ARENA_BLOCK_SIZE;
+            block = (arena_block_t *) calloc(1, sizeof(arena_block_t));
+            if (block != NULL) {
+                /* malloc returns memory suitably aligned for any type, which covers ARENA_ALIGNMENT. */
+                block->data = (unsigned char *) malloc(block_size);
+            }
+            if (block == NULL || block->data == NULL) {
+                char msg[256];
+                snprintf(msg, 256, "%s: %d: arenaAlloc(%d, %d) failed", fn, line, count, size);
+                perror(msg);
+                exit(2);
+            }
+            block->size = block_size;
+        }
+        block->used = 0;
+        block->next = arena.blocks;
+        arena.blocks = block;
+    }
+    void *p = block->data + block->used;
+    block->used += rounded;
+    arena.bytes_in_use += rounded;
+    if (arena.bytes_in_use > arena.peak_bytes) {
+        arena.peak_bytes = arena.bytes_in_use;
+    }
+    pthread_mutex_unlock(&arena.lock);
+
+    if (alloc_stats) {
+        allocStatsRecord(fn, line, bytes, TRUE);
+    }
+    memset(p, 0, bytes);
+    return p;
+}
+
+
+// arenaReset releases everything the arena has handed out.
+// Full-size blocks are kept to serve the next phase; larger ones go back to the system.
+void arenaReset(void) {
+    pthread_mutex_lock(&arena.lock);
+    while (arena.blocks != NULL) {
+        arena_block_t *block = arena.blocks;
+        arena.blocks = block->next;
+        if (block->size == ARENA_BLOCK_SIZE) {
+            block->next = arena.spare;
+            arena.spare = block;
+        } else {
+            free(block->data);
+            free(block);
+        }
+    }
+    arena.bytes_in_use = 0;
+    arena.resets++;
+    pthread_mutex_unlock(&arena.lock);
+}
+
+
+// jsonMalloc counts the allocations made by the JSON library as one call site.
+static void *jsonMalloc(size_t size) {
+    allocStatsRecord("cJSON", 0, size, FALSE);
+    return malloc(size);
+}
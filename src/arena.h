@@ -0,0 +1,47 @@
+// Far Horizons Game Engine
+// Copyright (C) 2022 Michael D Henderson
+// Copyright (C) 2021 Raven Zachary
+// Copyright (C) 2019 Casey Link, Adam Piggott
+// Copyright (C) 1999 Richard A. Morneau
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef FAR_HORIZONS_ARENA_H
+#define FAR_HORIZONS_ARENA_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+// The arena serves memory that is only needed until the end of the current phase:
+// translation buffers, scratch tables, and the like. It is carved from large blocks,
+// is never freed piece by piece, and is all released by arenaReset.
+// Memory from the arena must not be passed to free().
+//
+// When allocation statistics are on, ncalloc and arenaAlloc count the bytes and calls
+// of every call site, and the table is printed to stderr when the program exits.
+
+extern int alloc_stats;
+
+void *arenaAlloc(const char *fn, int line, int count, int size);
+
+void arenaReset(void);
+
+void allocStatsEnable(void);
+
+void allocStatsPrint(FILE *fp);
+
+void allocStatsRecord(const char *fn, int line, size_t bytes, int from_arena);
+
+#endif //FAR_HORIZONS_ARENA_H
@@ -6,6 +6,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "helpers.h"
+#include "../arena.h"
 #include "../memsafe.h"
 
 
@@ -54,6 +55,19 @@ void jsonAddItemToObj(cJSON *obj, const char *objName, const char *propName, cJS
     }
 }
 
+void jsonAddStringToArray(cJSON *array, const char *arrayName, const char *value) {
+    cJSON *item = cJSON_CreateString(value);
+    if (item == 0) {
+        perror("cJSON_CreateString:");
+        fprintf(stderr, "%s: unable to create string for array\n", arrayName);
+        exit(2);
+    } else if (cJSON_AddItemToArray(array, item) == 0) {
+        perror("cJSON_AddItemToArray:");
+        fprintf(stderr, "%s: unable to add string to array\n", arrayName);
+        exit(2);
+    }
+}
+
 void jsonAddStringToObj(cJSON *obj, const char *objName, const char *propName, const char *value) {
     if (cJSON_AddStringToObject(obj, propName, value) == 0) {
         perror("cJSON_AddStringToObject:");
@@ -119,11 +133,7 @@ cJSON *jsonParseFile(const char *name) {
         exit(2);
     }
     long length = ftell(fp);
-    char *buffer = calloc(1, length + 1);
-    if (buffer == 0) {
-        perror("json: parseFile: allocating buffer");
-        exit(2);
-    }
+    char *buffer = arenaAlloc(__FUNCTION__, __LINE__, 1, (int) length + 1);
     // return to the beginning and read the entire file
     if (fseek(fp, 0, SEEK_SET) != 0) {
         perror("json: parseFile: seeking to start of input");
@@ -168,6 +178,6 @@ void jsonWriteFile(cJSON *root, const char *kind, const char *name) {
     fprintf(fp, "%s\n", string);
     fclose(fp);
     // release the memory
-    free(string);
+    cJSON_free(string);
 }
 
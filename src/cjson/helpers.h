@@ -17,6 +17,8 @@ void jsonAddItemToArray(cJSON *array, const char *objName, cJSON *value);
 
 void jsonAddItemToObj(cJSON *obj, const char *objName, const char *propName, cJSON *value);
 
+void jsonAddStringToArray(cJSON *array, const char *arrayName, const char *value);
+
 void jsonAddStringToObj(cJSON *obj, const char *objName, const char *propName, const char *value);
 
 int jsonGetBool(cJSON *obj, const char *property);
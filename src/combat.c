@@ -17,6 +17,7 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <pthread.h>
 #include <unistd.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -27,9 +28,12 @@
 #include "enginevars.h"
 #include "galaxyio.h"
 #include "log.h"
+#include "logsink.h"
 #include "logvars.h"
+#include "ordercache.h"
 #include "planetio.h"
 #include "prng.h"
+#include "sector.h"
 #include "species.h"
 #include "speciesio.h"
 #include "speciesvars.h"
@@ -45,25 +49,183 @@
 #include "transaction.h"
 #include "transactionio.h"
 
-int ambush_took_place;
-char append_log[MAX_SPECIES];
-int attacking_ML;
+
+// battle_result_t holds everything that a battle changes outside of the units in its own sector.
+// Battles are fought in parallel, each into its own result, and the results are merged in
+// battle order afterwards, so the outcome does not depend on how many battles run at once.
+typedef struct battle_result {
+    char *log;                                 // text of the combat log
+    size_t log_length;
+    char *summary;                             // text of the summary log
+    size_t summary_length;
+    long econ_units[MAX_SPECIES];              // economic units gained by hijacking, by species index
+    char make_enemy[MAX_SPECIES][MAX_SPECIES]; // enmities to declare, same layout as make_enemy
+    int num_transactions;
+    int max_transactions;
+    struct trans_data *transaction;            // grows as the battle makes transactions
+    int num_rounds;                            // rounds in which shots were fired
+} battle_result_t;
+
+// battle_pool_t hands out the battles to the worker threads.
+typedef struct battle_pool {
+    int num_battles;
+    int next_battle;
+    battle_result_t *result;
+    pthread_mutex_t lock;
+} battle_pool_t;
+
+// battle_outcome_t is what one simulated battle did to each species, by species index in the battle.
+typedef struct battle_outcome {
+    int num_rounds;
+    int ships_left[MAX_SPECIES];
+    int ships_withdrawn[MAX_SPECIES];
+    int ships_destroyed[MAX_SPECIES];
+    int planets_lost[MAX_SPECIES];
+    int planets_damaged[MAX_SPECIES];
+} battle_outcome_t;
+
+// simulate_pool_t hands out the simulated battles to the worker threads.
+typedef struct simulate_pool {
+    struct battle_data *bat;
+    int num_runs;
+    int next_run;
+    battle_outcome_t *outcome;
+    pthread_mutex_t lock;
+} simulate_pool_t;
+
+
+static void actionFree(struct action_data *act);
+
+static void actionGrow(struct action_data *act);
+
+static struct battle_data *battleAdd(int num_battles);
+
+static void battleAddEnemy(struct battle_species *bs, int index, int enemy);
+
+static void battleAddEngageOption(struct battle_species *bs, int option, int planet);
+
+static int battleAddSpecies(struct battle_data *bat, int species_number, int default_summary);
+
+static int battleEnemy(struct battle_data *bat, int species_index1, int species_index2);
+
+static uint64_t battleKey(struct battle_data *bat);
+
+static void battleFree(int num_battles);
+
+static void battleSetEnemy(struct battle_data *bat, int species_index1, int species_index2, int value);
+
+static struct trans_data *battleTransaction(void);
+
+static int dropIdleShots(struct action_data *act, int drop_non_combatants);
+
+static void fightBattle(struct battle_data *bat, battle_result_t *result, const char *stream, uint64_t key);
+
+static void fightBattles(int num_battles, int jobs);
+
+static void *fightBattlesWorker(void *arg);
+
+static void mergeBattle(struct battle_data *bat, battle_result_t *result, int last_battle);
+
+static int resetShots(struct action_data *act);
+
+static void simulateBattle(struct battle_data *bat, int num_runs, int jobs);
+
+static void simulateBattleRun(struct battle_data *bat, int run, battle_outcome_t *outcome);
+
+static void *simulateBattleWorker(void *arg);
+
+
+// globals used while a battle is being fought belong to the thread that is fighting it
+THREAD_LOCAL int ambush_took_place;
+THREAD_LOCAL int attacking_ML;
 struct battle_data *battle_base;
-struct nampla_data *c_nampla[MAX_SPECIES];
-struct ship_data *c_ship[MAX_SPECIES];
-struct species_data *c_species[MAX_SPECIES];
-char combat_location[1000];
-char combat_option[1000];
-int deep_space_defense;
-int defending_ML;
-char field_distorted[MAX_SPECIES];
-int first_battle = TRUE;
-short germ_bombs_used[MAX_SPECIES][MAX_SPECIES];
+static int max_battles;
+static int simulate_runs;                 // with --simulate, the number of times to fight the battle
+static int simulate_x, simulate_y, simulate_z;
+static THREAD_LOCAL battle_result_t *battle_result;
+THREAD_LOCAL struct nampla_data *c_nampla[MAX_SPECIES];
+THREAD_LOCAL struct ship_data *c_ship[MAX_SPECIES];
+THREAD_LOCAL struct species_data *c_species[MAX_SPECIES];
+THREAD_LOCAL char combat_location[1000];
+THREAD_LOCAL char combat_option[1000];
+THREAD_LOCAL int deep_space_defense;
+THREAD_LOCAL int defending_ML;
+THREAD_LOCAL char field_distorted[MAX_SPECIES];
+THREAD_LOCAL int first_battle = TRUE;
+THREAD_LOCAL short germ_bombs_used[MAX_SPECIES][MAX_SPECIES];
 char make_enemy[MAX_SPECIES][MAX_SPECIES];
-int num_combat_options;
+THREAD_LOCAL int num_combat_options;
 int strike_phase = FALSE;
-char x_attacked_y[MAX_SPECIES][MAX_SPECIES];
+THREAD_LOCAL char x_attacked_y[MAX_SPECIES][MAX_SPECIES];
+
+
+// actionFree releases the unit arrays of an action.
+static void actionFree(struct action_data *act) {
+    free(act->fighting_species_index);
+    free(act->num_shots);
+    free(act->shots_left);
+    free(act->weapon_damage);
+    free(act->shield_strength);
+    free(act->shield_strength_left);
+    free(act->original_age_or_PDs);
+    free(act->bomb_damage);
+    free(act->surprised);
+    free(act->unit_type);
+    free(act->fighting_unit);
+    free(act->target_index);
+    free(act->shield_regen);
+    free(act->age);
+    free(act->jumped);
+    free(act->non_combatant);
+    free(act->ship_class);
+    free(act->ship_type);
+    memset(act, 0, sizeof(struct action_data));
+}
 
+// actionGrow makes room for more units in an action, keeping the units already there.
+static void actionGrow(struct action_data *act) {
+    struct action_data old = *act;
+    int size = old.max_units == 0 ? 64 : 2 * old.max_units;
+    act->fighting_species_index = ncalloc(__FUNCTION__, __LINE__, size, sizeof(int));
+    act->num_shots = ncalloc(__FUNCTION__, __LINE__, size, sizeof(int));
+    act->shots_left = ncalloc(__FUNCTION__, __LINE__, size, sizeof(int));
+    act->weapon_damage = ncalloc(__FUNCTION__, __LINE__, size, sizeof(long));
+    act->shield_strength = ncalloc(__FUNCTION__, __LINE__, size, sizeof(long));
+    act->shield_strength_left = ncalloc(__FUNCTION__, __LINE__, size, sizeof(long));
+    act->original_age_or_PDs = ncalloc(__FUNCTION__, __LINE__, size, sizeof(long));
+    act->bomb_damage = ncalloc(__FUNCTION__, __LINE__, size, sizeof(long));
+    act->surprised = ncalloc(__FUNCTION__, __LINE__, size, sizeof(char));
+    act->unit_type = ncalloc(__FUNCTION__, __LINE__, size, sizeof(char));
+    act->fighting_unit = ncalloc(__FUNCTION__, __LINE__, size, sizeof(char *));
+    act->target_index = ncalloc(__FUNCTION__, __LINE__, size, sizeof(int));
+    act->shield_regen = ncalloc(__FUNCTION__, __LINE__, size, sizeof(int));
+    act->age = ncalloc(__FUNCTION__, __LINE__, size, sizeof(int));
+    act->jumped = ncalloc(__FUNCTION__, __LINE__, size, sizeof(char));
+    act->non_combatant = ncalloc(__FUNCTION__, __LINE__, size, sizeof(char));
+    act->ship_class = ncalloc(__FUNCTION__, __LINE__, size, sizeof(char));
+    act->ship_type = ncalloc(__FUNCTION__, __LINE__, size, sizeof(char));
+    act->max_units = size;
+    if (old.max_units > 0) {
+        memcpy(act->fighting_species_index, old.fighting_species_index, old.max_units * sizeof(int));
+        memcpy(act->num_shots, old.num_shots, old.max_units * sizeof(int));
+        memcpy(act->shots_left, old.shots_left, old.max_units * sizeof(int));
+        memcpy(act->weapon_damage, old.weapon_damage, old.max_units * sizeof(long));
+        memcpy(act->shield_strength, old.shield_strength, old.max_units * sizeof(long));
+        memcpy(act->shield_strength_left, old.shield_strength_left, old.max_units * sizeof(long));
+        memcpy(act->original_age_or_PDs, old.original_age_or_PDs, old.max_units * sizeof(long));
+        memcpy(act->bomb_damage, old.bomb_damage, old.max_units * sizeof(long));
+        memcpy(act->surprised, old.surprised, old.max_units * sizeof(char));
+        memcpy(act->unit_type, old.unit_type, old.max_units * sizeof(char));
+        memcpy(act->fighting_unit, old.fighting_unit, old.max_units * sizeof(char *));
+        memcpy(act->shield_regen, old.shield_regen, old.max_units * sizeof(int));
+        memcpy(act->age, old.age, old.max_units * sizeof(int));
+        memcpy(act->jumped, old.jumped, old.max_units * sizeof(char));
+        memcpy(act->non_combatant, old.non_combatant, old.max_units * sizeof(char));
+        memcpy(act->ship_class, old.ship_class, old.max_units * sizeof(char));
+        memcpy(act->ship_type, old.ship_type, old.max_units * sizeof(char));
+    }
+    actionFree(&old);
+}
 
 /* This routine will find all species that have declared alliance with both a traitor and betrayed species.
  * It will then set a flag to indicate that their allegiance should be changed from ALLY to ENEMY. */
@@ -87,7 +249,7 @@ void auto_enemy(int traitor_species_number, int betrayed_species_number) {
         if ((spec_data[species_index].contact[betrayed_array_index] & betrayed_bit_mask) == 0) {
             continue;
         }
-        make_enemy[species_index][traitor_species_number - 1] = betrayed_species_number;
+        battle_result->make_enemy[species_index][traitor_species_number - 1] = betrayed_species_number;
     }
 }
 
@@ -115,9 +277,146 @@ void battle_error(int species_number) {
     fprintf(log_file, "!!! Missing BATTLE command!\n");
 }
 
-// combat returns TRUE if planet, species, and transaction data should be saved
+// battleAdd returns a new, empty battle at the end of the list of battles.
+static struct battle_data *battleAdd(int num_battles) {
+    if (num_battles == max_battles) {
+        int size = max_battles == 0 ? 16 : 2 * max_battles;
+        struct battle_data *base = ncalloc(__FUNCTION__, __LINE__, size, sizeof(struct battle_data));
+        if (num_battles > 0) {
+            memcpy(base, battle_base, num_battles * sizeof(struct battle_data));
+        }
+        free(battle_base);
+        battle_base = base;
+        max_battles = size;
+    }
+    memset(&battle_base[num_battles], 0, sizeof(struct battle_data));
+    return &battle_base[num_battles];
+}
+
+// battleAddEnemy stores a species number at the given index of the list of species named in ATTACK
+// (or, negated, HIJACK) orders. The index restarts at zero with every BATTLE order, even one that is
+// ignored, so a later order may overwrite an earlier one, just as it did in the fixed-size list.
+static void battleAddEnemy(struct battle_species *bs, int index, int enemy) {
+    if (index >= bs->max_enemies) {
+        int size = bs->max_enemies == 0 ? 4 : 2 * bs->max_enemies;
+        int *list = ncalloc(__FUNCTION__, __LINE__, size, sizeof(int));
+        if (bs->num_enemies > 0) {
+            memcpy(list, bs->enemy, bs->num_enemies * sizeof(int));
+        }
+        free(bs->enemy);
+        bs->enemy = list;
+        bs->max_enemies = size;
+    }
+    bs->enemy[index] = enemy;
+    if (index >= bs->num_enemies) {
+        bs->num_enemies = index + 1;
+    }
+}
+
+// battleAddEngageOption adds an engagement option to the orders of a species.
+static void battleAddEngageOption(struct battle_species *bs, int option, int planet) {
+    if (bs->num_engage_options == bs->max_engage_options) {
+        int size = bs->max_engage_options == 0 ? 4 : 2 * bs->max_engage_options;
+        char *options = ncalloc(__FUNCTION__, __LINE__, size, sizeof(char));
+        char *planets = ncalloc(__FUNCTION__, __LINE__, size, sizeof(char));
+        if (bs->num_engage_options > 0) {
+            memcpy(options, bs->engage_option, bs->num_engage_options);
+            memcpy(planets, bs->engage_planet, bs->num_engage_options);
+        }
+        free(bs->engage_option);
+        free(bs->engage_planet);
+        bs->engage_option = options;
+        bs->engage_planet = planets;
+        bs->max_engage_options = size;
+    }
+    bs->engage_option[bs->num_engage_options] = option;
+    bs->engage_planet[bs->num_engage_options] = planet;
+    bs->num_engage_options++;
+}
+
+// battleAddSpecies adds a species to a battle with the default orders and returns its index in the battle.
+static int battleAddSpecies(struct battle_data *bat, int species_number, int default_summary) {
+    if (bat->num_species_here == bat->max_species) {
+        int size = bat->max_species == 0 ? 4 : 2 * bat->max_species;
+        struct battle_species *list = ncalloc(__FUNCTION__, __LINE__, size, sizeof(struct battle_species));
+        if (bat->num_species_here > 0) {
+            memcpy(list, bat->species, bat->num_species_here * sizeof(struct battle_species));
+        }
+        free(bat->species);
+        bat->species = list;
+        bat->max_species = size;
+    }
+    int sp_index = bat->num_species_here++;
+    struct battle_species *bs = &bat->species[sp_index];
+    memset(bs, 0, sizeof(struct battle_species));
+    bs->spec_num = species_number;
+    bs->special_target = 0;  /* Default. */
+    bs->transport_withdraw_age = 0;  /* Default. */
+    bs->warship_withdraw_age = 100;  /* Default. */
+    bs->fleet_withdraw_percentage = 100;  /* Default. */
+    bs->haven_x = 127;  /* 127 means not yet specified. */
+    battleAddEngageOption(bs, DEFENSE_IN_PLACE, 0);
+    bs->can_be_surprised = FALSE;
+    bs->hijacker = FALSE;
+    bs->summary_only = default_summary;
+    return sp_index;
+}
+
+// battleEnemy returns 1 if the first species attacks the second, 2 if it hijacks it, and 0 otherwise.
+static int battleEnemy(struct battle_data *bat, int species_index1, int species_index2) {
+    int bit = 2 * (species_index1 * bat->num_species_here + species_index2);
+    return (bat->enemy_mine[bit / 32] >> (bit % 32)) & 3;
+}
+
+// battleKey returns the key of the stream of random numbers for the battle, taken from its location.
+static uint64_t battleKey(struct battle_data *bat) {
+    return ((uint64_t) bat->x << 16) | (bat->y << 8) | bat->z;
+}
+
+// battleFree releases the battles and the orders of every species in them.
+static void battleFree(int num_battles) {
+    for (int battle_index = 0; battle_index < num_battles; battle_index++) {
+        struct battle_data *bat = &battle_base[battle_index];
+        for (int sp_index = 0; sp_index < bat->num_species_here; sp_index++) {
+            free(bat->species[sp_index].enemy);
+            free(bat->species[sp_index].engage_option);
+            free(bat->species[sp_index].engage_planet);
+        }
+        free(bat->species);
+        free(bat->enemy_mine);
+    }
+    free(battle_base);
+    battle_base = NULL;
+    max_battles = 0;
+}
+
+// battleSetEnemy records that the first species attacks (1) or hijacks (2) the second, or neither (0).
+static void battleSetEnemy(struct battle_data *bat, int species_index1, int species_index2, int value) {
+    int bit = 2 * (species_index1 * bat->num_species_here + species_index2);
+    bat->enemy_mine[bit / 32] &= ~(3u << (bit % 32));
+    bat->enemy_mine[bit / 32] |= (unsigned) (value & 3) << (bit % 32);
+}
+
+// battleTransaction returns a new, empty transaction for the battle that this thread is fighting.
+// It is added to the list of transactions when the results of the battle are merged.
+static struct trans_data *battleTransaction(void) {
+    if (battle_result->num_transactions == battle_result->max_transactions) {
+        int size = battle_result->max_transactions == 0 ? 16 : 2 * battle_result->max_transactions;
+        struct trans_data *transaction = ncalloc(__FUNCTION__, __LINE__, size, sizeof(struct trans_data));
+        if (battle_result->num_transactions > 0) {
+            memcpy(transaction, battle_result->transaction, battle_result->num_transactions * sizeof(struct trans_data));
+        }
+        free(battle_result->transaction);
+        battle_result->transaction = transaction;
+        battle_result->max_transactions = size;
+    }
+    return &battle_result->transaction[battle_result->num_transactions++];
+}
+
+// combat returns TRUE if planet, species, and transaction data should be saved.
+// Battles are fought on up to jobs threads.
 int combat(int default_summary, int do_all_species, int num_species, int *sp_num, char **sp_name,
-           sp_loc_data_t *locations_base) {
+           sp_loc_data_t *locations_base, int jobs) {
     int save = TRUE;
     int i;
     int j;
@@ -131,7 +430,6 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
     int species_fd;
     int num_enemies;
     int battle_index;
-    int option_index;
     int arg_index;
     int at_number;
     int at_index;
@@ -140,7 +438,6 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
     int pl_num[9];
     int enemy_word_number;
     int enemy_bit_number;
-    int log_open;
     int distorted_name;
     int best_score;
     int next_best_score;
@@ -157,12 +454,8 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
     char z;
     char option;
     char filename[32];
-    char keyword[4];
     char answer[16];
-    char log_line[256];
     char *temp_ptr;
-    FILE *temp_species_log;
-    FILE *species_log;
     struct species_data *sp;
     struct species_data *at_sp;
     struct nampla_data *namp;
@@ -171,6 +464,7 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
     struct ship_data *at_sh;
     struct battle_data *bat;
     struct sp_loc_data *location;
+    sector_t *sector;
 
     /* Main loop. For each species, take appropriate action. */
     num_battles = 0;
@@ -188,8 +482,7 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
 
         /* Open orders file for this species. */
         sprintf(filename, "sp%02d.ord", species_number);
-        input_file = fopen(filename, "r");
-        if (input_file == NULL) {
+        if (!ordersOpen(species_number)) {
             if (do_all_species) {
                 if (prompt_gm) {
                     printf("\nNo orders for species #%d, SP %s.\n", species_number, sp->name);
@@ -201,56 +494,8 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
             }
         }
 
-        end_of_file = FALSE;
-
-        just_opened_file = TRUE;    /* Tell command parser to skip mail header, if any. */
-        find_start:
-
-        /* Search for START COMBAT order. */
-        found = FALSE;
-        while (!found) {
-            command = get_command();
-            if (command == MESSAGE) {
-                /* Skip MESSAGE text. It may contain a line that starts with "start". */
-                while (TRUE) {
-                    command = get_command();
-                    if (command < 0) {
-                        fprintf(stderr, "WARNING: Unterminated MESSAGE command in file %s!\n", filename);
-                        break;
-                    }
-                    if (command == ZZZ) {
-                        goto find_start;
-                    }
-                }
-            }
-
-            if (command < 0) {
-                /* End of file. */
-                break;
-            }
-            if (command != START) {
-                continue;
-            }
-
-            /* Get the first three letters of the keyword and convert to upper case. */
-            skip_whitespace();
-
-            for (i = 0; i < 3; i++) {
-                keyword[i] = toupper(*input_line_pointer);
-                input_line_pointer++;
-            }
-            keyword[3] = '\0';
-
-            if (strike_phase) {
-                if (strcmp(keyword, "STR") == 0) {
-                    found = TRUE;
-                }
-            } else {
-                if (strcmp(keyword, "COM") == 0) {
-                    found = TRUE;
-                }
-            }
-        }
+        /* Search for START COMBAT or START STRIKES order. */
+        found = ordersFind(strike_phase ? "STR" : "COM");
 
         if (found) {
             if (prompt_gm) {
@@ -271,15 +516,8 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
             goto done_orders;
         }
 
-        /* Open temporary log file for appending. */
-        sprintf(filename, "sp%02d.temp.log", species_number);
-        log_file = fopen(filename, "a");
-        if (log_file == NULL) {
-            fprintf(stderr, "\n\tCannot open '%s' for appending!\n\n", filename);
-            exit(-1);
-        }
-
-        append_log[species_number - 1] = TRUE;
+        /* Open log file for this species. */
+        log_file = logSinkOpen(species_number);
 
         log_stdout = FALSE;
         if (strike_phase) {
@@ -323,27 +561,7 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
                 z = value;
 
                 /* Make sure that species is present at battle location. */
-                found = FALSE;
-                location = locations_base - 1;
-                for (i = 0; i < num_locs; i++) {
-                    location++;
-                    if (location->s != species_number) {
-                        continue;
-                    }
-                    if (location->x != x) {
-                        continue;
-                    }
-                    if (location->y != y) {
-                        continue;
-                    }
-                    if (location->z != z) {
-                        continue;
-                    }
-
-                    found = TRUE;
-                    break;
-                }
-                if (!found) {
+                if (locationFind(species_number, x, y, z) < 0) {
                     fprintf(log_file, "!!! Order ignored:\n");
                     fprintf(log_file, "!!! %s", input_line);
                     fprintf(log_file, "!!! Your species is not at this location!\n");
@@ -373,52 +591,16 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
 
                 if (!found) {
                     /* This is a new battle location. */
-                    if (num_battles == MAX_BATTLES) {
-                        fprintf(stderr, "\n\n\tMAX_BATTLES exceeded! Edit file 'combat.h' and re-compile!\n\n");
-                        exit(-1);
-                    }
                     battle_index = num_battles;
-                    sp_index = 0;
+                    bat = battleAdd(num_battles);
                     bat->x = x;
                     bat->y = y;
                     bat->z = z;
-                    bat->spec_num[0] = species_number;
-                    bat->special_target[0] = 0;  /* Default. */
-                    bat->transport_withdraw_age[0] = 0;  /* Default. */
-                    bat->warship_withdraw_age[0] = 100;  /* Default. */
-                    bat->fleet_withdraw_percentage[0] = 100;  /* Default. */
-                    bat->haven_x[0] = 127;
-                    /* 127 means not yet specified. */
-                    bat->engage_option[sp_index][0] = DEFENSE_IN_PLACE;
-                    bat->num_engage_options[0] = 1;
-                    bat->can_be_surprised[0] = FALSE;
-                    bat->hijacker[0] = FALSE;
-                    bat->summary_only[0] = default_summary;
-                    bat->num_species_here = 1;
-                    for (i = 0; i < MAX_SPECIES; i++) {
-                        bat->enemy_mine[0][i] = 0;
-                    }
                     num_battles++;
-                } else {
-                    /* Add another species to existing battle location. */
-                    sp_index = bat->num_species_here;
-                    bat->spec_num[sp_index] = species_number;
-                    bat->special_target[sp_index] = 0;  /* Default. */
-                    bat->transport_withdraw_age[sp_index] = 0;  /* Default. */
-                    bat->warship_withdraw_age[sp_index] = 100;  /* Default. */
-                    bat->fleet_withdraw_percentage[sp_index] = 100;  /* Default. */
-                    bat->haven_x[sp_index] = 127;
-                    /* 127 means not yet specified. */
-                    bat->engage_option[sp_index][0] = DEFENSE_IN_PLACE;
-                    bat->num_engage_options[sp_index] = 1;
-                    bat->can_be_surprised[sp_index] = FALSE;
-                    bat->hijacker[sp_index] = FALSE;
-                    bat->summary_only[sp_index] = default_summary;
-                    bat->num_species_here++;
-                    for (i = 0; i < MAX_SPECIES; i++) {
-                        bat->enemy_mine[sp_index][i] = 0;
-                    }
                 }
+
+                /* Add this species to the battle location. */
+                sp_index = battleAddSpecies(bat, species_number, default_summary);
                 continue;
             }
 
@@ -428,7 +610,7 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
                     continue;
                 }
 
-                bat->summary_only[sp_index] = TRUE;
+                bat->species[sp_index].summary_only = TRUE;
 
                 log_string("    Summary mode was specified.\n");
 
@@ -446,21 +628,21 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
                     continue;
                 }
                 i = value;
-                bat->transport_withdraw_age[sp_index] = i;
+                bat->species[sp_index].transport_withdraw_age = i;
 
                 if (get_value() == 0 || value < 0 || value > 100) {
                     bad_argument();
                     continue;
                 }
                 j = value;
-                bat->warship_withdraw_age[sp_index] = j;
+                bat->species[sp_index].warship_withdraw_age = j;
 
                 if (get_value() == 0 || value < 0 || value > 100) {
                     bad_argument();
                     continue;
                 }
                 k = value;
-                bat->fleet_withdraw_percentage[sp_index] = k;
+                bat->species[sp_index].fleet_withdraw_percentage = k;
 
                 log_string("    Withdrawal conditions were set to ");
                 log_int(i);
@@ -484,21 +666,21 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
                     continue;
                 }
                 i = value;
-                bat->haven_x[sp_index] = value;
+                bat->species[sp_index].haven_x = value;
 
                 if (get_value() == 0) {
                     bad_coordinates();
                     continue;
                 }
                 j = value;
-                bat->haven_y[sp_index] = value;
+                bat->species[sp_index].haven_y = value;
 
                 if (get_value() == 0) {
                     bad_coordinates();
                     continue;
                 }
                 k = value;
-                bat->haven_z[sp_index] = value;
+                bat->species[sp_index].haven_z = value;
 
                 log_string("    Haven location set to sector ");
                 log_int(i);
@@ -517,14 +699,6 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
                     continue;
                 }
 
-                option_index = bat->num_engage_options[sp_index];
-                if (option_index >= MAX_ENGAGE_OPTIONS) {
-                    fprintf(log_file, "!!! Order ignored:\n");
-                    fprintf(log_file, "!!! %s", input_line);
-                    fprintf(log_file, "!!! Too many ENGAGE orders!\n");
-                    continue;
-                }
-
                 if (get_value() == 0 || value < 0 || value > 7) {
                     fprintf(log_file, "!!! Order ignored:\n");
                     fprintf(log_file, "!!! %s", input_line);
@@ -540,8 +714,6 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
                     continue;
                 }
 
-                bat->engage_option[sp_index][option_index] = option;
-
                 /* Get planet to attack/defend, if any. */
                 if (option == PLANET_DEFENSE || (option >= PLANET_ATTACK && option <= SIEGE)) {
                     if (get_value() == 0) {
@@ -558,13 +730,11 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
                         continue;
                     }
 
-                    bat->engage_planet[sp_index][option_index] = value;
                 } else {
                     value = 0;
-                    bat->engage_planet[sp_index][option_index] = 0;
                 }
 
-                bat->num_engage_options[sp_index]++;
+                battleAddEngageOption(&bat->species[sp_index], option, value);
 
                 log_string("    Engagement order ");
                 log_int(option);
@@ -613,7 +783,7 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
                     fprintf(log_file, "!!! Invalid TARGET option!\n");
                     continue;
                 }
-                bat->special_target[sp_index] = value;
+                bat->species[sp_index].special_target = value;
 
                 log_string("    Strategic target ");
                 log_long(value);
@@ -629,7 +799,7 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
                 }
 
                 if (command == HIJACK) {
-                    bat->hijacker[sp_index] = TRUE;
+                    bat->species[sp_index].hijacker = TRUE;
                 }
 
                 /* Check if this is an order to attack all declared enemies. */
@@ -647,14 +817,10 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
                         enemy_mask = 1 << enemy_bit_number;
 
                         if (sp->enemy[enemy_word_number] & enemy_mask) {
-                            if (num_enemies == MAX_SPECIES) {
-                                fprintf(stderr, "\n\n\tToo many enemies to ATTACK or HIJACK!\n\n");
-                                exit(-1);
-                            }
                             if (command == HIJACK) {
-                                bat->enemy_mine[sp_index][num_enemies] = -(i + 1);
+                                battleAddEnemy(&bat->species[sp_index], num_enemies, -(i + 1));
                             } else {
-                                bat->enemy_mine[sp_index][num_enemies] = i + 1;
+                                battleAddEnemy(&bat->species[sp_index], num_enemies, i + 1);
                             }
                             num_enemies++;
                         }
@@ -667,11 +833,6 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
                     continue;
                 }
 
-                if (num_enemies == MAX_SPECIES) {
-                    fprintf(stderr, "\n\n\tToo many enemies to ATTACK or HIJACK!\n\n");
-                    exit(-1);
-                }
-
                 /* Set 'n' to the species number of the named enemy. */
                 temp_ptr = input_line_pointer;
                 if (get_class_abbr() != SPECIES_ID) {
@@ -722,33 +883,14 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
                 att1:
 
                 /* Make sure the named species is at the battle location. */
-                found = FALSE;
-                location = locations_base - 1;
-                for (i = 0; i < num_locs; i++) {
-                    location++;
-                    if (location->s != n) {
-                        continue;
-                    }
-                    if (location->x != bat->x) {
-                        continue;
-                    }
-                    if (location->y != bat->y) {
-                        continue;
-                    }
-                    if (location->z != bat->z) {
-                        continue;
-                    }
-
-                    found = TRUE;
-                    break;
-                }
+                found = locationFind(n, bat->x, bat->y, bat->z) >= 0;
 
-                /* Save species number temporarily in enemy_mine array. */
+                /* Save species number in the list of enemies. */
                 if (found) {
                     if (command == HIJACK) {
-                        bat->enemy_mine[sp_index][num_enemies] = -n;
+                        battleAddEnemy(&bat->species[sp_index], num_enemies, -n);
                     } else {
-                        bat->enemy_mine[sp_index][num_enemies] = n;
+                        battleAddEnemy(&bat->species[sp_index], num_enemies, n);
                     }
                     num_enemies++;
                 }
@@ -774,20 +916,19 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
             fprintf(log_file, "!!! Invalid combat command.\n");
         }
 
-        fclose(log_file);
+        log_file = NULL;
 
         done_orders:
 
-        fclose(input_file);
+        ordersClose();
     }
 
     /* Check each battle.  If a species specified a BATTLE command but did not specify any engage options, then add a DEFENSE_IN_PLACE option. */
     bat = battle_base;
     for (battle_index = 0; battle_index < num_battles; battle_index++) {
         for (i = 0; i < bat->num_species_here; i++) {
-            if (bat->num_engage_options[i] == 0) {
-                bat->num_engage_options[i] = 1;
-                bat->engage_option[i][0] = DEFENSE_IN_PLACE;
+            if (bat->species[i].num_engage_options == 0) {
+                battleAddEngageOption(&bat->species[i], DEFENSE_IN_PLACE, 0);
             }
         }
 
@@ -805,33 +946,23 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
     but has no combat orders, add it to the list of species at that
     battle, and apply defaults. After all species are accounted for
     at the current battle location, do battle. */
-    bat = battle_base - 1;
     for (battle_index = 0; battle_index < num_battles; battle_index++) {
-        bat++;
+        bat = battle_base + battle_index;
 
         x = bat->x;
         y = bat->y;
         z = bat->z;
+        sector = sectorAt(x, y, z);
 
         /* Check file 'locations.dat' for other species at this location. */
-        location = locations_base - 1;
-        for (location_index = 0; location_index < num_locs; location_index++) {
-            location++;
-            if (location->x != x) {
-                continue;
-            }
-            if (location->y != y) {
-                continue;
-            }
-            if (location->z != z) {
-                continue;
-            }
+        for (location_index = locationFirstAt(x, y, z); location_index >= 0; location_index = locationNextAt(location_index)) {
+            location = locations_base + location_index;
 
             /* Check if species is already accounted for. */
             found = FALSE;
             species_number = location->s;
             for (sp_index = 0; sp_index < bat->num_species_here; sp_index++) {
-                if (bat->spec_num[sp_index] == species_number) {
+                if (bat->species[sp_index].spec_num == species_number) {
                     found = TRUE;
                     break;
                 }
@@ -848,13 +979,13 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
             planet that is being explicitly attacked. */
             found = FALSE;
 
-            sp = &spec_data[species_number - 1];
-
             num_pls = 0;
 
-            namp = namp_data[species_number - 1] - 1;
-            for (i = 0; i < sp->num_namplas; i++) {
-                namp++;
+            for (i = 0; sector != NULL && i < sector->num_namplas; i++) {
+                if (sector->nampla[i].species_index != species_number - 1) {
+                    continue;
+                }
+                namp = namp_data[species_number - 1] + sector->nampla[i].index;
 
                 if (namp->pn == 99) {
                     continue;
@@ -878,16 +1009,16 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
                     really_hidden = TRUE;
 
                     for (at_index = 0; at_index < bat->num_species_here; at_index++) {
-                        for (j = 0; j < MAX_SPECIES; j++) {
-                            k = bat->enemy_mine[at_index][j];
+                        for (j = 0; j < bat->species[at_index].num_enemies; j++) {
+                            k = bat->species[at_index].enemy[j];
                             if (k < 0) {
                                 k = -k;
                             }
                             if (k == species_number) {
-                                for (k = 0; k < bat->num_engage_options[at_index]; k++) {
-                                    if (bat->engage_option[at_index][k] >= PLANET_ATTACK &&
-                                        bat->engage_option[at_index][k] <= SIEGE &&
-                                        bat->engage_planet[at_index][k] == namp->pn) {
+                                for (k = 0; k < bat->species[at_index].num_engage_options; k++) {
+                                    if (bat->species[at_index].engage_option[k] >= PLANET_ATTACK &&
+                                        bat->species[at_index].engage_option[k] <= SIEGE &&
+                                        bat->species[at_index].engage_planet[k] == namp->pn) {
                                         really_hidden = FALSE;
                                         break;
                                     }
@@ -911,9 +1042,11 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
                 pl_num[num_pls++] = namp->pn;
             }
 
-            sh = ship_data[species_number - 1] - 1;
-            for (i = 0; i < sp->num_ships; i++) {
-                sh++;
+            for (i = 0; sector != NULL && i < sector->num_ships; i++) {
+                if (sector->ship[i].species_index != species_number - 1) {
+                    continue;
+                }
+                sh = ship_data[species_number - 1] + sector->ship[i].index;
 
                 if (sh->pn == 99) {
                     continue;
@@ -948,68 +1081,43 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
                 continue;
             }
 
-            sp_index = bat->num_species_here;
-            bat->spec_num[sp_index] = location->s;
-            bat->special_target[sp_index] = 0;
-            bat->transport_withdraw_age[sp_index] = 0;
-            bat->warship_withdraw_age[sp_index] = 100;
-            bat->fleet_withdraw_percentage[sp_index] = 100;
-            bat->haven_x[sp_index] = 127;
-            bat->engage_option[sp_index][0] = DEFENSE_IN_PLACE;
-            bat->num_engage_options[sp_index] = 1;
-            if (num_pls > 0) {
-                /* Provide default Engage 2 options. */
-                for (i = 0; i < num_pls; i++) {
-                    bat->engage_option[sp_index][i + 1] = PLANET_DEFENSE;
-                    bat->engage_planet[sp_index][i + 1] = pl_num[i];
-                }
-                bat->num_engage_options[sp_index] = num_pls + 1;
+            sp_index = battleAddSpecies(bat, location->s, default_summary);
+            /* Provide default Engage 2 options. */
+            for (i = 0; i < num_pls; i++) {
+                battleAddEngageOption(&bat->species[sp_index], PLANET_DEFENSE, pl_num[i]);
             }
-            bat->can_be_surprised[sp_index] = TRUE;
-            bat->hijacker[sp_index] = FALSE;
-            bat->summary_only[sp_index] = default_summary;
-            for (i = 0; i < MAX_SPECIES; i++) {
-                bat->enemy_mine[sp_index][i] = 0;
-            }
-            bat->num_species_here++;
+            bat->species[sp_index].can_be_surprised = TRUE;
         }
+    }
 
-        /* If haven locations have not been specified, provide random locations nearby. */
-        for (sp_index = 0; sp_index < bat->num_species_here; sp_index++) {
-            if (bat->haven_x[sp_index] != 127) {
-                continue;
-            }
-
-            while (1) {
-                i = x + 2 - rnd(3);
-                j = y + 2 - rnd(3);
-                k = z + 2 - rnd(3);
-
-                if (i != x || j != y || k != z) {
-                    break;
-                }
+    /* When simulating, fight only the battle in the requested sector, on copies, and save nothing. */
+    if (simulate_runs > 0) {
+        for (i = 0; i < num_battles; i++) {
+            bat = &battle_base[i];
+            if (bat->x == simulate_x && bat->y == simulate_y && bat->z == simulate_z) {
+                break;
             }
-
-            bat->haven_x[sp_index] = i;
-            bat->haven_y[sp_index] = j;
-            bat->haven_z[sp_index] = k;
         }
+        if (i == num_battles) {
+            fprintf(stderr, "\n\tNo battle orders were given for sector %d %d %d!\n\n", simulate_x, simulate_y, simulate_z);
+            exit(2);
+        }
+        simulateBattle(bat, simulate_runs, jobs);
+        battleFree(num_battles);
+        logSinkDrop();
+        return FALSE;
+    }
 
-        /* Do battle at this battle location. */
-        do_battle(bat);
+    /* Do battle at each battle location. */
+    fightBattles(num_battles, jobs);
 
-        if (prompt_gm) {
-            printf("Hit RETURN to continue...");
+    battleFree(num_battles);
 
-            fflush(stdout);
-            fgets(answer, 16, stdin);
-        }
-    }
+    /* Ships were destroyed and forced to jump, so the sector index no longer holds. */
+    sectorReset();
 
     /* Declare new enmities. */
     for (i = 0; i < galaxy.num_species; i++) {
-        log_open = FALSE;
-
         for (j = 0; j < galaxy.num_species; j++) {
             if (i == j) {
                 continue;
@@ -1033,30 +1141,15 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
 
             data_modified[i] = TRUE;
 
-            if (!log_open) {
-                /* Open temporary species log file for appending. */
-                sprintf(filename, "sp%02d.temp.log", i + 1);
-                log_file = fopen(filename, "a");
-                if (log_file == NULL) {
-                    fprintf(stderr, "\n\tCannot open '%s' for appending!\n\n", filename);
-                    exit(-1);
-                }
-
-                append_log[i] = TRUE;
-                log_open = TRUE;
-            }
-
+            log_file = logSinkOpen(i + 1);
             log_string("\n!!! WARNING: Enmity has been automatically declared towards SP ");
             log_string(spec_data[j].name);
             log_string(" because they surprise-attacked SP ");
             log_string(spec_data[betrayed_species_number - 1].name);
             log_string("!\n");
         }
-
-        if (log_open) {
-            fclose(log_file);
-        }
     }
+    log_file = NULL;
 
     if (prompt_gm) {
         printf("\n*** Gamemaster safe-abort option ... type q or Q to quit: ");
@@ -1068,41 +1161,11 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
         }
     }
 
-    /* If results are to be saved, append temporary logs to actual species logs. In either case, delete temporary logs. */
-    for (i = 0; i < galaxy.num_species; i++) {
-        if (!append_log[i]) {
-            continue;
-        }
-
-        if (save) {
-            sprintf(filename, "sp%02d.log", i + 1);
-            species_log = fopen(filename, "a");
-            if (species_log == NULL) {
-                fprintf(stderr, "\n\tCannot open '%s' for appending!\n\n", filename);
-                exit(-1);
-            }
-        }
-
-        sprintf(filename, "sp%02d.temp.log", i + 1);
-
-        if (save) {
-            temp_species_log = fopen(filename, "r");
-            if (temp_species_log == NULL) {
-                fprintf(stderr, "\n\tCannot open '%s' for reading!\n\n", filename);
-                exit(-1);
-            }
-
-            /* Copy temporary log to permanent species log. */
-            while (readln(log_line, 256, temp_species_log) != NULL) {
-                fputs(log_line, species_log);
-            }
-
-            fclose(temp_species_log);
-            fclose(species_log);
-        }
-
-        /* Delete temporary log file. */
-        unlink(filename);
+    /* If results are to be saved, append the logs to the species log files. Otherwise, drop them. */
+    if (save) {
+        logSinkFlush();
+    } else {
+        logSinkDrop();
     }
 
     return save;
@@ -1112,6 +1175,7 @@ int combat(int default_summary, int do_all_species, int num_species, int *sp_num
 int combatCommand(int argc, char *argv[]) {
     int default_summary = FALSE;
     int do_all_species = TRUE;
+    int jobs = (int) sysconf(_SC_NPROCESSORS_ONLN);
     int num_species = 0;
     struct species_data *sp = NULL;
     char *sp_name[MAX_SPECIES];
@@ -1120,6 +1184,7 @@ int combatCommand(int argc, char *argv[]) {
     memset(sp_num, 0, sizeof(sp_num));
 
     prompt_gm = FALSE;
+    simulate_runs = 0;
     strike_phase = FALSE; // assume combat mode
 
     /* Get commonly used data. */
@@ -1128,20 +1193,16 @@ int combatCommand(int argc, char *argv[]) {
     get_transaction_data();
     get_location_data();
 
-    /* Allocate memory for battle data. */
-    battle_base = (struct battle_data *) ncalloc(__FUNCTION__, __LINE__, MAX_BATTLES, sizeof(struct battle_data));
-    if (battle_base == NULL) {
-        perror("combatCommand:");
-        fprintf(stderr, "\nCannot allocate enough memory for battle data!\n\n");
-        exit(2);
-    }
-
     /* Check arguments.
      * If an argument is -s, then set SUMMARY mode for everyone.
      * The default is for players to receive a detailed report of the battles.
      * If an argument is -p, then prompt the GM before saving results;
      * otherwise, operate quietly; i.e, do not prompt GM before saving results
      * and do not display anything except errors.
+     * If an argument is --jobs=N, then fight at most N battles at the same time.
+     * The default is one per processor.
+     * If the arguments are --simulate N x y z, then fight the battle in sector x y z
+     * N times on copies of the units there and print the outcomes; nothing is saved.
      * Any additional arguments must be species numbers.
      * If no species numbers are specified, then do all species. */
     for (int i = 1; i < argc; i++) {
@@ -1158,6 +1219,25 @@ int combatCommand(int argc, char *argv[]) {
             strike_phase = FALSE;
         } else if (strcmp(argv[i], "--strike") == 0) {
             strike_phase = TRUE;
+        } else if (strncmp(argv[i], "--jobs=", 7) == 0) {
+            jobs = atoi(argv[i] + 7);
+            if (jobs < 1) {
+                fprintf(stderr, "\n    '%s' is not a valid argument!\n", argv[i]);
+                exit(2);
+            }
+        } else if (strcmp(argv[i], "--simulate") == 0) {
+            if (i + 4 >= argc) {
+                fprintf(stderr, "\n    '%s' is not a valid argument!\n", argv[i]);
+                exit(2);
+            }
+            simulate_runs = atoi(argv[++i]);
+            simulate_x = atoi(argv[++i]);
+            simulate_y = atoi(argv[++i]);
+            simulate_z = atoi(argv[++i]);
+            if (simulate_runs < 1 || simulate_x < 0 || simulate_y < 0 || simulate_z < 0) {
+                fprintf(stderr, "\n    '%s %s %s %s %s' is not a valid argument!\n", argv[i - 4], argv[i - 3], argv[i - 2], argv[i - 1], argv[i]);
+                exit(2);
+            }
         } else {
             int n = atoi(argv[i]);
             if (0 < n && n <= galaxy.num_species) {
@@ -1169,6 +1249,11 @@ int combatCommand(int argc, char *argv[]) {
 
     printf(" info: combat: running %s mode\n", strike_phase ? "strike" : "combat");
 
+    /* A simulation saves nothing, so there is nothing for the GM to abort. */
+    if (simulate_runs > 0) {
+        prompt_gm = FALSE;
+    }
+
     log_stdout = prompt_gm;
 
     if (num_species == 0) {
@@ -1216,7 +1301,7 @@ int combatCommand(int argc, char *argv[]) {
         }
     }
 
-    int save = combat(default_summary, do_all_species, num_species, sp_num, sp_name, &loc[0]);
+    int save = combat(default_summary, do_all_species, num_species, sp_num, sp_name, &loc[0], jobs);
     if (save) {
         save_planet_data();
         save_species_data();
@@ -1303,7 +1388,7 @@ void do_ambush(int ambushing_species_index, struct battle_data *bat) {
     num_sp = bat->num_species_here;
     enemy_tonnage = 0;
     for (ambushed_species_index = 0; ambushed_species_index < num_sp; ++ambushed_species_index) {
-        if (!bat->enemy_mine[ambushing_species_index][ambushed_species_index]) {
+        if (!battleEnemy(bat, ambushing_species_index, ambushed_species_index)) {
             continue;
         }
 
@@ -1337,7 +1422,7 @@ void do_ambush(int ambushing_species_index, struct battle_data *bat) {
     if (enemy_tonnage == 0) {
         return;
     }
-    age_increment = (10L * bat->ambush_amount[ambushing_species_index]) / enemy_tonnage;
+    age_increment = (10L * bat->species[ambushing_species_index].ambush_amount) / enemy_tonnage;
     age_increment = (friendly_tonnage * age_increment) / enemy_tonnage;
     ambush_took_place = TRUE;
 
@@ -1350,11 +1435,11 @@ void do_ambush(int ambushing_species_index, struct battle_data *bat) {
 
     /* Age each ambushed ship. */
     for (ambushed_species_index = 0; ambushed_species_index < num_sp; ++ambushed_species_index) {
-        if (!bat->enemy_mine[ambushing_species_index][ambushed_species_index]) {
+        if (!battleEnemy(bat, ambushing_species_index, ambushed_species_index)) {
             continue;
         }
         log_string("\n    SP ");
-        species_number = bat->spec_num[ambushed_species_index];
+        species_number = bat->species[ambushed_species_index].spec_num;
         if (field_distorted[ambushed_species_index]) {
             log_int(distorted(species_number));
         } else {
@@ -1433,25 +1518,24 @@ void do_battle(struct battle_data *bat) {
             TRUE_value, do_withdraw_check_first;
     short identifiable_units[MAX_SPECIES], unidentifiable_units[MAX_SPECIES];
     long n, bit_mask;
-    char x, y, z, where, option, filename[32], enemy, enemy_num[MAX_SPECIES], log_line[256];
-    FILE *combat_log, *species_log;
+    int enemy;
+    char x, y, z, where, option;
     struct action_data act;
     struct nampla_data *namp, *attacked_nampla;
     struct ship_data *sh;
 
     ambush_took_place = FALSE;
+    memset(&act, 0, sizeof(struct action_data));
 
-    /* Open log file for writing. */
-    log_file = fopen("combat.log", "w");
+    /* Open the combat and summary logs. They are kept in memory until the results of the battle are merged. */
+    log_file = open_memstream(&battle_result->log, &battle_result->log_length);
     if (log_file == NULL) {
-        fprintf(stderr, "\n\tCannot open 'combat.log' for writing!\n\n");
+        fprintf(stderr, "\n\tCannot open combat log for writing!\n\n");
         exit(-1);
     }
-
-    /* Open summary file for writing. */
-    summary_file = fopen("summary.log", "w");
+    summary_file = open_memstream(&battle_result->summary, &battle_result->summary_length);
     if (summary_file == NULL) {
-        fprintf(stderr, "\n\tCannot open 'summary.log' for writing!\n\n");
+        fprintf(stderr, "\n\tCannot open summary log for writing!\n\n");
         exit(-1);
     }
     log_summary = TRUE;
@@ -1459,16 +1543,16 @@ void do_battle(struct battle_data *bat) {
     /* Get data for all species present at this battle. */
     num_sp = bat->num_species_here;
     for (species_index = 0; species_index < num_sp; ++species_index) {
-        species_number = bat->spec_num[species_index];
-        c_species[species_index] = &spec_data[species_number - 1];
-        c_nampla[species_index] = namp_data[species_number - 1];
-        c_ship[species_index] = ship_data[species_number - 1];
-        if (data_in_memory[species_number - 1]) {
-            data_modified[species_number - 1] = TRUE;
+        species_number = bat->species[species_index].spec_num;
+        if (bat->species[species_index].data != NULL) {
+            /* Fight on the copies that were made for a simulation. */
+            c_species[species_index] = bat->species[species_index].data;
+            c_nampla[species_index] = bat->species[species_index].nampla_base;
+            c_ship[species_index] = bat->species[species_index].ship_base;
         } else {
-            fprintf(stderr, "\n\tData for species #%d is needed but is not available!\n\n",
-                    species_number);
-            exit(-1);
+            c_species[species_index] = &spec_data[species_number - 1];
+            c_nampla[species_index] = namp_data[species_number - 1];
+            c_ship[species_index] = ship_data[species_number - 1];
         }
 
         /* Determine number of identifiable and unidentifiable units present. */
@@ -1530,7 +1614,7 @@ void do_battle(struct battle_data *bat) {
     log_int(bat->z);
     log_string(". The following species are present:\n\n");
 
-    /* Convert enemy_mine array from a list of species numbers to an array
+    /* Convert the lists of enemies from species numbers to an array
 	of TRUE/FALSE values whose indices are:
 
 			[species_index1][species_index2]
@@ -1539,17 +1623,10 @@ void do_battle(struct battle_data *bat) {
 	or HIJACK command.  The actual TRUE value will be 1 for ATTACK or
 	2 for HIJACK. */
 
+    bat->enemy_mine = ncalloc(__FUNCTION__, __LINE__, (2 * num_sp * num_sp + 31) / 32, sizeof(unsigned));
     for (species_index = 0; species_index < num_sp; ++species_index) {
-        /* Make copy of list of enemies. */
-        for (i = 0; i < MAX_SPECIES; i++) {
-            enemy_num[i] = bat->enemy_mine[species_index][i];
-            bat->enemy_mine[species_index][i] = FALSE;
-        }
-
-        for (i = 0; i < MAX_SPECIES; i++) {
-            enemy = enemy_num[i];
-            if (enemy == 0) { break; }    /* No more enemies in list. */
-
+        for (i = 0; i < bat->species[species_index].num_enemies; i++) {
+            enemy = bat->species[species_index].enemy[i];
             if (enemy < 0) {
                 enemy = -enemy;
                 TRUE_value = 2;        /* This is a hijacking. */
@@ -1560,8 +1637,8 @@ void do_battle(struct battle_data *bat) {
             /* Convert absolute species numbers to species indices that
             have been assigned in the current battle. */
             for (j = 0; j < num_sp; j++) {
-                if (enemy == bat->spec_num[j]) {
-                    bat->enemy_mine[species_index][j] = TRUE_value;
+                if (enemy == bat->species[j].spec_num) {
+                    battleSetEnemy(bat, species_index, j, TRUE_value);
                 }
             }
         }
@@ -1572,7 +1649,7 @@ void do_battle(struct battle_data *bat) {
 	not given a BATTLE order and if it is being attacked ONLY by one
 	or more ALLIES. */
     for (species_index = 0; species_index < num_sp; ++species_index) {
-        j = bat->spec_num[species_index] - 1;
+        j = bat->species[species_index].spec_num - 1;
         array_index = j / 32;
         bit_number = j % 32;
         bit_mask = 1 << bit_number;
@@ -1580,11 +1657,11 @@ void do_battle(struct battle_data *bat) {
         for (i = 0; i < num_sp; i++) {
             if (i == species_index) { continue; }
 
-            if (!bat->enemy_mine[species_index][i]) { continue; }
+            if (!battleEnemy(bat, species_index, i)) { continue; }
 
             if (field_distorted[species_index]) {
                 /* Attacker is field-distorted. Surprise not possible. */
-                bat->can_be_surprised[i] = FALSE;
+                bat->species[i].can_be_surprised = FALSE;
                 continue;
             }
 
@@ -1596,16 +1673,16 @@ void do_battle(struct battle_data *bat) {
 
             if (betrayal) {
                 /* Someone is being attacked by an ALLY. */
-                traitor_number = bat->spec_num[species_index];
-                betrayed_number = bat->spec_num[i];
-                make_enemy[betrayed_number - 1][traitor_number - 1] = betrayed_number;
+                traitor_number = bat->species[species_index].spec_num;
+                betrayed_number = bat->species[i].spec_num;
+                battle_result->make_enemy[betrayed_number - 1][traitor_number - 1] = betrayed_number;
                 auto_enemy(traitor_number, betrayed_number);
             }
 
-            if (!bat->can_be_surprised[i]) { continue; }
+            if (!bat->species[i].can_be_surprised) { continue; }
 
             if (!betrayal) {    /* At least one attacker is not an ally. */
-                bat->can_be_surprised[i] = FALSE;
+                bat->species[i].can_be_surprised = FALSE;
             }
         }
     }
@@ -1617,9 +1694,9 @@ void do_battle(struct battle_data *bat) {
         for (i = 0; i < num_sp; i++) {
             if (i == species_index) { continue; }
 
-            if (!bat->enemy_mine[species_index][i]) { continue; }
+            if (!battleEnemy(bat, species_index, i)) { continue; }
 
-            j = bat->spec_num[i] - 1;
+            j = bat->species[i].spec_num - 1;
             array_index = j / 32;
             bit_number = j % 32;
             bit_mask = 1 << bit_number;
@@ -1632,11 +1709,11 @@ void do_battle(struct battle_data *bat) {
                     /* Make sure it's not already set (it may already be set
                     for HIJACK and we don't want to accidentally change
                     it to ATTACK). */
-                    if (!bat->enemy_mine[species_index][k]) {
-                        bat->enemy_mine[species_index][k] = TRUE;
+                    if (!battleEnemy(bat, species_index, k)) {
+                        battleSetEnemy(bat, species_index, k, TRUE);
                     }
-                    if (!bat->enemy_mine[k][species_index]) {
-                        bat->enemy_mine[k][species_index] = TRUE;
+                    if (!battleEnemy(bat, k, species_index)) {
+                        battleSetEnemy(bat, k, species_index, TRUE);
                     }
                 }
             }
@@ -1646,16 +1723,16 @@ void do_battle(struct battle_data *bat) {
     /* If a species did not give a battle order and is not the target of an
 	attack, set can_be_surprised flag to a special value. */
     for (species_index = 0; species_index < num_sp; ++species_index) {
-        if (!bat->can_be_surprised[species_index]) { continue; }
+        if (!bat->species[species_index].can_be_surprised) { continue; }
 
-        bat->can_be_surprised[species_index] = 55;
+        bat->species[species_index].can_be_surprised = 55;
 
         for (i = 0; i < num_sp; i++) {
             if (i == species_index) { continue; }
 
-            if (!bat->enemy_mine[i][species_index]) { continue; }
+            if (!battleEnemy(bat, i, species_index)) { continue; }
 
-            bat->can_be_surprised[species_index] = TRUE;
+            bat->species[species_index].can_be_surprised = TRUE;
 
             break;
         }
@@ -1663,7 +1740,7 @@ void do_battle(struct battle_data *bat) {
 
     /* List combatants. */
     for (species_index = 0; species_index < num_sp; ++species_index) {
-        species_number = bat->spec_num[species_index];
+        species_number = bat->species[species_index].spec_num;
 
         log_string("    SP ");
         if (field_distorted[species_index]) {
@@ -1671,7 +1748,7 @@ void do_battle(struct battle_data *bat) {
         } else {
             log_string(c_species[species_index]->name);
         }
-        if (bat->can_be_surprised[species_index]) {
+        if (bat->species[species_index].can_be_surprised) {
             log_string(" does not appear to be ready for combat.\n");
         } else {
             log_string(" is mobilized and ready for combat.\n");
@@ -1682,7 +1759,7 @@ void do_battle(struct battle_data *bat) {
     for (i = 0; i < num_sp; i++) {
         namp = c_nampla[i] - 1;
         num_namplas = c_species[i]->num_namplas;
-        bat->ambush_amount[i] = 0;
+        bat->species[i].ambush_amount = 0;
         for (j = 0; j < num_namplas; j++) {
             ++namp;
 
@@ -1690,13 +1767,13 @@ void do_battle(struct battle_data *bat) {
             if (namp->y != bat->y) { continue; }
             if (namp->z != bat->z) { continue; }
 
-            bat->ambush_amount[i] += namp->use_on_ambush;
+            bat->species[i].ambush_amount += namp->use_on_ambush;
         }
 
-        if (bat->ambush_amount[i] == 0) { continue; }
+        if (bat->species[i].ambush_amount == 0) { continue; }
 
         for (j = 0; j < num_sp; j++) {
-            if (bat->enemy_mine[i][j]) {
+            if (battleEnemy(bat, i, j)) {
                 do_ambush(i, bat);
             }
         }
@@ -1705,11 +1782,11 @@ void do_battle(struct battle_data *bat) {
     /* For all species that specified enemies, make the feeling mutual. */
     for (i = 0; i < num_sp; i++) {
         for (j = 0; j < num_sp; j++) {
-            if (bat->enemy_mine[i][j]) {
+            if (battleEnemy(bat, i, j)) {
                 /* Make sure it's not already set (it may already be set for
                 HIJACK and we don't want to accidentally change it to
                 ATTACK). */
-                if (!bat->enemy_mine[j][i]) { bat->enemy_mine[j][i] = TRUE; }
+                if (!battleEnemy(bat, j, i)) { battleSetEnemy(bat, j, i, TRUE); }
             }
         }
     }
@@ -1719,8 +1796,8 @@ void do_battle(struct battle_data *bat) {
 	first option is DEEP_SPACE_FIGHT. */
     num_combat_options = 0;
     for (species_index = 0; species_index < num_sp; ++species_index) {
-        for (i = 0; i < bat->num_engage_options[species_index]; i++) {
-            option = bat->engage_option[species_index][i];
+        for (i = 0; i < bat->species[species_index].num_engage_options; i++) {
+            option = bat->species[species_index].engage_option[i];
             if (option == DEEP_SPACE_DEFENSE) {
                 consolidate_option(DEEP_SPACE_FIGHT, 0);
                 goto consolidate;
@@ -1730,9 +1807,9 @@ void do_battle(struct battle_data *bat) {
 
     consolidate:
     for (species_index = 0; species_index < num_sp; ++species_index) {
-        for (i = 0; i < bat->num_engage_options[species_index]; i++) {
-            option = bat->engage_option[species_index][i];
-            where = bat->engage_planet[species_index][i];
+        for (i = 0; i < bat->species[species_index].num_engage_options; i++) {
+            option = bat->species[species_index].engage_option[i];
+            where = bat->species[species_index].engage_planet[i];
             consolidate_option(option, where);
         }
     }
@@ -1760,11 +1837,11 @@ void do_battle(struct battle_data *bat) {
         if (!battle_here) {
             /* Combat is just starting. */
             for (species_index = 0; species_index < num_sp; ++species_index) {
-                species_number = bat->spec_num[species_index];
-                if (bat->can_be_surprised[species_index] == 55) {
+                species_number = bat->species[species_index].spec_num;
+                if (bat->species[species_index].can_be_surprised == 55) {
                     continue;
                 }
-                if (bat->can_be_surprised[species_index]) {
+                if (bat->species[species_index].can_be_surprised) {
                     log_string("\n    SP ");
                     if (field_distorted[species_index]) {
                         log_int(distorted(species_number));
@@ -1779,8 +1856,8 @@ void do_battle(struct battle_data *bat) {
         battle_here = TRUE;
 
         /* Clear out can_be_surprised array. */
-        for (i = 0; i < MAX_SPECIES; i++) {
-            bat->can_be_surprised[i] = FALSE;
+        for (i = 0; i < num_sp; i++) {
+            bat->species[i].can_be_surprised = FALSE;
         }
 
         /* Determine maximum number of rounds. */
@@ -1840,7 +1917,7 @@ void do_battle(struct battle_data *bat) {
                 /* Display species name. */
                 i = act.fighting_species_index[unit_index];
                 log_string("\n        SP ");
-                species_number = bat->spec_num[i];
+                species_number = bat->species[i].spec_num;
                 if (field_distorted[i]) {
                     log_int(distorted(species_number));
                 } else {
@@ -1902,6 +1979,7 @@ void do_battle(struct battle_data *bat) {
             }
 
             if (!do_round(option, round_number, bat, &act)) { break; }
+            battle_result->num_rounds++;
 
             if (!do_withdraw_check_first) { withdrawal_check(bat, &act); }
 
@@ -1927,7 +2005,7 @@ void do_battle(struct battle_data *bat) {
                     j = act.fighting_species_index[unit_index];
                     for (i = 0; i < num_sp; i++) {
                         if (x_attacked_y[i][j]) {
-                            species_number = bat->spec_num[i];
+                            species_number = bat->species[i].spec_num;
                             log_string("      SP ");
                             if (field_distorted[i]) {
                                 log_int(distorted(species_number));
@@ -1967,7 +2045,7 @@ void do_battle(struct battle_data *bat) {
         }
     }
 
-    /* Close combat log and append it to the log files of all species involved in this battle. */
+    /* Close combat log. It is appended to the log files of all species involved in this battle when the results are merged. */
     if (prompt_gm) {
         printf("\n  End of battle in sector %d, %d, %d.\n", bat->x, bat->y, bat->z);
     }
@@ -1977,36 +2055,7 @@ void do_battle(struct battle_data *bat) {
     fclose(summary_file);
 
     for (species_index = 0; species_index < num_sp; ++species_index) {
-        species_number = bat->spec_num[species_index];
-        /* Open combat log file for reading. */
-        if (bat->summary_only[species_index]) {
-            combat_log = fopen("summary.log", "r");
-        } else {
-            combat_log = fopen("combat.log", "r");
-        }
-
-        if (combat_log == NULL) {
-            fprintf(stderr, "\n\tCannot open combat log for reading!\n\n");
-            exit(-1);
-        }
-
-        /* Open a temporary species log file for appending. */
-        sprintf(filename, "sp%02d.temp.log", species_number);
-        species_log = fopen(filename, "a");
-        if (species_log == NULL) {
-            fprintf(stderr, "\n\tCannot open '%s' for appending!\n\n", filename);
-            exit(-1);
-        }
-
-        /* Copy combat log to temporary species log. */
-        while (readln(log_line, 256, combat_log) != NULL) {
-            fputs(log_line, species_log);
-        }
-
-        fclose(species_log);
-        fclose(combat_log);
-
-        append_log[species_number - 1] = TRUE;
+        species_number = bat->species[species_index].spec_num;
 
         /* Get rid of ships that were destroyed. */
         if (!data_modified[species_number - 1]) { continue; }
@@ -2024,6 +2073,8 @@ void do_battle(struct battle_data *bat) {
             delete_ship(sh);
         }
     }
+
+    actionFree(&act);
 }
 
 void do_bombardment(int unit_index, struct action_data *act) {
@@ -2220,7 +2271,7 @@ void do_germ_warfare(int attacking_species, int defending_species, int defender_
     log_string(" defenders of PL ");
     log_string(attacked_nampla->name);
     log_string(", the ");
-    i = bat->spec_num[attacking_species];
+    i = bat->species[attacking_species].spec_num;
     if (field_distorted[attacking_species]) {
         log_int(distorted(i));
     } else {
@@ -2252,21 +2303,15 @@ void do_germ_warfare(int attacking_species, int defending_species, int defender_
     }
 
     if (econ_units_from_looting > 0) {
-        /* Check if there's enough memory for a new interspecies transaction. */
-        if (num_transactions == MAX_TRANSACTIONS) {
-            fprintf(stderr, "\nRan out of memory! MAX_TRANSACTIONS is too small!\n\n");
-            exit(-1);
-        }
-        i = num_transactions++;
-
         /* Define this transaction. */
-        transaction[i].type = LOOTING_EU_TRANSFER;
-        transaction[i].donor = bat->spec_num[defending_species];
-        transaction[i].recipient = bat->spec_num[attacking_species];
-        transaction[i].value = econ_units_from_looting;
-        strcpy(transaction[i].name1, c_species[defending_species]->name);
-        strcpy(transaction[i].name2, c_species[attacking_species]->name);
-        strcpy(transaction[i].name3, attacked_nampla->name);
+        struct trans_data *t = battleTransaction();
+        t->type = LOOTING_EU_TRANSFER;
+        t->donor = bat->species[defending_species].spec_num;
+        t->recipient = bat->species[attacking_species].spec_num;
+        t->value = econ_units_from_looting;
+        strcpy(t->name1, c_species[defending_species]->name);
+        strcpy(t->name2, c_species[attacking_species]->name);
+        strcpy(t->name3, attacked_nampla->name);
     }
 
     /* Finish off defenders. */
@@ -2316,10 +2361,11 @@ void do_germ_warfare(int attacking_species, int defending_species, int defender_
 int do_round(char option, int round_number, struct battle_data *bat, struct action_data *act) {
     int i, j, n, unit_index, combat_occurred, total_shots,
             attacker_index, defender_index, found, chance_to_hit,
-            attacker_ml, attacker_gv, defender_ml, target_index[MAX_SHIPS],
+            attacker_ml, attacker_gv, defender_ml,
             num_targets, header_printed, num_sp, fj_chance, shields_up,
             FDs_were_destroyed, di[3], start_unit, current_species,
             this_is_a_hijacking;
+    int *target_index = act->target_index;
     long aux_shield_power, units_destroyed, tons, percent_decrease,
             damage_done, damage_to_ship, damage_to_shields, op1, op2,
             original_cost, recycle_value, economic_units;
@@ -2349,6 +2395,7 @@ int do_round(char option, int round_number, struct battle_data *bat, struct acti
                     if (act->unit_type[i] == SHIP) {
                         sh = (struct ship_data *) act->fighting_unit[i];
                         sh->special = 0;
+                        act->non_combatant[i] = FALSE;
                     }
                 }
             }
@@ -2360,31 +2407,14 @@ int do_round(char option, int round_number, struct battle_data *bat, struct acti
         if (act->surprised[unit_index]) {
             n = 0;
         }
-        if (act->unit_type[unit_index] == SHIP) {
-            sh = (struct ship_data *) act->fighting_unit[unit_index];
-            if (sh->special == NON_COMBATANT) {
-                n = 0;
-            }
+        if (act->unit_type[unit_index] == SHIP && act->non_combatant[unit_index]) {
+            n = 0;
         }
         total_shots += n;
     }
 
     /* Determine total number of shots for all species present. */
-    total_shots = 0;
-    for (unit_index = 0; unit_index < act->num_units_fighting; unit_index++) {
-        n = act->num_shots[unit_index];
-        if (act->surprised[unit_index]) {
-            n = 0;
-        }
-        if (act->unit_type[unit_index] == SHIP) {
-            sh = (struct ship_data *) act->fighting_unit[unit_index];
-            if (sh->special == NON_COMBATANT) {
-                n = 0;
-            }
-        }
-        act->shots_left[unit_index] = n;
-        total_shots += n;
-    }
+    total_shots = resetShots(act);
 
     /* Handle all shots. */
     header_printed = FALSE;
@@ -2394,15 +2424,7 @@ int do_round(char option, int round_number, struct battle_data *bat, struct acti
         /* check to make sure we arent in infinite loop
          * that usually happens when there are shots remaining
          * but the side with the shots has no more ships left*/
-        for (i = 0; i < act->num_units_fighting; ++i) {
-            attacking_ship = (struct ship_data *) act->fighting_unit[i];
-            if (attacking_ship->age > 49 || attacking_ship->status == FORCED_JUMP ||
-                attacking_ship->status == JUMPED_IN_COMBAT ||
-                (attacking_ship->special == NON_COMBATANT && option != GERM_WARFARE)) {
-                total_shots -= act->shots_left[i];
-                act->shots_left[i] = 0;
-            }
-        }
+        total_shots -= dropIdleShots(act, option != GERM_WARFARE);
         //// second test to prevent infinite loop due to the shot counter not being decremented.
         //if (total_shots > infiniteShotsGuard) {
         //    total_shots = infiniteShotsGuard;
@@ -2412,31 +2434,27 @@ int do_round(char option, int round_number, struct battle_data *bat, struct acti
         /* Determine who fires next. */
         attacker_index = rnd(act->num_units_fighting) - 1;
         if (act->unit_type[attacker_index] == SHIP) {
-            attacking_ship = (struct ship_data *) act->fighting_unit[attacker_index];
-            i = act->fighting_species_index[attacker_index];
-            ignore_field_distorters = !field_distorted[i];
-            sprintf(attacker_name, "%s", ship_name(attacking_ship));
-            ignore_field_distorters = FALSE;
-
             /* Check if ship can fight. */
-            if (attacking_ship->age > 49) {
-                continue;
-            }
-            if (attacking_ship->status == FORCED_JUMP) {
+            if (act->age[attacker_index] > 49) {
                 continue;
             }
-            if (attacking_ship->status == JUMPED_IN_COMBAT) {
+            if (act->jumped[attacker_index]) {
                 continue;
             }
-            if (attacking_ship->special == NON_COMBATANT &&
-                option != GERM_WARFARE) {
+            if (act->non_combatant[attacker_index] && option != GERM_WARFARE) {
                 continue;
             }
+
+            attacking_ship = (struct ship_data *) act->fighting_unit[attacker_index];
+            i = act->fighting_species_index[attacker_index];
+            ignore_field_distorters = !field_distorted[i];
+            sprintf(attacker_name, "%s", ship_name(attacking_ship));
+            ignore_field_distorters = FALSE;
         } else {
             attacking_nampla = (struct nampla_data *) act->fighting_unit[attacker_index];
-            sprintf(attacker_name, "PL %s", attacking_nampla->name);
             /* Check if planet still has defenses. */
             if (attacking_nampla->item_quantity[PD] == 0) { continue; }
+            sprintf(attacker_name, "PL %s", attacking_nampla->name);
         }
 
         /* Make sure attacker is not someone who is being taken by surprise this round. */
@@ -2451,23 +2469,19 @@ int do_round(char option, int round_number, struct battle_data *bat, struct acti
         attacker_gv = c_species[i]->tech_level[GV];
         for (defender_index = 0; defender_index < act->num_units_fighting; defender_index++) {
             j = act->fighting_species_index[defender_index];
-            if (!bat->enemy_mine[i][j]) {
+            if (!battleEnemy(bat, i, j)) {
                 continue;
             }
 
             if (act->unit_type[defender_index] == SHIP) {
-                defending_ship = (struct ship_data *) act->fighting_unit[defender_index];
-                if (defending_ship->age > 49) {
+                if (act->age[defender_index] > 49) {
                     /* Already destroyed. */
                     continue;
                 }
-                if (defending_ship->status == FORCED_JUMP) {
+                if (act->jumped[defender_index]) {
                     continue;
                 }
-                if (defending_ship->status == JUMPED_IN_COMBAT) {
-                    continue;
-                }
-                if (defending_ship->special == NON_COMBATANT) {
+                if (act->non_combatant[defender_index]) {
                     continue;
                 }
             } else {
@@ -2547,13 +2561,13 @@ int do_round(char option, int round_number, struct battle_data *bat, struct acti
         i = act->fighting_species_index[attacker_index];
         j = act->fighting_species_index[defender_index];
         if (act->unit_type[defender_index] == SHIP && defending_ship->class == TR &&
-            bat->special_target[i] != TARGET_TRANSPORTS && rnd(10) != 5) {
+            bat->species[i].special_target != TARGET_TRANSPORTS && rnd(10) != 5) {
             continue;
         }
 
         /* If a special target has been specified, then there is a 75% chance that it will be attacked if it is available. */
-        if (bat->special_target[i] && rnd(100) < 76) {
-            if (bat->special_target[i] == TARGET_PDS) {
+        if (bat->species[i].special_target && rnd(100) < 76) {
+            if (bat->species[i].special_target == TARGET_PDS) {
                 if (act->unit_type[defender_index] != SHIP) {
                     goto fire;
                 } else {
@@ -2565,13 +2579,13 @@ int do_round(char option, int round_number, struct battle_data *bat, struct acti
                 continue;
             }
 
-            if (bat->special_target[i] == TARGET_STARBASES && defending_ship->class != BA) {
+            if (bat->species[i].special_target == TARGET_STARBASES && defending_ship->class != BA) {
                 continue;
             }
-            if (bat->special_target[i] == TARGET_TRANSPORTS && defending_ship->class != TR) {
+            if (bat->species[i].special_target == TARGET_TRANSPORTS && defending_ship->class != TR) {
                 continue;
             }
-            if (bat->special_target[i] == TARGET_WARSHIPS) {
+            if (bat->species[i].special_target == TARGET_WARSHIPS) {
                 if (defending_ship->class == TR) {
                     continue;
                 }
@@ -2731,6 +2745,7 @@ int do_round(char option, int round_number, struct battle_data *bat, struct acti
 
             if (act->unit_type[defender_index] == SHIP) {
                 defending_ship->age += percent_decrease / 2;
+                act->age[defender_index] = defending_ship->age;
                 units_destroyed = (defending_ship->age > 49);
             } else {
                 units_destroyed = (percent_decrease * act->original_age_or_PDs[defender_index]) / 100L;
@@ -2749,7 +2764,7 @@ int do_round(char option, int round_number, struct battle_data *bat, struct acti
         /* See if this is a hijacking. */
         i = act->fighting_species_index[attacker_index];
         j = act->fighting_species_index[defender_index];
-        if (bat->enemy_mine[i][j] == 2 && (option == DEEP_SPACE_FIGHT || option == PLANET_ATTACK)) {
+        if (battleEnemy(bat, i, j) == 2 && (option == DEEP_SPACE_FIGHT || option == PLANET_ATTACK)) {
             this_is_a_hijacking = TRUE;
         } else {
             this_is_a_hijacking = FALSE;
@@ -2805,7 +2820,8 @@ int do_round(char option, int round_number, struct battle_data *bat, struct acti
                         }
                     }
 
-                    attacking_species->econ_units += economic_units;
+                    /* Other battles may be paying the same species, so the total is added up when the results are merged. */
+                    battle_result->econ_units[attacking_species->index] += economic_units;
 
                     log_long(economic_units);
                     log_string(" economic units for the hijackers.\n");
@@ -2921,31 +2937,26 @@ void do_siege(struct battle_data *bat, struct action_data *act) {
             defending_nampla->siege_eff = TRUE;
             d = act->fighting_species_index[defender_index];
             defending_species = c_species[d];
-            defending_species_number = bat->spec_num[d];
+            defending_species_number = bat->species[d].spec_num;
             for (attacker_index = 0; attacker_index < act->num_units_fighting; attacker_index++) {
                 if (act->unit_type[attacker_index] == SHIP) {
                     attacking_ship = (struct ship_data *) act->fighting_unit[attacker_index];
                     a = act->fighting_species_index[attacker_index];
                     if (x_attacked_y[a][d]) {
                         attacking_species = c_species[a];
-                        attacking_species_number = bat->spec_num[a];
-                        /* Check if there's enough memory for a new interspecies transaction. */
-                        if (num_transactions == MAX_TRANSACTIONS) {
-                            fprintf(stderr, "\nRan out of memory! MAX_TRANSACTIONS is too small!\n\n");
-                            exit(-1);
-                        }
-                        i = num_transactions++;
+                        attacking_species_number = bat->species[a].spec_num;
                         /* Define this transaction. */
-                        transaction[i].type = BESIEGE_PLANET;
-                        transaction[i].x = defending_nampla->x;
-                        transaction[i].y = defending_nampla->y;
-                        transaction[i].z = defending_nampla->z;
-                        transaction[i].pn = defending_nampla->pn;
-                        transaction[i].number1 = attacking_species_number;
-                        strcpy(transaction[i].name1, attacking_species->name);
-                        transaction[i].number2 = defending_species_number;
-                        strcpy(transaction[i].name2, defending_species->name);
-                        strcpy(transaction[i].name3, attacking_ship->name);
+                        struct trans_data *t = battleTransaction();
+                        t->type = BESIEGE_PLANET;
+                        t->x = defending_nampla->x;
+                        t->y = defending_nampla->y;
+                        t->z = defending_nampla->z;
+                        t->pn = defending_nampla->pn;
+                        t->number1 = attacking_species_number;
+                        strcpy(t->name1, attacking_species->name);
+                        t->number2 = defending_species_number;
+                        strcpy(t->name2, defending_species->name);
+                        strcpy(t->name3, attacking_ship->name);
                     }
                 }
             }
@@ -2954,6 +2965,26 @@ void do_siege(struct battle_data *bat, struct action_data *act) {
     log_string("      Only those ships that actually remain in the system will take part in the siege.\n");
 }
 
+// dropIdleShots takes away the shots of units that were destroyed, have left the battle, or
+// (when drop_non_combatants is set) are staying out of it. It returns the number of shots taken.
+// It runs before every shot, so it reads only the copies in the action and not the units.
+static int dropIdleShots(struct action_data *act, int drop_non_combatants) {
+    int num_units = act->num_units_fighting;
+    const int *age = act->age;
+    const char *jumped = act->jumped;
+    const char *non_combatant = act->non_combatant;
+    int *shots_left = act->shots_left;
+    int dropped = 0;
+
+    for (int unit_index = 0; unit_index < num_units; unit_index++) {
+        int idle = (age[unit_index] > 49) | (jumped[unit_index] != 0) | ((non_combatant[unit_index] != 0) & (drop_non_combatants != 0));
+        dropped += idle ? shots_left[unit_index] : 0;
+        shots_left[unit_index] = idle ? 0 : shots_left[unit_index];
+    }
+
+    return dropped;
+}
+
 /* The following routine will fill "act" with ship and nampla data necessary
    for an action; i.e., number of shots per round, damage done per shot,
    total shield power, etc. Note that this routine always restores shields
@@ -2962,6 +2993,145 @@ void do_siege(struct battle_data *bat, struct action_data *act) {
 
    The routine will return TRUE if the action can take place, otherwise FALSE.
 */
+// fightBattle fights a single battle.
+// The logs and everything else that the battle changes outside of its own sector are collected in result.
+static void fightBattle(struct battle_data *bat, battle_result_t *result, const char *stream, uint64_t key) {
+    int i, j, k, sp_index;
+    char x = bat->x, y = bat->y, z = bat->z;
+    FILE *saved_log_file = log_file;
+    FILE *saved_summary_file = summary_file;
+    int saved_log_summary = log_summary;
+
+    battle_result = result;
+
+    /* Each battle draws from its own stream of random numbers. */
+    prngUseStream(stream, galaxy.turn_number, key);
+
+    /* If haven locations have not been specified, provide random locations nearby. */
+    for (sp_index = 0; sp_index < bat->num_species_here; sp_index++) {
+        if (bat->species[sp_index].haven_x != 127) {
+            continue;
+        }
+
+        while (1) {
+            i = x + 2 - rnd(3);
+            j = y + 2 - rnd(3);
+            k = z + 2 - rnd(3);
+
+            if (i != x || j != y || k != z) {
+                break;
+            }
+        }
+
+        bat->species[sp_index].haven_x = i;
+        bat->species[sp_index].haven_y = j;
+        bat->species[sp_index].haven_z = k;
+    }
+
+    do_battle(bat);
+    prngUseGlobal();
+
+    /* do_battle closed its own logs; go back to the ones that were in use before. */
+    battle_result = NULL;
+    log_file = saved_log_file;
+    summary_file = saved_summary_file;
+    log_summary = saved_log_summary;
+}
+
+
+// fightBattles fights all the battles and merges their results in battle order.
+// Battles are in different sectors and draw from their own streams of random numbers,
+// so up to jobs of them are fought at the same time. They are fought one at a time
+// when the GM is watching (-p) or when FH_PRNG=historical.
+static void fightBattles(int num_battles, int jobs) {
+    int battle_index, i, num_workers, species_number;
+    char answer[16];
+    battle_pool_t pool;
+    pthread_t *worker;
+    struct battle_data *bat;
+
+    if (num_battles == 0) {
+        return;
+    }
+
+    /* The battles will change the data of every species present. */
+    for (battle_index = 0; battle_index < num_battles; battle_index++) {
+        bat = battle_base + battle_index;
+        for (i = 0; i < bat->num_species_here; i++) {
+            species_number = bat->species[i].spec_num;
+            if (!data_in_memory[species_number - 1]) {
+                fprintf(stderr, "\n\tData for species #%d is needed but is not available!\n\n", species_number);
+                exit(-1);
+            }
+            data_modified[species_number - 1] = TRUE;
+        }
+    }
+
+    pool.num_battles = num_battles;
+    pool.next_battle = 0;
+    pool.result = ncalloc(__FUNCTION__, __LINE__, num_battles, sizeof(battle_result_t));
+
+    if (prompt_gm || prngHistorical() || jobs < 2 || num_battles < 2) {
+        for (battle_index = 0; battle_index < num_battles; battle_index++) {
+            bat = battle_base + battle_index;
+            fightBattle(bat, &pool.result[battle_index], strike_phase ? "strike" : "combat", battleKey(bat));
+            mergeBattle(bat, &pool.result[battle_index], battle_index == num_battles - 1);
+
+            if (prompt_gm) {
+                printf("Hit RETURN to continue...");
+
+                fflush(stdout);
+                fgets(answer, 16, stdin);
+            }
+        }
+    } else {
+        num_workers = jobs < num_battles ? jobs : num_battles;
+        worker = ncalloc(__FUNCTION__, __LINE__, num_workers, sizeof(pthread_t));
+        pthread_mutex_init(&pool.lock, NULL);
+        for (i = 0; i < num_workers; i++) {
+            if (pthread_create(&worker[i], NULL, fightBattlesWorker, &pool) != 0) {
+                fprintf(stderr, "\n\tCannot start a thread to fight battles!\n\n");
+                exit(-1);
+            }
+        }
+        for (i = 0; i < num_workers; i++) {
+            pthread_join(worker[i], NULL);
+        }
+        pthread_mutex_destroy(&pool.lock);
+        free(worker);
+
+        for (battle_index = 0; battle_index < num_battles; battle_index++) {
+            mergeBattle(battle_base + battle_index, &pool.result[battle_index], battle_index == num_battles - 1);
+        }
+    }
+
+    free(pool.result);
+}
+
+
+// fightBattlesWorker takes battles from the pool and fights them until there are none left.
+static void *fightBattlesWorker(void *arg) {
+    battle_pool_t *pool = (battle_pool_t *) arg;
+    int battle_index;
+
+    /* Only the main thread writes to the terminal. */
+    log_stdout = FALSE;
+
+    while (TRUE) {
+        pthread_mutex_lock(&pool->lock);
+        battle_index = pool->next_battle++;
+        pthread_mutex_unlock(&pool->lock);
+        if (battle_index >= pool->num_battles) {
+            break;
+        }
+        fightBattle(battle_base + battle_index, &pool->result[battle_index], strike_phase ? "strike" : "combat",
+                    battleKey(battle_base + battle_index));
+    }
+
+    return NULL;
+}
+
+
 int fighting_params(char option, char location, struct battle_data *bat, struct action_data *act) {
     char x, y, z, pn;
     int i, j, found, type, num_sp, unit_index;
@@ -3014,9 +3184,9 @@ int fighting_params(char option, char location, struct battle_data *bat, struct
                 if (sh->special == NON_COMBATANT) { continue; }
             }
 
-            for (i = 0; i < bat->num_engage_options[species_index]; i++) {
-                engage_option = bat->engage_option[species_index][i];
-                engage_location = bat->engage_planet[species_index][i];
+            for (i = 0; i < bat->species[species_index].num_engage_options; i++) {
+                engage_option = bat->species[species_index].engage_option[i];
+                engage_location = bat->species[species_index].engage_planet[i];
 
                 switch (engage_option) {
                     case DEFENSE_IN_PLACE:
@@ -3110,6 +3280,9 @@ int fighting_params(char option, char location, struct battle_data *bat, struct
             add_ship:
             if (use_this_ship) {
                 /* Add data for this ship to action array. */
+                if (num_fighting_units == act->max_units) {
+                    actionGrow(act);
+                }
                 act->fighting_species_index[num_fighting_units] = species_index;
                 act->unit_type[num_fighting_units] = SHIP;
                 act->fighting_unit[num_fighting_units] = (char *) sh;
@@ -3136,9 +3309,9 @@ int fighting_params(char option, char location, struct battle_data *bat, struct
             more species to have colonies on the SAME planet, and for
             one to attack the other. */
 
-            for (i = 0; i < bat->num_engage_options[species_index]; i++) {
-                engage_option = bat->engage_option[species_index][i];
-                engage_location = bat->engage_planet[species_index][i];
+            for (i = 0; i < bat->species[species_index].num_engage_options; i++) {
+                engage_option = bat->species[species_index].engage_option[i];
+                engage_location = bat->species[species_index].engage_planet[i];
                 if (engage_location != location) { continue; }
 
                 switch (engage_option) {
@@ -3170,6 +3343,9 @@ int fighting_params(char option, char location, struct battle_data *bat, struct
             if (nam->item_quantity[PD] > 0) { defending_pds_here = TRUE; }
 
             /* Add data for this nampla to action array. */
+            if (num_fighting_units == act->max_units) {
+                actionGrow(act);
+            }
             act->fighting_species_index[num_fighting_units] = species_index;
             act->unit_type[num_fighting_units] = NAMPLA;
             act->fighting_unit[num_fighting_units] = (char *) nam;
@@ -3206,7 +3382,7 @@ int fighting_params(char option, char location, struct battle_data *bat, struct
         sp1 = act->fighting_species_index[i];
         for (j = 0; j < num_fighting_units; j++) {
             sp2 = act->fighting_species_index[j];
-            if (bat->enemy_mine[sp1][sp2]) { goto next_step; }
+            if (battleEnemy(bat, sp1, sp2)) { goto next_step; }
         }
     }
 
@@ -3231,6 +3407,18 @@ int fighting_params(char option, char location, struct battle_data *bat, struct
 
         species_index = act->fighting_species_index[unit_index];
 
+        /* Copy the fields that the rounds read on every shot. A planet is
+        read through a ship pointer by the check at the top of the shot
+        loop in do_round, so its copies hold what that check has always
+        seen; the other readers look at them only for ships. */
+        sh = (struct ship_data *) act->fighting_unit[unit_index];
+        act->age[unit_index] = sh->age;
+        act->jumped[unit_index] = sh->status == FORCED_JUMP || sh->status == JUMPED_IN_COMBAT;
+        act->non_combatant[unit_index] = sh->special == NON_COMBATANT;
+        act->ship_class[unit_index] = type == SHIP ? sh->class : 0;
+        act->ship_type[unit_index] = type == SHIP ? sh->type : 0;
+        act->shield_regen[unit_index] = (c_species[species_index]->tech_level[LS] / 10) + 5;
+
         unit_power = power(tons);
         offensive_power = unit_power;
         defensive_power = unit_power;
@@ -3274,7 +3462,7 @@ int fighting_params(char option, char location, struct battle_data *bat, struct
         defensive_power += (ls * defensive_power) / 50;
 
         /* Adjust values if this species is hijacking anyone. */
-        if (bat->hijacker[species_index] && (option == DEEP_SPACE_FIGHT
+        if (bat->species[species_index].hijacker && (option == DEEP_SPACE_FIGHT
                                              || option == PLANET_ATTACK)) {
             offensive_power /= 4;
             defensive_power /= 4;
@@ -3309,7 +3497,7 @@ int fighting_params(char option, char location, struct battle_data *bat, struct
         act->bomb_damage[unit_index] = 0;
 
         /* Set flag for individual unit if species can be surprised. */
-        if (bat->can_be_surprised[species_index]) {
+        if (bat->species[species_index].can_be_surprised) {
             act->surprised[unit_index] = TRUE;
         } else {
             act->surprised[unit_index] = FALSE;
@@ -3440,6 +3628,7 @@ int forced_jump_units_used(int attacker_index, int defender_index, int *total_sh
 
     /* Make sure this ship can no longer take part in the battle. */
     defending_ship->status = FORCED_JUMP;
+    act->jumped[defender_index] = TRUE;
     defending_ship->pn = -1;
     *total_shots -= act->shots_left[defender_index];
     act->shots_left[defender_index] = 0;
@@ -3448,21 +3637,289 @@ int forced_jump_units_used(int attacker_index, int defender_index, int *total_sh
     return TRUE;
 }
 
+// mergeBattle appends the logs of a battle to the logs of the species that were there
+// and applies what the battle changed outside of its sector. Battles are merged in order.
+// The combat and summary logs of the last battle are left on disk, as they always have been.
+static void mergeBattle(struct battle_data *bat, battle_result_t *result, int last_battle) {
+    int i, j, species_index, species_number;
+    FILE *fp;
+
+    if (last_battle) {
+        fp = fopen("combat.log", "w");
+        if (fp == NULL) {
+            fprintf(stderr, "\n\tCannot open 'combat.log' for writing!\n\n");
+            exit(-1);
+        }
+        fwrite(result->log, 1, result->log_length, fp);
+        fclose(fp);
+
+        fp = fopen("summary.log", "w");
+        if (fp == NULL) {
+            fprintf(stderr, "\n\tCannot open 'summary.log' for writing!\n\n");
+            exit(-1);
+        }
+        fwrite(result->summary, 1, result->summary_length, fp);
+        fclose(fp);
+    }
+
+    /* Append the full or summary transcript of the battle to the logs of all species involved. */
+    for (species_index = 0; species_index < bat->num_species_here; ++species_index) {
+        species_number = bat->species[species_index].spec_num;
+        if (bat->species[species_index].summary_only) {
+            fwrite(result->summary, 1, result->summary_length, logSinkOpen(species_number));
+        } else {
+            fwrite(result->log, 1, result->log_length, logSinkOpen(species_number));
+        }
+    }
+
+    for (i = 0; i < galaxy.num_species; i++) {
+        spec_data[i].econ_units += result->econ_units[i];
+        for (j = 0; j < galaxy.num_species; j++) {
+            if (result->make_enemy[i][j] != 0) {
+                make_enemy[i][j] = result->make_enemy[i][j];
+            }
+        }
+    }
+
+    for (i = 0; i < result->num_transactions; i++) {
+        int n = transactionAdd();
+        transaction[n] = result->transaction[i];
+    }
+
+    free(result->log);
+    free(result->summary);
+    free(result->transaction);
+}
+
+
 void regenerate_shields(struct action_data *act) {
-    int i, species_index, unit_index;
-    long ls, max_shield_strength, percent;
-    struct ship_data *sh;
+    int num_units = act->num_units_fighting;
+    const int *regen = act->shield_regen;
+    const long *max_shield_strength = act->shield_strength;
+    long *shield_strength_left = act->shield_strength_left;
+
     /* Shields are regenerated by 5 + LS/10 percent per round. */
-    for (unit_index = 0; unit_index < act->num_units_fighting; unit_index++) {
-        species_index = act->fighting_species_index[unit_index];
-        ls = c_species[species_index]->tech_level[LS];
-        max_shield_strength = act->shield_strength[unit_index];
-        percent = (ls / 10L) + 5L;
-        act->shield_strength_left[unit_index] += (percent * max_shield_strength) / 100L;
-        if (act->shield_strength_left[unit_index] > max_shield_strength) {
-            act->shield_strength_left[unit_index] = max_shield_strength;
+    for (int unit_index = 0; unit_index < num_units; unit_index++) {
+        long left = shield_strength_left[unit_index] + (regen[unit_index] * max_shield_strength[unit_index]) / 100L;
+        shield_strength_left[unit_index] = left < max_shield_strength[unit_index] ? left : max_shield_strength[unit_index];
+    }
+}
+
+// resetShots gives every unit its shots for a new round and returns the total.
+// Surprised units and ships staying out of the battle get none.
+static int resetShots(struct action_data *act) {
+    int num_units = act->num_units_fighting;
+    const int *num_shots = act->num_shots;
+    const char *surprised = act->surprised;
+    const char *unit_type = act->unit_type;
+    const char *non_combatant = act->non_combatant;
+    int *shots_left = act->shots_left;
+    int total_shots = 0;
+
+    for (int unit_index = 0; unit_index < num_units; unit_index++) {
+        int idle = (surprised[unit_index] != 0) | ((unit_type[unit_index] == SHIP) & (non_combatant[unit_index] != 0));
+        int n = num_shots[unit_index];
+        n = idle ? 0 : n;
+        shots_left[unit_index] = n;
+        total_shots += n;
+    }
+
+    return total_shots;
+}
+
+// simulateBattle fights the battle num_runs times, on up to jobs threads, and prints what the
+// battles did to each species. Every run fights on its own copy of the species, colonies and
+// ships that are present and draws from its own stream of random numbers, so the game data is
+// not changed and the report does not depend on the number of jobs.
+static void simulateBattle(struct battle_data *bat, int num_runs, int jobs) {
+    int i, run, sp_index, num_ships, num_planets, num_workers;
+    int saved_log_stdout = log_stdout;
+    pthread_t *worker;
+    simulate_pool_t pool;
+    struct nampla_data *namp;
+    struct ship_data *sh;
+    struct species_data *sp;
+
+    pool.bat = bat;
+    pool.num_runs = num_runs;
+    pool.next_run = 0;
+    pool.outcome = ncalloc(__FUNCTION__, __LINE__, num_runs, sizeof(battle_outcome_t));
+
+    /* The results are printed when all the battles are done; the battles themselves are quiet. */
+    log_stdout = FALSE;
+    if (prngHistorical() || jobs < 2 || num_runs < 2) {
+        for (run = 0; run < num_runs; run++) {
+            simulateBattleRun(bat, run, &pool.outcome[run]);
+        }
+    } else {
+        num_workers = jobs < num_runs ? jobs : num_runs;
+        worker = ncalloc(__FUNCTION__, __LINE__, num_workers, sizeof(pthread_t));
+        pthread_mutex_init(&pool.lock, NULL);
+        for (i = 0; i < num_workers; i++) {
+            if (pthread_create(&worker[i], NULL, simulateBattleWorker, &pool) != 0) {
+                fprintf(stderr, "\n\tCannot start a thread to simulate battles!\n\n");
+                exit(-1);
+            }
+        }
+        for (i = 0; i < num_workers; i++) {
+            pthread_join(worker[i], NULL);
+        }
+        pthread_mutex_destroy(&pool.lock);
+        free(worker);
+    }
+    log_stdout = saved_log_stdout;
+
+    printf("\nSimulated %d battle%s in sector %d %d %d.\n\n", num_runs, num_runs == 1 ? "" : "s", bat->x, bat->y, bat->z);
+
+    int min = pool.outcome[0].num_rounds, max = min;
+    long total = 0;
+    for (run = 0; run < num_runs; run++) {
+        int n = pool.outcome[run].num_rounds;
+        min = n < min ? n : min;
+        max = n > max ? n : max;
+        total += n;
+    }
+    printf("  Rounds fought:       mean %7.2f   min %4d   max %4d\n", (double) total / num_runs, min, max);
+
+    for (sp_index = 0; sp_index < bat->num_species_here; sp_index++) {
+        sp = &spec_data[bat->species[sp_index].spec_num - 1];
+
+        /* Count the units present before the battle. */
+        num_ships = 0;
+        sh = ship_data[sp->index];
+        for (i = 0; i < sp->num_ships; i++, sh++) {
+            if (sh->pn != 99 && sh->x == bat->x && sh->y == bat->y && sh->z == bat->z && sh->status != UNDER_CONSTRUCTION) {
+                num_ships++;
+            }
+        }
+        num_planets = 0;
+        namp = namp_data[sp->index];
+        for (i = 0; i < sp->num_namplas; i++, namp++) {
+            if (namp->pn != 99 && namp->x == bat->x && namp->y == bat->y && namp->z == bat->z && (namp->status & POPULATED)) {
+                num_planets++;
+            }
+        }
+
+        printf("\n  SP %s: %d ship%s and %d populated planet%s present.\n", sp->name,
+               num_ships, num_ships == 1 ? "" : "s", num_planets, num_planets == 1 ? "" : "s");
+
+        for (int measure = 0; measure < 5; measure++) {
+            static const char *label[5] = {"Ships left:", "Ships withdrawn:", "Ships destroyed:", "Planets lost:", "Planets damaged:"};
+            int any = 0;
+            total = 0;
+            for (run = 0; run < num_runs; run++) {
+                battle_outcome_t *o = &pool.outcome[run];
+                int n = measure == 0 ? o->ships_left[sp_index]
+                      : measure == 1 ? o->ships_withdrawn[sp_index]
+                      : measure == 2 ? o->ships_destroyed[sp_index]
+                      : measure == 3 ? o->planets_lost[sp_index]
+                      : o->planets_damaged[sp_index];
+                if (run == 0 || n < min) { min = n; }
+                if (run == 0 || n > max) { max = n; }
+                total += n;
+                any += n > 0;
+            }
+            printf("    %-18s mean %7.2f   min %4d   max %4d   in %5.1f%% of battles\n", label[measure],
+                   (double) total / num_runs, min, max, (100.0 * any) / num_runs);
+        }
+    }
+
+    free(pool.outcome);
+}
+
+// simulateBattleRun fights one simulated battle on copies of the units present and records the outcome.
+static void simulateBattleRun(struct battle_data *bat, int run, battle_outcome_t *outcome) {
+    int i, sp_index, species_number;
+    struct battle_data copy;
+    struct battle_species *bs;
+    struct nampla_data *before, *namp;
+    struct ship_data *sh;
+    battle_result_t result;
+
+    /* Copy the battle, since fighting it fills in havens, surprises, and enmities. */
+    copy = *bat;
+    copy.max_species = bat->num_species_here;
+    copy.species = ncalloc(__FUNCTION__, __LINE__, copy.max_species, sizeof(struct battle_species));
+    memcpy(copy.species, bat->species, bat->num_species_here * sizeof(struct battle_species));
+    copy.enemy_mine = NULL;
+
+    for (sp_index = 0; sp_index < copy.num_species_here; sp_index++) {
+        bs = &copy.species[sp_index];
+        species_number = bs->spec_num;
+        bs->data = ncalloc(__FUNCTION__, __LINE__, 1, sizeof(struct species_data));
+        *bs->data = spec_data[species_number - 1];
+        bs->nampla_base = ncalloc(__FUNCTION__, __LINE__, bs->data->num_namplas + 1, sizeof(struct nampla_data));
+        memcpy(bs->nampla_base, namp_data[species_number - 1], bs->data->num_namplas * sizeof(struct nampla_data));
+        bs->ship_base = ncalloc(__FUNCTION__, __LINE__, bs->data->num_ships + 1, sizeof(struct ship_data));
+        memcpy(bs->ship_base, ship_data[species_number - 1], bs->data->num_ships * sizeof(struct ship_data));
+    }
+
+    memset(&result, 0, sizeof(result));
+    fightBattle(&copy, &result, "simulate", ((uint64_t) (run + 1) << 24) | battleKey(bat));
+    outcome->num_rounds = result.num_rounds;
+
+    /* Compare the copies with the game data to see what the battle did. */
+    for (sp_index = 0; sp_index < copy.num_species_here; sp_index++) {
+        bs = &copy.species[sp_index];
+        species_number = bs->spec_num;
+
+        sh = bs->ship_base;
+        for (i = 0; i < bs->data->num_ships; i++, sh++) {
+            struct ship_data *was = &ship_data[species_number - 1][i];
+            if (was->pn == 99 || was->x != bat->x || was->y != bat->y || was->z != bat->z) { continue; }
+            if (was->status == UNDER_CONSTRUCTION) { continue; }
+            if (sh->pn == 99 || sh->age > 49) {
+                outcome->ships_destroyed[sp_index]++;
+            } else if (sh->status == JUMPED_IN_COMBAT || sh->status == FORCED_JUMP) {
+                outcome->ships_withdrawn[sp_index]++;
+            } else {
+                outcome->ships_left[sp_index]++;
+            }
+        }
+
+        namp = bs->nampla_base;
+        before = namp_data[species_number - 1];
+        for (i = 0; i < bs->data->num_namplas; i++, namp++, before++) {
+            if (before->pn == 99 || before->x != bat->x || before->y != bat->y || before->z != bat->z) { continue; }
+            if ((before->status & POPULATED) == 0) { continue; }
+            if ((namp->status & POPULATED) == 0) {
+                outcome->planets_lost[sp_index]++;
+            } else if (namp->mi_base < before->mi_base || namp->ma_base < before->ma_base || namp->pop_units < before->pop_units) {
+                outcome->planets_damaged[sp_index]++;
+            }
+        }
+
+        free(bs->data);
+        free(bs->nampla_base);
+        free(bs->ship_base);
+    }
+
+    free(result.log);
+    free(result.summary);
+    free(result.transaction);
+    free(copy.enemy_mine);
+    free(copy.species);
+}
+
+// simulateBattleWorker takes simulated battles from the pool and fights them until there are none left.
+static void *simulateBattleWorker(void *arg) {
+    simulate_pool_t *pool = (simulate_pool_t *) arg;
+    int run;
+
+    /* Only the main thread writes to the terminal. */
+    log_stdout = FALSE;
+
+    while (TRUE) {
+        pthread_mutex_lock(&pool->lock);
+        run = pool->next_run++;
+        pthread_mutex_unlock(&pool->lock);
+        if (run >= pool->num_runs) {
+            break;
         }
+        simulateBattleRun(pool->bat, run, &pool->outcome[run]);
     }
+
+    return NULL;
 }
 
 /* This routine will check all fighting ships and see if any wish to
@@ -3490,40 +3947,35 @@ void withdrawal_check(struct battle_data *bat, struct action_data *act) {
             continue;
         }
 
-        sh = (struct ship_data *) act->fighting_unit[ship_index];
         species_index = act->fighting_species_index[ship_index];
         ++num_ships_total[species_index];
 
-        if (sh->status == JUMPED_IN_COMBAT) {
-            /* Already withdrawn. */
-            ++num_ships_gone[species_index];
-            continue;
-        }
-        if (sh->status == FORCED_JUMP) {
-            /* Forced to leave. */
+        if (act->jumped[ship_index]) {
+            /* Already withdrawn or forced to leave. */
             ++num_ships_gone[species_index];
             continue;
         }
-        if (sh->age > 49) {
+        if (act->age[ship_index] > 49) {
             /* Already destroyed. */
             ++num_ships_gone[species_index];
             continue;
         }
-        if (sh->type != FTL) {
+        if (act->ship_type[ship_index] != FTL) {
             continue;
         }    /* Ship can't jump. */
 
-        if (sh->class == TR) {
-            withdraw_age = bat->transport_withdraw_age[species_index];
+        if (act->ship_class[ship_index] == TR) {
+            withdraw_age = bat->species[species_index].transport_withdraw_age;
             if (withdraw_age == 0) {
                 /* Transports will withdraw only when entire fleet withdraws. */
                 continue;
             }
         } else {
-            withdraw_age = bat->warship_withdraw_age[species_index];
+            withdraw_age = bat->species[species_index].warship_withdraw_age;
         }
 
-        if (sh->age > withdraw_age) {
+        if (act->age[ship_index] > withdraw_age) {
+            sh = (struct ship_data *) act->fighting_unit[ship_index];
             act->num_shots[ship_index] = 0;
             act->shots_left[ship_index] = 0;
             sh->pn = 0;
@@ -3535,11 +3987,12 @@ void withdrawal_check(struct battle_data *bat, struct action_data *act) {
 
             ignore_field_distorters = FALSE;
 
-            sh->dest_x = bat->haven_x[species_index];
-            sh->dest_y = bat->haven_y[species_index];
-            sh->dest_z = bat->haven_z[species_index];
+            sh->dest_x = bat->species[species_index].haven_x;
+            sh->dest_y = bat->species[species_index].haven_y;
+            sh->dest_z = bat->species[species_index].haven_z;
 
             sh->status = JUMPED_IN_COMBAT;
+            act->jumped[ship_index] = TRUE;
 
             ++num_ships_gone[species_index];
         }
@@ -3551,33 +4004,29 @@ void withdrawal_check(struct battle_data *bat, struct action_data *act) {
             continue;
         }
 
-        sh = (struct ship_data *) act->fighting_unit[ship_index];
         species_index = act->fighting_species_index[ship_index];
 
-        if (sh->type != FTL) {
+        if (act->ship_type[ship_index] != FTL) {
             /* Ship can't jump. */
             continue;
         }
-        if (sh->status == JUMPED_IN_COMBAT) {
-            /* Already withdrawn. */
-            continue;
-        }
-        if (sh->status == FORCED_JUMP) {
-            /* Already gone. */
+        if (act->jumped[ship_index]) {
+            /* Already withdrawn or gone. */
             continue;
         }
-        if (sh->age > 49) {
+        if (act->age[ship_index] > 49) {
             /* Already destroyed. */
             continue;
         }
 
-        if (bat->fleet_withdraw_percentage[species_index] == 0) {
+        if (bat->species[species_index].fleet_withdraw_percentage == 0) {
             percent_loss = 101;        /* Always withdraw immediately. */
         } else {
             percent_loss = (100 * num_ships_gone[species_index]) / num_ships_total[species_index];
         }
 
-        if (percent_loss > bat->fleet_withdraw_percentage[species_index]) {
+        if (percent_loss > bat->species[species_index].fleet_withdraw_percentage) {
+            sh = (struct ship_data *) act->fighting_unit[ship_index];
             act->num_shots[ship_index] = 0;
             act->shots_left[ship_index] = 0;
             sh->pn = 0;
@@ -3589,11 +4038,12 @@ void withdrawal_check(struct battle_data *bat, struct action_data *act) {
 
             ignore_field_distorters = FALSE;
 
-            sh->dest_x = bat->haven_x[species_index];
-            sh->dest_y = bat->haven_y[species_index];
-            sh->dest_z = bat->haven_z[species_index];
+            sh->dest_x = bat->species[species_index].haven_x;
+            sh->dest_y = bat->species[species_index].haven_y;
+            sh->dest_z = bat->species[species_index].haven_z;
 
             sh->status = JUMPED_IN_COMBAT;
+            act->jumped[ship_index] = TRUE;
         }
     }
 
@@ -23,10 +23,6 @@
 #include "ship.h"
 #include "location.h"
 
-#define MAX_BATTLES        50  /* Maximum number of battle locations for all players. */
-#define MAX_SHIPS          200 /* Maximum number of ships at a single battle. */
-#define MAX_ENGAGE_OPTIONS 20  /* Maximum number of engagement options that a player may specify for a single battle. */
-
 /* Types of combatants. */
 #define SHIP            1
 #define NAMPLA          2
@@ -52,39 +48,63 @@
 /* Special types. */
 #define NON_COMBATANT       1
 
+/* The orders of one species at a battle. */
+struct battle_species {
+    char spec_num;
+    char summary_only;
+    char transport_withdraw_age;
+    char warship_withdraw_age;
+    char fleet_withdraw_percentage;
+    char haven_x;
+    char haven_y;
+    char haven_z;
+    char special_target;
+    char hijacker;
+    char can_be_surprised;
+    int num_enemies;            /* Species named in ATTACK orders, or negated if named in HIJACK orders. */
+    int max_enemies;
+    int *enemy;
+    int num_engage_options;
+    int max_engage_options;
+    char *engage_option;
+    char *engage_planet;
+    long ambush_amount;
+    struct species_data *data;  /* Copies to fight on in a simulation, or NULL to fight on the game data. */
+    struct nampla_data *nampla_base;
+    struct ship_data *ship_base;
+};
+
 struct battle_data {
-    char x, y, z, num_species_here;
-    char spec_num[MAX_SPECIES];
-    char summary_only[MAX_SPECIES];
-    char transport_withdraw_age[MAX_SPECIES];
-    char warship_withdraw_age[MAX_SPECIES];
-    char fleet_withdraw_percentage[MAX_SPECIES];
-    char haven_x[MAX_SPECIES];
-    char haven_y[MAX_SPECIES];
-    char haven_z[MAX_SPECIES];
-    char special_target[MAX_SPECIES];
-    char hijacker[MAX_SPECIES];
-    char can_be_surprised[MAX_SPECIES];
-    char enemy_mine[MAX_SPECIES][MAX_SPECIES];
-    char num_engage_options[MAX_SPECIES];
-    char engage_option[MAX_SPECIES][MAX_ENGAGE_OPTIONS];
-    char engage_planet[MAX_SPECIES][MAX_ENGAGE_OPTIONS];
-    long ambush_amount[MAX_SPECIES];
+    char x, y, z;
+    int num_species_here;
+    int max_species;
+    struct battle_species *species;
+    unsigned *enemy_mine;       /* Two bits for each pair of species, set from the enemy lists when the battle starts. */
 };
 
+/* The units taking part in an action. The arrays grow as units are added. */
 struct action_data {
     int num_units_fighting;
-    int fighting_species_index[MAX_SHIPS];
-    int num_shots[MAX_SHIPS];
-    int shots_left[MAX_SHIPS];
-    long weapon_damage[MAX_SHIPS];
-    long shield_strength[MAX_SHIPS];
-    long shield_strength_left[MAX_SHIPS];
-    long original_age_or_PDs[MAX_SHIPS];
-    long bomb_damage[MAX_SHIPS];
-    char surprised[MAX_SHIPS];
-    char unit_type[MAX_SHIPS];
-    char *fighting_unit[MAX_SHIPS];
+    int max_units;
+    int *fighting_species_index;
+    int *num_shots;
+    int *shots_left;
+    long *weapon_damage;
+    long *shield_strength;
+    long *shield_strength_left;
+    long *original_age_or_PDs;
+    long *bomb_damage;
+    char *surprised;
+    char *unit_type;
+    char **fighting_unit;
+    int *target_index;          /* Scratch space for do_round. */
+    /* Copies of the unit fields that are read every shot, kept in step with the units by the rounds. */
+    int *shield_regen;          /* Percent of shield strength regenerated each round. */
+    int *age;
+    char *jumped;               /* Ship was forced to jump or withdrew. */
+    char *non_combatant;
+    char *ship_class;
+    char *ship_type;
 };
 
 
@@ -98,8 +118,9 @@ void bad_species(void);
 
 void battle_error(int species_number);
 
-// combat returns TRUE if planet, species, and transaction data should be saved
-int combat(int default_summary, int do_all_species, int num_species, int *sp_num, char **sp_name, sp_loc_data_t *locations_base);
+// combat returns TRUE if planet, species, and transaction data should be saved.
+// Battles are fought on up to jobs threads.
+int combat(int default_summary, int do_all_species, int num_species, int *sp_num, char **sp_name, sp_loc_data_t *locations_base, int jobs);
 
 int combatCommand(int argc, char *argv[]);
 
@@ -28,6 +28,7 @@
 #include "starvars.h"
 #include "speciesio.h"
 #include "speciesvars.h"
+#include "nameindex.h"
 #include "nampla.h"
 #include "namplavars.h"
 #include "ship.h"
@@ -37,6 +38,7 @@
 #include "command.h"
 #include "commandvars.h"
 #include "jumpvars.h"
+#include "ordercache.h"
 
 
 /* The following routine will check that the next argument in the current command line is followed by a comma or tab.
@@ -547,10 +549,10 @@ int get_jump_portal(void) {
  * If planet is not specified, pn will be set to zero.
  * If location is valid, TRUE will be returned, otherwise FALSE will be returned. */
 int get_location(void) {
-    int i, n, found, temp_nampla_index, first_try, name_length;
+    int i, found, temp_nampla_index, first_try, name_length;
     int best_score, next_best_score, best_nampla_index;
     int minimum_score;
-    char upper_nampla_name[32], *temp1_ptr, *temp2_ptr;
+    char *temp1_ptr, *temp2_ptr;
     struct nampla_data *temp_nampla;
 
     /* Check first if x, y, z are specified. */
@@ -629,18 +631,10 @@ int get_location(void) {
     get_name();
 
     /* Search all temp_namplas for name. */
-    temp_nampla = nampla_base - 1;
-    for (temp_nampla_index = 0; temp_nampla_index < species->num_namplas; temp_nampla_index++) {
-        temp_nampla++;
-        if (temp_nampla->pn == 99) {
-            continue;
-        }
-        /* Make upper case copy of temp_nampla name. */
-        for (i = 0; i < 32; i++) {
-            upper_nampla_name[i] = toupper(temp_nampla->name[i]);
-        }
-        /* Compare names. */
-        if (strcmp(upper_nampla_name, upper_name) == 0) { goto done; }
+    temp_nampla_index = nameIndexFindNampla(species - spec_data, upper_name);
+    if (temp_nampla_index >= 0) {
+        temp_nampla = nampla_base + temp_nampla_index;
+        goto done;
     }
 
     if (first_try) {
@@ -663,26 +657,9 @@ int get_location(void) {
     /* Get planet name. */
     get_name();
 
-    best_nampla_index = 0;
-    best_score = -9999;
-    next_best_score = -9999;
-    for (temp_nampla_index = 0; temp_nampla_index < species->num_namplas; temp_nampla_index++) {
-        temp_nampla = nampla_base + temp_nampla_index;
-        if (temp_nampla->pn == 99) {
-            continue;
-        }
-        /* Make upper case copy of temp_nampla name. */
-        for (i = 0; i < 32; i++) {
-            upper_nampla_name[i] = toupper(temp_nampla->name[i]);
-        }
-        /* Compare names. */
-        n = agrep_score(upper_nampla_name, upper_name);
-        if (n > best_score) {
-            best_score = n;    /* Best match so far. */
-            best_nampla_index = temp_nampla_index;
-        } else if (n > next_best_score) {
-            next_best_score = n;
-        }
+    best_nampla_index = nameIndexBestNampla(species - spec_data, upper_name, &best_score, &next_best_score);
+    if (best_nampla_index < 0) {
+        best_nampla_index = 0;
     }
 
     temp_nampla = nampla_base + best_nampla_index;
@@ -726,7 +703,7 @@ int get_name(void) {
     skip_whitespace();
     while (TRUE) {
         char c = *input_line_pointer;
-        if (c == ';') {
+        if (c == ';' || c == '\0') {
             break;
         }
         ++input_line_pointer;
@@ -760,8 +737,8 @@ int get_name(void) {
  * Otherwise, it will return FALSE.
  * The algorithm employed allows minor spelling errors, as well as accidental deletion of a ship abbreviation. */
 int get_ship(void) {
-    int i, n, name_length, best_score, next_best_score, best_ship_index, first_try, minimum_score;
-    char upper_ship_name[32], *temp1_ptr, *temp2_ptr;
+    int n, name_length, best_score, next_best_score, best_ship_index, first_try, minimum_score;
+    char *temp1_ptr, *temp2_ptr;
     struct ship_data *best_ship = NULL;
 
     /* Save in case of an error. */
@@ -790,23 +767,13 @@ int get_ship(void) {
     name_length = get_name();
 
     /* Search all ships for name. */
-    ship = ship_base - 1;
-    for (ship_index = 0; ship_index < species->num_ships; ship_index++) {
-        ++ship;
-        if (ship->pn == 99) {
-            continue;
-        }
-        /* Make upper case copy of ship name. */
-        for (i = 0; i < 32; i++) {
-            upper_ship_name[i] = toupper(ship->name[i]);
-        }
-        /* Compare names. */
-        if (strcmp(upper_ship_name, upper_name) == 0) {
-            abbr_type = SHIP_CLASS;
-            abbr_index = ship->class;
-            correct_spelling_required = FALSE;
-            return TRUE;
-        }
+    ship_index = nameIndexFindShip(species - spec_data, upper_name);
+    if (ship_index >= 0) {
+        ship = ship_base + ship_index;
+        abbr_type = SHIP_CLASS;
+        abbr_index = ship->class;
+        correct_spelling_required = FALSE;
+        return TRUE;
     }
 
     if (first_try) {
@@ -834,27 +801,10 @@ int get_ship(void) {
     /* Get ship name. */
     name_length = get_name();
 
-    best_score = -9999;
-    next_best_score = -9999;
-    for (ship_index = 0; ship_index < species->num_ships; ship_index++) {
-        ship = ship_base + ship_index;
-
-        if (ship->pn == 99) { continue; }
-
-        /* Make upper case copy of ship name. */
-        for (i = 0; i < 32; i++) {
-            upper_ship_name[i] = toupper(ship->name[i]);
-        }
-
-        n = agrep_score(upper_ship_name, upper_name);
-        if (n > best_score) {
-            /* Best match so far. */
-            best_score = n;
-            best_ship = ship;
-            best_ship_index = ship_index;
-        } else if (n > next_best_score) {
-            next_best_score = n;
-        }
+    n = nameIndexBestShip(species - spec_data, upper_name, &best_score, &next_best_score);
+    if (n >= 0) {
+        best_ship = ship_base + n;
+        best_ship_index = n;
     }
 
     if (best_ship == NULL) {
@@ -1047,7 +997,7 @@ void skip_junk(void) {
     again:
 
     /* Read next line. */
-    input_line_pointer = readln(input_line, 256, input_file);
+    input_line_pointer = ordersReadln(input_line, 256);
     if (input_line_pointer == NULL) {
         end_of_file = TRUE;
         return;
@@ -1062,7 +1012,7 @@ void skip_junk(void) {
         if (strncmp(input_line, "From ", 5) == 0) {
             /* This is a mail header. */
             while (TRUE) {
-                input_line_pointer = readln(input_line, 256, input_file);
+                input_line_pointer = ordersReadln(input_line, 256);
                 if (input_line_pointer == NULL) {
                     end_of_file = TRUE;        /* Weird. */
                     return;
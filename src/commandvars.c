@@ -56,7 +56,6 @@ char g_spec_name[32];
 
 char input_abbr[256];
 
-FILE *input_file;
 
 char input_line[256];
 
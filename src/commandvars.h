@@ -33,7 +33,6 @@ extern int end_of_file;
 extern int g_spec_number;
 extern char g_spec_name[32];
 extern char input_abbr[256];
-extern FILE *input_file;
 extern char input_line[256];
 extern char *input_line_pointer;
 extern int just_opened_file;
@@ -0,0 +1,70 @@
+// Far Horizons Game Engine
+// Copyright (C) 2022 Michael D Henderson
+// Copyright (C) 2021 Raven Zachary
+// Copyright (C) 2019 Casey Link, Adam Piggott
+// Copyright (C) 1999 Richard A. Morneau
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdio.h>
+#include <string.h>
+#include "convert.h"
+#include "galaxyio.h"
+#include "planetio.h"
+#include "speciesio.h"
+#include "stario.h"
+
+
+// convertCommand rewrites stars.dat, planets.dat, and the species files
+// in the requested format. Later commands keep whatever format they find.
+int convertCommand(int argc, char *argv[]) {
+    int version = 0;
+    for (int i = 1; i < argc; i++) {
+        char *opt = argv[i];
+        if (strcmp(opt, "--help") == 0 || strcmp(opt, "-h") == 0 || strcmp(opt, "-?") == 0) {
+            fprintf(stderr, "usage: convert (v1 | v2)\n");
+            fprintf(stderr, "  v1  the original data.h formats, readable on any host\n");
+            fprintf(stderr, "  v2  the in-memory layout, mapped instead of translated when loaded\n");
+            return 2;
+        } else if (strcmp(opt, "v1") == 0 && version == 0) {
+            version = 1;
+        } else if (strcmp(opt, "v2") == 0 && version == 0) {
+            version = 2;
+        } else {
+            fprintf(stderr, "fh: convert: unknown option '%s'\n", opt);
+            return 2;
+        }
+    }
+    if (version == 0) {
+        fprintf(stderr, "fh: convert: you must specify v1 or v2\n");
+        return 2;
+    }
+
+    get_galaxy_data();
+    get_star_data();
+    get_planet_data();
+    get_species_data();
+
+    star_data_version = version;
+    save_star_data();
+    planet_data_version = version;
+    save_planet_data();
+    for (int species_index = 0; species_index < galaxy.num_species; species_index++) {
+        species_data_version[species_index] = version;
+        data_modified[species_index] = data_in_memory[species_index];
+    }
+    save_species_data();
+
+    return 0;
+}
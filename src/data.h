@@ -164,4 +164,32 @@ typedef struct {
 } binary_star_data_t;
 
 
+// Version 2 data files hold the in-memory structs from engine.h as-is.
+// The file starts with this header, padded to BINARY_V2_ALIGN bytes, and
+// each section starts on a BINARY_V2_ALIGN boundary. Pointer fields are
+// written as zero and rebuilt when the file is loaded. A file can only be
+// read on a host with the same byte order and struct layout as the one
+// that wrote it; use `fh convert v1` to move data between hosts.
+
+#define BINARY_V2_MAGIC        "FHv2"
+#define BINARY_V2_VERSION      2
+#define BINARY_V2_BYTE_ORDER   0x01020304
+#define BINARY_V2_ALIGN        64
+#define BINARY_V2_MAX_SECTIONS 4
+
+typedef struct {
+    uint32_t record_size;   /* sizeof the in-memory struct that wrote the records. */
+    uint32_t num_records;
+    uint64_t offset;        /* From the start of the file. */
+} binary_v2_section_t;
+
+typedef struct {
+    char magic[4];          /* BINARY_V2_MAGIC, not nul-terminated. */
+    uint32_t version;       /* BINARY_V2_VERSION. */
+    uint32_t byte_order;    /* BINARY_V2_BYTE_ORDER in the writer's byte order. */
+    uint32_t num_sections;
+    binary_v2_section_t section[BINARY_V2_MAX_SECTIONS];
+} binary_v2_header_t;
+
+
 #endif //FAR_HORIZONS_DATA_H
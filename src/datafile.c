@@ -0,0 +1,175 @@
+// Far Horizons Game Engine
+// Copyright (C) 2022 Michael D Henderson
+// Copyright (C) 2021 Raven Zachary
+// Copyright (C) 2019 Casey Link, Adam Piggott
+// Copyright (C) 1999 Richard A. Morneau
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "data.h"
+#include "datafile.h"
+#include "engine.h"
+
+
+int map_data_in_place = FALSE;
+
+
+// datafileIsV2 returns TRUE if the file exists and starts with the version 2 magic.
+int datafileIsV2(const char *filename) {
+    FILE *fp = fopen(filename, "rb");
+    if (fp == NULL) {
+        return FALSE;
+    }
+    char magic[4];
+    int isV2 = fread(magic, sizeof(magic), 1, fp) == 1 && memcmp(magic, BINARY_V2_MAGIC, 4) == 0;
+    fclose(fp);
+    return isV2;
+}
+
+
+// datafileOpen maps a version 2 file into memory.
+// Returns FALSE, without touching df, if the file is not a version 2 file.
+// The mapping is private, so callers may patch the records (pointers, mostly)
+// without changing the file.
+int datafileOpen(const char *filename, datafile_t *df) {
+    if (!datafileIsV2(filename)) {
+        return FALSE;
+    }
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        perror("datafileOpen");
+        fprintf(stderr, "\n\tCannot open file '%s'!\n", filename);
+        exit(2);
+    }
+    struct stat sb;
+    if (fstat(fd, &sb) != 0) {
+        perror("datafileOpen");
+        fprintf(stderr, "\n\tCannot stat file '%s'!\n", filename);
+        exit(2);
+    }
+    if (sb.st_size < (off_t) sizeof(binary_v2_header_t)) {
+        fprintf(stderr, "\n\tFile '%s' is too short for a version 2 header!\n", filename);
+        exit(2);
+    }
+    void *base = mmap(NULL, (size_t) sb.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (base == MAP_FAILED) {
+        perror("datafileOpen");
+        fprintf(stderr, "\n\tCannot map file '%s' into memory!\n", filename);
+        exit(2);
+    }
+    close(fd);
+
+    binary_v2_header_t *header = (binary_v2_header_t *) base;
+    if (header->byte_order != BINARY_V2_BYTE_ORDER) {
+        fprintf(stderr, "\n\tFile '%s' was written on a host with a different byte order!\n", filename);
+        fprintf(stderr, "\tRun 'fh convert v1' on that host and copy the version 1 files instead.\n\n");
+        exit(2);
+    }
+    if (header->version != BINARY_V2_VERSION || header->num_sections > BINARY_V2_MAX_SECTIONS) {
+        fprintf(stderr, "\n\tFile '%s' has an unsupported version 2 header!\n\n", filename);
+        exit(2);
+    }
+    for (uint32_t i = 0; i < header->num_sections; i++) {
+        binary_v2_section_t *section = &header->section[i];
+        uint64_t end = section->offset + (uint64_t) section->record_size * section->num_records;
+        if (section->offset % BINARY_V2_ALIGN != 0 || end > (uint64_t) sb.st_size) {
+            fprintf(stderr, "\n\tFile '%s' is truncated or corrupt (section %u)!\n\n", filename, i);
+            exit(2);
+        }
+    }
+
+    memset(df, 0, sizeof(datafile_t));
+    snprintf(df->filename, sizeof(df->filename), "%s", filename);
+    df->base = base;
+    df->length = (size_t) sb.st_size;
+    df->header = header;
+    return TRUE;
+}
+
+
+// datafileSection returns the records in a section and sets numRecords.
+// The record size must match the struct that the caller expects; a mismatch
+// means the file came from a build with a different struct layout.
+void *datafileSection(datafile_t *df, int section, int recordSize, int *numRecords) {
+    if (section < 0 || section >= (int) df->header->num_sections) {
+        fprintf(stderr, "\n\tFile '%s' is missing section %d!\n\n", df->filename, section);
+        exit(2);
+    }
+    binary_v2_section_t *s = &df->header->section[section];
+    if (s->record_size != (uint32_t) recordSize) {
+        fprintf(stderr, "\n\tFile '%s' section %d has %u byte records, but this build uses %d!\n",
+                df->filename, section, s->record_size, recordSize);
+        fprintf(stderr, "\tRun 'fh convert v1' with the build that wrote it.\n\n");
+        exit(2);
+    }
+    *numRecords = (int) s->num_records;
+    return (char *) df->base + s->offset;
+}
+
+
+void datafileClose(datafile_t *df) {
+    if (df->base != NULL) {
+        munmap(df->base, df->length);
+    }
+    memset(df, 0, sizeof(datafile_t));
+}
+
+
+// datafileWrite writes a version 2 file with one section per set of records.
+// Callers are expected to have cleared any pointers in the records.
+// If fi holds the file as it was loaded, only the records that changed are written.
+void datafileWrite(const char *filename, file_image_t *fi, int numSections, void *records[], int recordSize[], int numRecords[]) {
+    if (numSections > BINARY_V2_MAX_SECTIONS) {
+        fprintf(stderr, "error: datafileWrite: internal error: %d sections for '%s'\n", numSections, filename);
+        exit(2);
+    }
+
+    binary_v2_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BINARY_V2_MAGIC, 4);
+    header.version = BINARY_V2_VERSION;
+    header.byte_order = BINARY_V2_BYTE_ORDER;
+    header.num_sections = (uint32_t) numSections;
+    file_records_t sections[BINARY_V2_MAX_SECTIONS];
+    uint64_t offset = (sizeof(header) + BINARY_V2_ALIGN - 1) / BINARY_V2_ALIGN * BINARY_V2_ALIGN;
+    uint64_t length = offset;
+    for (int i = 0; i < numSections; i++) {
+        header.section[i].record_size = (uint32_t) recordSize[i];
+        header.section[i].num_records = (uint32_t) numRecords[i];
+        header.section[i].offset = offset;
+        sections[i].offset = (size_t) offset;
+        sections[i].record_size = recordSize[i];
+        sections[i].num_records = numRecords[i];
+        length = offset + (uint64_t) recordSize[i] * numRecords[i];
+        offset = (length + BINARY_V2_ALIGN - 1) / BINARY_V2_ALIGN * BINARY_V2_ALIGN;
+    }
+
+    // lay the file out in memory; the padding stays zero
+    unsigned char *image = (unsigned char *) ncalloc(__FUNCTION__, __LINE__, (int) length, 1);
+    memcpy(image, &header, sizeof(header));
+    for (int i = 0; i < numSections; i++) {
+        memcpy(image + sections[i].offset, records[i], (size_t) recordSize[i] * numRecords[i]);
+    }
+    fileImageWrite(fi, filename, image, (size_t) length, numSections, sections);
+    free(image);
+}
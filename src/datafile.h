@@ -0,0 +1,50 @@
+// Far Horizons Game Engine
+// Copyright (C) 2022 Michael D Henderson
+// Copyright (C) 2021 Raven Zachary
+// Copyright (C) 2019 Casey Link, Adam Piggott
+// Copyright (C) 1999 Richard A. Morneau
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef FAR_HORIZONS_DATAFILE_H
+#define FAR_HORIZONS_DATAFILE_H
+
+#include <stddef.h>
+#include "data.h"
+#include "fileimage.h"
+
+// a version 2 data file mapped into memory
+typedef struct {
+    char filename[128];
+    void *base;
+    size_t length;
+    binary_v2_header_t *header;
+} datafile_t;
+
+// TRUE if the command never saves, so records in version 2 files can be used
+// where they are mapped instead of being copied into the heap.
+extern int map_data_in_place;
+
+int datafileIsV2(const char *filename);
+
+int datafileOpen(const char *filename, datafile_t *df);
+
+void *datafileSection(datafile_t *df, int section, int recordSize, int *numRecords);
+
+void datafileClose(datafile_t *df);
+
+void datafileWrite(const char *filename, file_image_t *fi, int numSections, void *records[], int recordSize[], int numRecords[]);
+
+#endif //FAR_HORIZONS_DATAFILE_H
@@ -17,6 +17,7 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
@@ -34,14 +35,18 @@
 #include "log.h"
 #include "logvars.h"
 #include "money.h"
+#include "nameindex.h"
 #include "nampla.h"
 #include "namplavars.h"
+#include "ordercache.h"
 #include "productionvars.h"
+#include "sector.h"
 #include "planet.h"
 #include "planetio.h"
 #include "planetvars.h"
 #include "ship.h"
 #include "shipvars.h"
+#include "snapshot.h"
 #include "species.h"
 #include "speciesio.h"
 #include "speciesvars.h"
@@ -145,7 +150,7 @@ void do_ALLY_command(void) {
 void do_BASE_command(void) {
     int i, n, found, su_count, original_count, item_class, name_length;
     int unused_ship_available, new_tonnage, max_tonnage, new_starbase;
-    int source_is_a_planet, age_new;
+    int source_is_a_planet, source_ship_index, age_new;
     char x, y, z, pn, upper_ship_name[32], *original_line_pointer;
     struct nampla_data *source_nampla;
     struct ship_data *source_ship, *starbase, *unused_ship;
@@ -289,13 +294,10 @@ void do_BASE_command(void) {
         if (unused_ship_available) {
             starbase = unused_ship;
         } else {
-            /* Make sure we have enough memory for new starbase. */
-            if (num_new_ships[species_index] == NUM_EXTRA_SHIPS) {
-                fprintf(stderr, "\n\n\tInsufficient memory for new starbase!\n\n");
-                exit(-1);
-            }
-            ++num_new_ships[species_index];
-            starbase = ship_base + (int) species->num_ships;
+            /* Make room for the new starbase. The ships may move, so find the source ship again. */
+            source_ship_index = source_is_a_planet ? 0 : source_ship - ship_base;
+            starbase = speciesReserveShip(species_index);
+            if (!source_is_a_planet) { source_ship = ship_base + source_ship_index; }
             ++species->num_ships;
             delete_ship(starbase);        /* Initialize everything to zero. */
         }
@@ -306,6 +308,8 @@ void do_BASE_command(void) {
         starbase->y = y;
         starbase->z = z;
         starbase->pn = pn;
+        sectorPlaceShip(species_number - 1, starbase - ship_data[species_number - 1]);
+        nameIndexPlaceShip(species_number - 1, starbase - ship_data[species_number - 1]);
         if (pn == 0) {
             starbase->status = IN_DEEP_SPACE;
         } else {
@@ -609,15 +613,10 @@ void do_BUILD_command(int continuing_construction, int interspecies_construction
         log_string(" was");
     }
 
-    if (first_pass && class == PD && siege_effectiveness > 0) {
-        log_string(" scheduled for production despite the siege.\n");
-        return;
-    } else {
-        log_string(" produced");
-        if (interspecies_construction) {
-            log_string(" for SP ");
-            log_string(recipient_species->name);
-        }
+    log_string(" produced");
+    if (interspecies_construction) {
+        log_string(" for SP ");
+        log_string(recipient_species->name);
     }
 
     if (unit_cost != 1 || premium != 0) {
@@ -633,7 +632,7 @@ void do_BUILD_command(int continuing_construction, int interspecies_construction
         /* Make sure we don't notify the same species more than once. */
         for (i = 0; i < MAX_SPECIES; i++) { already_notified[i] = FALSE; }
 
-        for (i = 0; i < num_transactions; i++) {
+        for (i = transactionFirstTo(species_number, BESIEGE_PLANET); i >= 0; i = transactionNextTo(i, BESIEGE_PLANET)) {
             /* Find out who is besieging this planet. */
             if (transaction[i].type != BESIEGE_PLANET) { continue; }
             if (transaction[i].x != nampla->x) { continue; }
@@ -647,12 +646,7 @@ void do_BUILD_command(int continuing_construction, int interspecies_construction
             if (already_notified[alien_number - 1]) { continue; }
 
             /* Define a 'detection' transaction. */
-            if (num_transactions == MAX_TRANSACTIONS) {
-                fprintf(stderr, "\n\n\tERROR! num_transactions > MAX_TRANSACTIONS!\n\n");
-                exit(-1);
-            }
-
-            n = num_transactions++;
+            n = transactionAdd();
             transaction[n].type = DETECTION_DURING_SIEGE;
             transaction[n].value = 3;    /* Construction of PDs. */
             strcpy(transaction[n].name1, nampla->name);
@@ -773,12 +767,7 @@ void do_BUILD_command(int continuing_construction, int interspecies_construction
         if (unused_nampla_available) {
             recipient_nampla = unused_nampla;
         } else {
-            ++num_new_namplas[species_index];
-            if (num_new_namplas[species_index] > NUM_EXTRA_NAMPLAS) {
-                fprintf(stderr, "\n\n\tInsufficient memory for new planet name in do_BUILD_command!\n");
-                exit(-1);
-            }
-            recipient_nampla = namp_data[g_spec_number - 1] + recipient_species->num_namplas;
+            recipient_nampla = speciesReserveNampla(g_spec_number - 1);
             recipient_species->num_namplas += 1;
             delete_nampla(recipient_nampla);    /* Set everything to zero. */
         }
@@ -789,6 +778,8 @@ void do_BUILD_command(int continuing_construction, int interspecies_construction
         recipient_nampla->y = nampla->y;
         recipient_nampla->z = nampla->z;
         recipient_nampla->pn = nampla->pn;
+        sectorPlaceNampla(g_spec_number - 1, recipient_nampla - namp_data[g_spec_number - 1]);
+        nameIndexPlaceNampla(g_spec_number - 1, recipient_nampla - namp_data[g_spec_number - 1]);
         recipient_nampla->planet_index = nampla->planet_index;
         recipient_nampla->status = COLONY;
     }
@@ -798,15 +789,8 @@ void do_BUILD_command(int continuing_construction, int interspecies_construction
     recipient_nampla->item_quantity[class] += num_items;
     data_modified[g_spec_number - 1] = TRUE;
 
-    if (first_pass) { return; }
-
     /* Define transaction so that recipient will be notified. */
-    if (num_transactions == MAX_TRANSACTIONS) {
-        fprintf(stderr, "\n\n\tERROR! num_transactions > MAX_TRANSACTIONS!\n\n");
-        exit(-1);
-    }
-
-    n = num_transactions++;
+    n = transactionAdd();
     transaction[n].type = INTERSPECIES_CONSTRUCTION;
     transaction[n].donor = species_number;
     transaction[n].recipient = g_spec_number;
@@ -909,18 +893,8 @@ void do_BUILD_command(int continuing_construction, int interspecies_construction
         if (unused_ship_available) {
             ship = unused_ship;
         } else {
-            /* Make sure we have enough memory for new ship. */
-            if (num_new_ships[species_index] >= NUM_EXTRA_SHIPS) {
-                if (num_new_ships[species_index] == 9999) { return; }
-
-                fprintf(log_file, "!!! Order ignored:\n");
-                fprintf(log_file, "!!! %s", original_line);
-                fprintf(log_file, "!!! You cannot build more than %d ships per turn!\n", NUM_EXTRA_SHIPS);
-                num_new_ships[species_index] = 9999;
-                return;
-            }
             new_ship = TRUE;
-            ship = ship_base + (int) species->num_ships;
+            ship = speciesReserveShip(species_index);
             /* Initialize everything to zero. */
             delete_ship(ship);
         }
@@ -931,6 +905,8 @@ void do_BUILD_command(int continuing_construction, int interspecies_construction
         ship->y = nampla->y;
         ship->z = nampla->z;
         ship->pn = nampla->pn;
+        sectorPlaceShip(species_number - 1, ship - ship_data[species_number - 1]);
+        nameIndexPlaceShip(species_number - 1, ship - ship_data[species_number - 1]);
         ship->status = UNDER_CONSTRUCTION;
         if (class == BA) {
             ship->type = STARBASE;
@@ -1090,7 +1066,7 @@ void do_BUILD_command(int continuing_construction, int interspecies_construction
         /* Make sure we don't notify the same species more than once. */
         for (i = 0; i < MAX_SPECIES; i++) { already_notified[i] = FALSE; }
 
-        for (i = 0; i < num_transactions; i++) {
+        for (i = transactionFirstTo(species_number, BESIEGE_PLANET); i >= 0; i = transactionNextTo(i, BESIEGE_PLANET)) {
             /* Find out who is besieging this planet. */
             if (transaction[i].type != BESIEGE_PLANET) { continue; }
             if (transaction[i].x != nampla->x) { continue; }
@@ -1104,12 +1080,7 @@ void do_BUILD_command(int continuing_construction, int interspecies_construction
             if (already_notified[alien_number - 1]) { continue; }
 
             /* Define a 'detection' transaction. */
-            if (num_transactions == MAX_TRANSACTIONS) {
-                fprintf(stderr, "\n\n\tERROR! num_transactions > MAX_TRANSACTIONS!\n\n");
-                exit(-1);
-            }
-
-            n = num_transactions++;
+            n = transactionAdd();
             transaction[n].type = DETECTION_DURING_SIEGE;
             transaction[n].value = 2;    /* Construction of ship/starbase. */
             strcpy(transaction[n].name1, nampla->name);
@@ -1147,47 +1118,19 @@ void do_BUILD_command(int continuing_construction, int interspecies_construction
         if (ship->remaining_cost == 0) {
             ship->status = ON_SURFACE;    /* Construction is complete. */
             if (continuing_construction) {
-                if (first_pass && siege_effectiveness > 0) {
-                    log_string("An attempt will be made to finish construction on ");
-                } else {
-                    log_string("Construction finished on ");
-                }
+                log_string("Construction finished on ");
                 log_string(ship_name(ship));
-                if (first_pass && siege_effectiveness > 0) {
-                    log_string(" despite the siege");
-                }
             } else {
-                if (first_pass && siege_effectiveness > 0) {
-                    log_string("An attempt will be made to construct ");
-                }
                 log_string(ship_name(ship));
-                if (first_pass && siege_effectiveness > 0) {
-                    log_string(" despite the siege");
-                } else {
-                    log_string(" was constructed");
-                }
+                log_string(" was constructed");
             }
         } else {
             if (continuing_construction) {
-                if (first_pass && siege_effectiveness > 0) {
-                    log_string("An attempt will be made to continue construction on ");
-                } else {
-                    log_string("Construction continued on ");
-                }
+                log_string("Construction continued on ");
                 log_string(ship_name(ship));
-                if (first_pass && siege_effectiveness > 0) {
-                    log_string(" despite the siege");
-                }
             } else {
-                if (first_pass && siege_effectiveness > 0) {
-                    log_string("An attempt will be made to start construction on ");
-                } else {
-                    log_string("Construction started on ");
-                }
+                log_string("Construction started on ");
                 log_string(ship_name(ship));
-                if (first_pass && siege_effectiveness > 0) {
-                    log_string(" despite the siege");
-                }
             }
         }
     }
@@ -1202,18 +1145,17 @@ void do_BUILD_command(int continuing_construction, int interspecies_construction
     log_char('.');
 
     if (new_ship && (!unused_ship_available)) {
-        ++num_new_ships[species_index];
         ++species->num_ships;
     }
 
     /* Check if planet is under siege and if construction was detected. */
-    if (!first_pass && rnd(100) <= siege_effectiveness) {
+    if (rnd(100) <= siege_effectiveness) {
         log_string(" However, the work was detected by the besiegers and the ship was destroyed!!!");
 
         /* Make sure we don't notify the same species more than once. */
         for (i = 0; i < MAX_SPECIES; i++) { already_notified[i] = FALSE; }
 
-        for (i = 0; i < num_transactions; i++) {
+        for (i = transactionFirstTo(species_number, BESIEGE_PLANET); i >= 0; i = transactionNextTo(i, BESIEGE_PLANET)) {
             /* Find out who is besieging this planet. */
             if (transaction[i].type != BESIEGE_PLANET) { continue; }
             if (transaction[i].x != nampla->x) { continue; }
@@ -1227,12 +1169,7 @@ void do_BUILD_command(int continuing_construction, int interspecies_construction
             if (already_notified[alien_number - 1]) { continue; }
 
             /* Define a 'detection' transaction. */
-            if (num_transactions == MAX_TRANSACTIONS) {
-                fprintf(stderr, "\n\n\tERROR! num_transactions > MAX_TRANSACTIONS!\n\n");
-                exit(-1);
-            }
-
-            n = num_transactions++;
+            n = transactionAdd();
             transaction[n].type = DETECTION_DURING_SIEGE;
             transaction[n].value = 2;    /* Construction of ship/starbase. */
             strcpy(transaction[n].name1, nampla->name);
@@ -1277,14 +1214,8 @@ void do_BUILD_command(int continuing_construction, int interspecies_construction
     }
 
     if (!unused_ship_available) {
-        /* Make sure we have enough memory for new ship. */
-        if (num_new_ships[g_spec_number - 1] == NUM_EXTRA_SHIPS) {
-            fprintf(stderr, "\n\n\tInsufficient memory for new recipient ship!\n\n");
-            exit(-1);
-        }
-        recipient_ship = ship_data[g_spec_number - 1] + (int) recipient_species->num_ships;
+        recipient_ship = speciesReserveShip(g_spec_number - 1);
         ++recipient_species->num_ships;
-        ++num_new_ships[g_spec_number - 1];
     }
 
     /* Copy donor ship to recipient ship. */
@@ -1295,21 +1226,16 @@ void do_BUILD_command(int continuing_construction, int interspecies_construction
     }
 
     recipient_ship->status = IN_ORBIT;
+    sectorPlaceShip(g_spec_number - 1, recipient_ship - ship_data[g_spec_number - 1]);
+    nameIndexPlaceShip(g_spec_number - 1, recipient_ship - ship_data[g_spec_number - 1]);
 
     data_modified[g_spec_number - 1] = TRUE;
 
     /* Delete donor ship. */
     delete_ship(ship);
 
-    if (first_pass) { return; }
-
     /* Define transaction so that recipient will be notified. */
-    if (num_transactions == MAX_TRANSACTIONS) {
-        fprintf(stderr, "\n\n\tERROR! num_transactions > MAX_TRANSACTIONS!\n\n");
-        exit(-1);
-    }
-
-    n = num_transactions++;
+    n = transactionAdd();
     transaction[n].type = INTERSPECIES_CONSTRUCTION;
     transaction[n].donor = species_number;
     transaction[n].recipient = g_spec_number;
@@ -1387,10 +1313,6 @@ void do_DESTROY_command(void) {
     /* Log result. */
     log_string("    ");
     log_string(ship_name(ship));
-    if (first_pass) {
-        log_string(" will be destroyed.\n");
-        return;
-    }
     log_string(" was destroyed.\n");
     delete_ship(ship);
 }
@@ -1918,16 +1840,6 @@ void do_ESTIMATE_command(void) {
         return;
     }
 
-    /* Log the result. */
-    if (first_pass) {
-        log_string("    An estimate of the technology of SP ");
-        log_string(g_spec_name);
-        log_string(" was made at a cost of ");
-        log_long(cost);
-        log_string(".\n");
-        return;
-    }
-
     /* Make the estimates. */
     alien = &spec_data[g_spec_number - 1];
     for (i = 0; i < 6; i++) {
@@ -2217,8 +2129,6 @@ void do_INTERCEPT_command(void) {
     log_long(cost);
     log_string(".\n");
 
-    if (first_pass) { return; }
-
     /* Allocate funds. */
     for (i = 0; i < num_intercepts; i++) {
         if (nampla->x != intercept[i].x) { continue; }
@@ -2248,7 +2158,7 @@ void do_JUMP_command(int jumped_in_combat, int using_jump_portal) {
     int i, n, found, max_xyz, temp_x, temp_y, temp_z, difference;
     int status, mishap_gv;
 
-    long mishap_chance, success_chance;
+    long mishap_chance;
 
     char temp_string[32], *original_line_pointer;
 
@@ -2399,26 +2309,10 @@ void do_JUMP_command(int jumped_in_combat, int using_jump_portal) {
         mishap_age = ship->age;
         mishap_gv = species->tech_level[GV];
     }
-    mishap_chance = (100L * (long) (((x - ship->x) * (x - ship->x))
-                                    + ((y - ship->y) * (y - ship->y))
-                                    + ((z - ship->z) * (z - ship->z))))
-                    / (long) mishap_gv;
-
-    if (mishap_chance > 10000L) {
-        mishap_chance = 10000L;
-        goto start_jump;
-    }
-
-    /* Add aging effect. */
-    if (mishap_age > 0) {
-        success_chance = 10000L - mishap_chance;
-        success_chance -= (2L * (long) mishap_age * success_chance) / 100L;
-        if (success_chance < 0) { success_chance = 0; }
-        mishap_chance = 10000L - success_chance;
-    }
-
-
-    start_jump:
+    mishap_chance = mishapChance(((x - ship->x) * (x - ship->x))
+                                 + ((y - ship->y) * (y - ship->y))
+                                 + ((z - ship->z) * (z - ship->z)),
+                                 mishap_gv, mishap_age);
 
     log_string("    ");
     log_string(ship_name(ship));
@@ -2439,14 +2333,9 @@ void do_JUMP_command(int jumped_in_combat, int using_jump_portal) {
         log_string(" via jump portal ");
         log_string(jump_portal_name);
 
-        if (using_alien_portal && !first_pass) {
+        if (using_alien_portal) {
             /* Define this transaction. */
-            if (num_transactions == MAX_TRANSACTIONS) {
-                fprintf(stderr, "\n\n\tERROR! num_transactions > MAX_TRANSACTIONS!\n\n");
-                exit(-1);
-            }
-
-            n = num_transactions++;
+            n = transactionAdd();
             transaction[n].type = ALIEN_JUMP_PORTAL_USAGE;
             transaction[n].number1 = other_species_number;
             strcpy(transaction[n].name1, species->name);
@@ -2460,26 +2349,22 @@ void do_JUMP_command(int jumped_in_combat, int using_jump_portal) {
 
     jump_again:
 
-    if (first_pass || (rnd(10000) > mishap_chance)) {
+    if (rnd(10000) > mishap_chance) {
         ship->x = x;
         ship->y = y;
         ship->z = z;
+        sectorPlaceShip(species_number - 1, ship - ship_data[species_number - 1]);
         ship->pn = pn;
         ship->status = status;
 
-        if (!first_pass) { star_visited(x, y, z); }
+        star_visited(x, y, z);
 
         return;
     }
 
     /* Ship had a mishap. Check if it has any fail-safe jump units. */
     if (ship->item_quantity[FS] > 0) {
-        if (num_transactions == MAX_TRANSACTIONS) {
-            fprintf(stderr, "\n\n\tERROR! num_transactions > MAX_TRANSACTIONS in do_JUMP_command!\n\n");
-            exit(-1);
-        }
-
-        n = num_transactions++;
+        n = transactionAdd();
         transaction[n].type = SHIP_MISHAP;
         transaction[n].value = 4;    /* Use of one FS. */
         transaction[n].number1 = species_number;
@@ -2527,12 +2412,7 @@ void do_JUMP_command(int jumped_in_combat, int using_jump_portal) {
             goto try_again;
         }
 
-        if (num_transactions == MAX_TRANSACTIONS) {
-            fprintf(stderr, "\n\n\tERROR! num_transactions > MAX_TRANSACTIONS in do_JUMP_command!\n\n");
-            exit(-1);
-        }
-
-        n = num_transactions++;
+        n = transactionAdd();
         transaction[n].type = SHIP_MISHAP;
         transaction[n].value = 3;    /* Mis-jump. */
         transaction[n].number1 = species_number;
@@ -2544,6 +2424,7 @@ void do_JUMP_command(int jumped_in_combat, int using_jump_portal) {
         ship->x = temp_x;
         ship->y = temp_y;
         ship->z = temp_z;
+        sectorPlaceShip(species_number - 1, ship - ship_data[species_number - 1]);
         ship->pn = 0;
 
         ship->status = IN_DEEP_SPACE;
@@ -2556,12 +2437,7 @@ void do_JUMP_command(int jumped_in_combat, int using_jump_portal) {
     self_destruct:
 
     /* Ship self-destructed. */
-    if (num_transactions == MAX_TRANSACTIONS) {
-        fprintf(stderr, "\n\n\tERROR! num_transactions > MAX_TRANSACTIONS in do_JUMP_command!\n\n");
-        exit(-1);
-    }
-
-    n = num_transactions++;
+    n = transactionAdd();
     transaction[n].type = SHIP_MISHAP;
     transaction[n].value = 2;    /* Self-destruction. */
     transaction[n].number1 = species_number;
@@ -2708,13 +2584,8 @@ void do_LAND_command(void) {
                 log_string(".\n");
                 already_logged = TRUE;
                 nampla = alien_nampla;
-                if (first_pass) { break; }
                 /* Define a 'landing request' transaction. */
-                if (num_transactions == MAX_TRANSACTIONS) {
-                    fprintf(stderr, "\n\n\tERROR! num_transactions > MAX_TRANSACTIONS!\n\n");
-                    exit(-1);
-                }
-                n = num_transactions++;
+                n = transactionAdd();
                 transaction[n].type = LANDING_REQUEST;
                 transaction[n].value = landed;
                 transaction[n].number1 = alien_index + 1;
@@ -2767,64 +2638,50 @@ void do_LAND_command(void) {
     log_string(ship_name(ship));
 
     if (nampla->siege_eff != 0) {
-        if (first_pass) {
-            log_string(" will attempt to land on PL ");
-            log_string(nampla->name);
-            log_string(" in spite of the siege");
+        if (nampla->siege_eff < 0) {
+            siege_effectiveness = -nampla->siege_eff;
         } else {
-            if (nampla->siege_eff < 0) {
-                siege_effectiveness = -nampla->siege_eff;
-            } else {
-                siege_effectiveness = nampla->siege_eff;
-            }
-            landing_detected = FALSE;
-            if (rnd(100) <= siege_effectiveness) {
-                landing_detected = TRUE;
-                for (i = 0; i < num_transactions; i++) {
-                    /* Find out who is besieging this planet. */
-                    if (transaction[i].type != BESIEGE_PLANET) { continue; }
-                    if (transaction[i].x != nampla->x) { continue; }
-                    if (transaction[i].y != nampla->y) { continue; }
-                    if (transaction[i].z != nampla->z) { continue; }
-                    if (transaction[i].pn != nampla->pn) { continue; }
-                    if (transaction[i].number2 != species_number) { continue; }
-                    alien_number = transaction[i].number1;
-                    /* Define a 'detection' transaction. */
-                    if (num_transactions == MAX_TRANSACTIONS) {
-                        fprintf(stderr, "\n\n\tERROR! num_transactions > MAX_TRANSACTIONS!\n\n");
-                        exit(-1);
-                    }
-                    n = num_transactions++;
-                    transaction[n].type = DETECTION_DURING_SIEGE;
-                    transaction[n].value = 1;    /* Landing. */
-                    strcpy(transaction[n].name1, nampla->name);
-                    strcpy(transaction[n].name2, ship_name(ship));
-                    strcpy(transaction[n].name3, species->name);
-                    transaction[n].number3 = alien_number;
-                }
+            siege_effectiveness = nampla->siege_eff;
+        }
+        landing_detected = FALSE;
+        if (rnd(100) <= siege_effectiveness) {
+            landing_detected = TRUE;
+            for (i = transactionFirstTo(species_number, BESIEGE_PLANET); i >= 0; i = transactionNextTo(i, BESIEGE_PLANET)) {
+                /* Find out who is besieging this planet. */
+                if (transaction[i].type != BESIEGE_PLANET) { continue; }
+                if (transaction[i].x != nampla->x) { continue; }
+                if (transaction[i].y != nampla->y) { continue; }
+                if (transaction[i].z != nampla->z) { continue; }
+                if (transaction[i].pn != nampla->pn) { continue; }
+                if (transaction[i].number2 != species_number) { continue; }
+                alien_number = transaction[i].number1;
+                /* Define a 'detection' transaction. */
+                n = transactionAdd();
+                transaction[n].type = DETECTION_DURING_SIEGE;
+                transaction[n].value = 1;    /* Landing. */
+                strcpy(transaction[n].name1, nampla->name);
+                strcpy(transaction[n].name2, ship_name(ship));
+                strcpy(transaction[n].name3, species->name);
+                transaction[n].number3 = alien_number;
             }
-            if (rnd(100) <= siege_effectiveness) {
-                /* Ship doesn't know if it was detected. */
-                log_string(" may have been detected by the besiegers when it landed on PL ");
+        }
+        if (rnd(100) <= siege_effectiveness) {
+            /* Ship doesn't know if it was detected. */
+            log_string(" may have been detected by the besiegers when it landed on PL ");
+            log_string(nampla->name);
+        } else {
+            /* Ship knows whether or not it was detected. */
+            if (landing_detected) {
+                log_string(" was detected by the besiegers when it landed on PL ");
                 log_string(nampla->name);
             } else {
-                /* Ship knows whether or not it was detected. */
-                if (landing_detected) {
-                    log_string(" was detected by the besiegers when it landed on PL ");
-                    log_string(nampla->name);
-                } else {
-                    log_string(" landed on PL ");
-                    log_string(nampla->name);
-                    log_string(" without being detected by the besiegers");
-                }
+                log_string(" landed on PL ");
+                log_string(nampla->name);
+                log_string(" without being detected by the besiegers");
             }
         }
     } else {
-        if (first_pass) {
-            log_string(" will land on PL ");
-        } else {
-            log_string(" landed on PL ");
-        }
+        log_string(" landed on PL ");
         log_string(nampla->name);
     }
     log_string(".\n");
@@ -2848,7 +2705,7 @@ void do_MESSAGE_command(void) {
     }
 
     /* Generate a random number, create a filename with it, and use it to store message. */
-    if (!first_pass && !bad_species) {
+    if (!bad_species) {
         while (1) {
             struct stat sb;
             /* Generate a random filename. */
@@ -2867,13 +2724,14 @@ void do_MESSAGE_command(void) {
             fprintf(stderr, "\n\n!!! Cannot open message file '%s' for writing !!!\n\n", filename);
             exit(-1);
         }
+        snapshotFileCreated(filename);
     }
 
     /* Copy message to file. */
     unterminated_message = FALSE;
     while (1) {
         /* Read next line. */
-        input_line_pointer = readln(input_line, 256, input_file);
+        input_line_pointer = ordersReadln(input_line, 256);
         if (input_line_pointer == NULL) {
             unterminated_message = TRUE;
             end_of_file = TRUE;
@@ -2887,7 +2745,7 @@ void do_MESSAGE_command(void) {
         c2 = toupper(c2);
         c3 = toupper(c3);
         if (c1 == 'Z' && c2 == 'Z' && c3 == 'Z') { break; }
-        if (!first_pass && !bad_species) { fputs(input_line, message_file); }
+        if (!bad_species) { fputs(input_line, message_file); }
     }
 
     if (bad_species) { return; }
@@ -2903,17 +2761,10 @@ void do_MESSAGE_command(void) {
         log_string(" to be part of the message and will be ignored!\n");
     }
 
-    if (first_pass) { return; }
-
     fclose(message_file);
 
     /* Define this message transaction and add to list of transactions. */
-    if (num_transactions == MAX_TRANSACTIONS) {
-        fprintf(stderr, "\n\n\tERROR! num_transactions > MAX_TRANSACTIONS!\n\n");
-        exit(-1);
-    }
-
-    i = num_transactions++;
+    i = transactionAdd();
     transaction[i].type = MESSAGE_TO_SPECIES;
     transaction[i].value = message_number;
     transaction[i].number1 = species_number;
@@ -2998,20 +2849,17 @@ void do_MOVE_command(void) {
     ship->x = x;
     ship->y = y;
     ship->z = z;
+    sectorPlaceShip(species_number - 1, ship - ship_data[species_number - 1]);
     ship->pn = 0;
     ship->status = IN_DEEP_SPACE;
     ship->just_jumped = 50;
 
-    if (!first_pass) { star_visited(x, y, z); }
+    star_visited(x, y, z);
 
     /* Log result. */
     log_string("    ");
     log_string(ship_name(ship));
-    if (first_pass) {
-        log_string(" will move to sector ");
-    } else {
-        log_string(" moved to sector ");
-    }
+    log_string(" moved to sector ");
     log_int(x);
     log_char(' ');
     log_int(y);
@@ -3102,13 +2950,7 @@ void do_NAME_command(void) {
     if (unused_nampla_available) {
         nampla = unused_nampla;
     } else {
-        num_new_namplas[species_index]++;
-        if (num_new_namplas[species_index] > NUM_EXTRA_NAMPLAS) {
-            fprintf(stderr, "\n\n\tInsufficient memory for new planet name:\n");
-            fprintf(stderr, "\n\t%s\n", input_line);
-            exit(-1);
-        }
-        nampla = nampla_base + species->num_namplas;
+        nampla = speciesReserveNampla(species_index);
         species->num_namplas += 1;
         /* Set everything to zero. */
         delete_nampla(nampla);
@@ -3119,6 +2961,8 @@ void do_NAME_command(void) {
     nampla->x = x;
     nampla->y = y;
     nampla->z = z;
+    sectorPlaceNampla(species_number - 1, nampla - namp_data[species_number - 1]);
+    nameIndexPlaceNampla(species_number - 1, nampla - namp_data[species_number - 1]);
     nampla->pn = pn;
     nampla->status = COLONY;
     nampla->planet_index = star->planet_index + pn - 1;
@@ -3313,11 +3157,7 @@ void do_ORBIT_command(void) {
     /* Log result. */
     log_string("    ");
     log_string(ship_name(ship));
-    if (first_pass) {
-        log_string(" will enter orbit around ");
-    } else {
-        log_string(" entered orbit around ");
-    }
+    log_string(" entered orbit around ");
     if (specified_planet_number) {
         log_string("planet number ");
         log_int(specified_planet_number);
@@ -3358,8 +3198,6 @@ void do_PRODUCTION_command(int missing_production_order) {
             last_planet_produced = FALSE;
         }
 
-        /* Give gamemaster option to abort. */
-        if (first_pass) { gamemaster_abort_option(); }
         log_char('\n');
     }
 
@@ -3563,7 +3401,7 @@ void do_PRODUCTION_command(int missing_production_order) {
         EUs_available_for_siege = special_production;
         species->econ_units += special_production;
 
-        if (mining_colony && !first_pass) {
+        if (mining_colony) {
             planet->mining_difficulty += RMs_produced / 150;
             planet_data_modified = TRUE;
         }
@@ -3582,7 +3420,7 @@ void do_PRODUCTION_command(int missing_production_order) {
         pop_units_here[i] = 0;
     }
 
-    for (trans_index = 0; trans_index < num_transactions; trans_index++) {
+    for (trans_index = transactionFirstTo(species_number, BESIEGE_PLANET); trans_index >= 0; trans_index = transactionNextTo(trans_index, BESIEGE_PLANET)) {
         /* Check if this is a siege of this nampla. */
         if (transaction[trans_index].type != BESIEGE_PLANET) { continue; }
         if (transaction[trans_index].x != nampla->x) { continue; }
@@ -3690,7 +3528,7 @@ void do_PRODUCTION_command(int missing_production_order) {
 
         /* Determine the number of planets that this ship is besieging. */
         n = 0;
-        for (j = 0; j < num_transactions; j++) {
+        for (j = transactionFirstFrom(alien_number, BESIEGE_PLANET); j >= 0; j = transactionNextFrom(j, BESIEGE_PLANET)) {
             if (transaction[j].type != BESIEGE_PLANET) { continue; }
             if (transaction[j].number1 != alien_number) { continue; }
             if (strcmp(transaction[j].name3, alien_ship->name) != 0) { continue; }
@@ -3774,15 +3612,8 @@ void do_PRODUCTION_command(int missing_production_order) {
         log_string(alien->name);
         log_string(".\n");
 
-        if (first_pass) { continue; }
-
         /* Define this transaction and add to list of transactions. */
-        if (num_transactions == MAX_TRANSACTIONS) {
-            fprintf(stderr, "\n\n\tERROR! num_transactions > MAX_TRANSACTIONS!\n\n");
-            exit(-1);
-        }
-
-        trans_index = num_transactions++;
+        trans_index = transactionAdd();
         transaction[trans_index].type = SIEGE_EU_TRANSFER;
         transaction[trans_index].donor = species_number;
         transaction[trans_index].recipient = alien_number;
@@ -3820,7 +3651,7 @@ void do_PRODUCTION_command(int missing_production_order) {
             log_string("      ");
             log_string(ship_name(ship));
             log_string(", under construction when the siege began, was detected by the besiegers and destroyed!\n");
-            if (!first_pass) { delete_ship(ship); }
+            delete_ship(ship);
         }
     }
 
@@ -3862,15 +3693,8 @@ void do_PRODUCTION_command(int missing_production_order) {
 
         if (ib_for_this_species == 0 && ab_for_this_species == 0) { continue; }
 
-        if (first_pass) { continue; }
-
         /* Define this transaction and add to list of transactions. */
-        if (num_transactions == MAX_TRANSACTIONS) {
-            fprintf(stderr, "\n\n\tERROR! num_transactions > MAX_TRANSACTIONS!\n\n");
-            exit(-1);
-        }
-
-        trans_index = num_transactions++;
+        trans_index = transactionAdd();
         transaction[trans_index].type = ASSIMILATION;
         transaction[trans_index].value = alien_number;
         transaction[trans_index].x = nampla->x;
@@ -4405,14 +4229,6 @@ void do_SCAN_command(void) {
         return;
     }
 
-    /* Log the result. */
-    if (first_pass) {
-        log_string("    A scan will be done by ");
-        log_string(ship_name(ship));
-        log_string(".\n");
-        return;
-    }
-
     /* Write scan of ship's location to log file. */
     x = ship->x;
     y = ship->y;
@@ -4511,17 +4327,8 @@ void do_SEND_command(void) {
     log_string(".\n");
     species->econ_units -= item_count;
 
-    if (first_pass) {
-        return;
-    }
-
     /* Define this transaction. */
-    if (num_transactions == MAX_TRANSACTIONS) {
-        fprintf(stderr, "\n\n\tERROR! num_transactions > MAX_TRANSACTIONS!\n\n");
-        exit(-1);
-    }
-
-    n = num_transactions++;
+    n = transactionAdd();
     transaction[n].type = EU_TRANSFER;
     transaction[n].donor = species_number;
     transaction[n].recipient = g_spec_number;
@@ -4646,15 +4453,8 @@ void do_TEACH_command(void) {
         return;
     }
 
-    if (first_pass) { return; }
-
     /* Define this transaction and add to list of transactions. */
-    if (num_transactions == MAX_TRANSACTIONS) {
-        fprintf(stderr, "\n\n\tERROR! num_transactions > MAX_TRANSACTIONS!\n\n");
-        exit(-1);
-    }
-
-    i = num_transactions++;
+    i = transactionAdd();
     transaction[i].type = KNOWLEDGE_TRANSFER;
     transaction[i].donor = species_number;
     transaction[i].recipient = g_spec_number;
@@ -4744,15 +4544,8 @@ void do_TECH_command(void) {
     log_string(g_spec_name);
     log_string(".\n");
 
-    if (first_pass) { return; }
-
     /* Define this transaction and add to list of transactions. */
-    if (num_transactions == MAX_TRANSACTIONS) {
-        fprintf(stderr, "\n\n\tERROR! num_transactions > MAX_TRANSACTIONS!\n\n");
-        exit(-1);
-    }
-
-    i = num_transactions++;
+    i = transactionAdd();
     transaction[i].type = TECH_TRANSFER;
     transaction[i].donor = species_number;
     transaction[i].recipient = g_spec_number;
@@ -4769,9 +4562,11 @@ void do_TECH_command(void) {
 
 
 void do_TELESCOPE_command(void) {
-    int i, n, found, range_in_parsecs, max_range, alien_index, alien_number, alien_nampla_index, alien_ship_index, location_printed, industry, detection_chance, num_obs_locs, alien_name_printed, loc_index, success_chance, something_found;
+    int i, n, found, range_in_parsecs, max_range, alien_index, alien_number, location_printed, industry, detection_chance, num_obs_locs, alien_name_printed, loc_index, success_chance, something_found, sector_index;
     long x, y, z, max_distance, max_distance_squared, delta_x, delta_y, delta_z, distance_squared;
     char planet_type[32], obs_x[MAX_OBS_LOCS], obs_y[MAX_OBS_LOCS], obs_z[MAX_OBS_LOCS];
+    uint64_t key, obs_key, obs_keys[MAX_OBS_LOCS];
+    sector_t *sector;
     struct species_data *alien;
     struct nampla_data *alien_nampla;
     struct ship_data *starbase, *alien_ship;
@@ -4803,20 +4598,6 @@ void do_TELESCOPE_command(void) {
         return;
     }
 
-    /* Log the result. */
-    if (first_pass) {
-        log_string("    A gravitic telescope at ");
-        log_int(starbase->x);
-        log_char(' ');
-        log_int(starbase->y);
-        log_char(' ');
-        log_int(starbase->z);
-        log_string(" will be operated by ");
-        log_string(ship_name(starbase));
-        log_string(".\n");
-        return;
-    }
-
     /* Define range parameters. */
     max_range = (int) species->tech_level[GV] / 10;
     if (range_in_parsecs > max_range) { range_in_parsecs = max_range; }
@@ -4828,93 +4609,77 @@ void do_TELESCOPE_command(void) {
     max_distance = range_in_parsecs;
     max_distance_squared = max_distance * max_distance;
 
-    /* First pass. Simply create a list of X Y Z locations that have observable aliens. */
+    /* First pass. Simply create a list of X Y Z locations that have observable aliens.
+     * A location is listed in the order its first observable alien colony or ship would be
+     * found by scanning every alien's colonies and then its ships. */
     num_obs_locs = 0;
-    for (alien_index = 0; alien_index < galaxy.num_species; alien_index++) {
-        if (!data_in_memory[alien_index]) { continue; }
-
-        alien_number = alien_index + 1;
-        if (alien_number == species_number) { continue; }
+    for (sector_index = 0; sector_index < sectorCount(); sector_index++) {
+        sector = sectorByIndex(sector_index);
 
-        alien = &spec_data[alien_index];
+        delta_x = x - sector->x;
+        delta_y = y - sector->y;
+        delta_z = z - sector->z;
+        distance_squared = (delta_x * delta_x) + (delta_y * delta_y)
+                           + (delta_z * delta_z);
 
-        alien_nampla = namp_data[alien_index] - 1;
-        for (alien_nampla_index = 0; alien_nampla_index < alien->num_namplas;
-             alien_nampla_index++) {
-            ++alien_nampla;
+        if (distance_squared == 0) { continue; }  /* Same loc as telescope. */
+        if (distance_squared > max_distance_squared) { continue; }
 
-            if ((alien_nampla->status & POPULATED) == 0) { continue; }
-
-            delta_x = x - alien_nampla->x;
-            delta_y = y - alien_nampla->y;
-            delta_z = z - alien_nampla->z;
-            distance_squared = (delta_x * delta_x) + (delta_y * delta_y)
-                               + (delta_z * delta_z);
+        obs_key = UINT64_MAX;
 
-            if (distance_squared == 0) { continue; }  /* Same loc as telescope. */
-            if (distance_squared > max_distance_squared) { continue; }
+        for (i = 0; i < sector->num_namplas; i++) {
+            alien_index = sector->nampla[i].species_index;
+            if (!data_in_memory[alien_index]) { continue; }
+            if (alien_index + 1 == species_number) { continue; }
 
-            found = FALSE;
-            for (i = 0; i < num_obs_locs; i++) {
-                if (alien_nampla->x != obs_x[i]) { continue; }
-                if (alien_nampla->y != obs_y[i]) { continue; }
-                if (alien_nampla->z != obs_z[i]) { continue; }
+            alien_nampla = namp_data[alien_index] + sector->nampla[i].index;
 
-                found = TRUE;
-                break;
-            }
-            if (!found) {
-                if (num_obs_locs == MAX_OBS_LOCS) {
-                    fprintf(stderr, "\n\nInternal error! MAX_OBS_LOCS exceeded in do_TELESCOPE_command!\n\n");
-                    exit(-1);
-                }
-                obs_x[num_obs_locs] = alien_nampla->x;
-                obs_y[num_obs_locs] = alien_nampla->y;
-                obs_z[num_obs_locs] = alien_nampla->z;
+            if ((alien_nampla->status & POPULATED) == 0) { continue; }
+            if (alien_nampla->x != sector->x) { continue; }
+            if (alien_nampla->y != sector->y) { continue; }
+            if (alien_nampla->z != sector->z) { continue; }
 
-                ++num_obs_locs;
-            }
+            obs_key = ((uint64_t) (2 * alien_index) << 32) | (uint64_t) sector->nampla[i].index;
+            break;
         }
 
-        alien_ship = ship_data[alien_index] - 1;
-        for (alien_ship_index = 0; alien_ship_index < alien->num_ships;
-             alien_ship_index++) {
-            ++alien_ship;
+        for (i = 0; i < sector->num_ships; i++) {
+            alien_index = sector->ship[i].species_index;
+            if (!data_in_memory[alien_index]) { continue; }
+            if (alien_index + 1 == species_number) { continue; }
 
+            alien_ship = ship_data[alien_index] + sector->ship[i].index;
+
+            if (alien_ship->x != sector->x) { continue; }
+            if (alien_ship->y != sector->y) { continue; }
+            if (alien_ship->z != sector->z) { continue; }
             if (alien_ship->status == UNDER_CONSTRUCTION) { continue; }
             if (alien_ship->status == ON_SURFACE) { continue; }
             if (alien_ship->item_quantity[FD] == alien_ship->tonnage) { continue; }
 
-            delta_x = x - alien_ship->x;
-            delta_y = y - alien_ship->y;
-            delta_z = z - alien_ship->z;
-            distance_squared = (delta_x * delta_x) + (delta_y * delta_y)
-                               + (delta_z * delta_z);
-
-            if (distance_squared == 0) { continue; }  /* Same loc as telescope. */
-            if (distance_squared > max_distance_squared) { continue; }
-
-            found = FALSE;
-            for (i = 0; i < num_obs_locs; i++) {
-                if (alien_ship->x != obs_x[i]) { continue; }
-                if (alien_ship->y != obs_y[i]) { continue; }
-                if (alien_ship->z != obs_z[i]) { continue; }
+            key = ((uint64_t) (2 * alien_index + 1) << 32) | (uint64_t) sector->ship[i].index;
+            if (key < obs_key) { obs_key = key; }
+            break;
+        }
 
-                found = TRUE;
-                break;
-            }
-            if (!found) {
-                if (num_obs_locs == MAX_OBS_LOCS) {
-                    fprintf(stderr, "\n\nInternal error! MAX_OBS_LOCS exceeded in do_TELESCOPE_command!\n\n");
-                    exit(-1);
-                }
-                obs_x[num_obs_locs] = alien_ship->x;
-                obs_y[num_obs_locs] = alien_ship->y;
-                obs_z[num_obs_locs] = alien_ship->z;
+        if (obs_key == UINT64_MAX) { continue; }
 
-                ++num_obs_locs;
-            }
+        if (num_obs_locs == MAX_OBS_LOCS) {
+            fprintf(stderr, "\n\nInternal error! MAX_OBS_LOCS exceeded in do_TELESCOPE_command!\n\n");
+            exit(-1);
+        }
+        for (i = num_obs_locs; i > 0 && obs_keys[i - 1] > obs_key; i--) {
+            obs_keys[i] = obs_keys[i - 1];
+            obs_x[i] = obs_x[i - 1];
+            obs_y[i] = obs_y[i - 1];
+            obs_z[i] = obs_z[i - 1];
         }
+        obs_keys[i] = obs_key;
+        obs_x[i] = sector->x;
+        obs_y[i] = sector->y;
+        obs_z[i] = sector->z;
+
+        ++num_obs_locs;
     }
 
     /* Operate the gravitic telescope. */
@@ -4939,6 +4704,8 @@ void do_TELESCOPE_command(void) {
 
         location_printed = FALSE;
 
+        sector = sectorAt(x, y, z);
+
         for (alien_index = 0; alien_index < galaxy.num_species; alien_index++) {
             if (!data_in_memory[alien_index]) { continue; }
 
@@ -4949,10 +4716,9 @@ void do_TELESCOPE_command(void) {
 
             alien_name_printed = FALSE;
 
-            alien_nampla = namp_data[alien_index] - 1;
-            for (alien_nampla_index = 0; alien_nampla_index < alien->num_namplas;
-                 alien_nampla_index++) {
-                ++alien_nampla;
+            for (i = 0; i < sector->num_namplas; i++) {
+                if (sector->nampla[i].species_index != alien_index) { continue; }
+                alien_nampla = namp_data[alien_index] + sector->nampla[i].index;
 
                 if ((alien_nampla->status & POPULATED) == 0) { continue; }
                 if (alien_nampla->x != x) { continue; }
@@ -5000,10 +4766,9 @@ void do_TELESCOPE_command(void) {
                         alien_nampla->pn, planet_type, alien_nampla->name, industry);
             }
 
-            alien_ship = ship_data[alien_index] - 1;
-            for (alien_ship_index = 0; alien_ship_index < alien->num_ships;
-                 alien_ship_index++) {
-                ++alien_ship;
+            for (i = 0; i < sector->num_ships; i++) {
+                if (sector->ship[i].species_index != alien_index) { continue; }
+                alien_ship = ship_data[alien_index] + sector->ship[i].index;
 
                 if (alien_ship->x != x) { continue; }
                 if (alien_ship->y != y) { continue; }
@@ -5054,12 +4819,7 @@ void do_TELESCOPE_command(void) {
                 if (rnd(100) > detection_chance) { continue; }
 
                 /* Define this transaction. */
-                if (num_transactions == MAX_TRANSACTIONS) {
-                    fprintf(stderr, "\n\n\tERROR! num_transactions > MAX_TRANSACTIONS!\n\n");
-                    exit(-1);
-                }
-
-                n = num_transactions++;
+                n = transactionAdd();
                 transaction[n].type = TELESCOPE_DETECTION;
                 transaction[n].x = starbase->x;
                 transaction[n].y = starbase->y;
@@ -5569,23 +5329,14 @@ void do_TRANSFER_command(void) {
     /* Make the transfer and log the result. */
     log_string("    ");
 
-    if (attempt_during_siege && first_pass) {
-        log_string("An attempt will be made to transfer ");
-    }
-
     log_int(item_count);
     log_char(' ');
     log_string(item_name[item_class]);
 
-    if (attempt_during_siege && first_pass) {
-        if (item_count > 1) { log_char('s'); }
-        log_char(' ');
+    if (item_count > 1) {
+        log_string("s were transferred from ");
     } else {
-        if (item_count > 1) {
-            log_string("s were transferred from ");
-        } else {
-            log_string(" was transferred from ");
-        }
+        log_string(" was transferred from ");
     }
 
     switch (transfer_type) {
@@ -5635,8 +5386,6 @@ void do_TRANSFER_command(void) {
             if (attempt_during_siege) { log_string(" despite the siege"); }
             log_char('.');
 
-            if (first_pass) { break; }
-
             /* Check if either planet is under siege and if transfer
                 was detected by the besiegers. */
             if (rnd(100) > siege_1_chance && rnd(100) > siege_2_chance) {
@@ -5648,7 +5397,7 @@ void do_TRANSFER_command(void) {
 
             for (i = 0; i < MAX_SPECIES; i++) { already_notified[i] = FALSE; }
 
-            for (i = 0; i < num_transactions; i++) {
+            for (i = transactionFirstTo(species_number, BESIEGE_PLANET); i >= 0; i = transactionNextTo(i, BESIEGE_PLANET)) {
                 /* Find out who is besieging this planet. */
                 if (transaction[i].type != BESIEGE_PLANET) { continue; }
                 if (transaction[i].x != nampla->x) { continue; }
@@ -5662,12 +5411,7 @@ void do_TRANSFER_command(void) {
                 if (already_notified[alien_number - 1]) { continue; }
 
                 /* Define a 'detection' transaction. */
-                if (num_transactions == MAX_TRANSACTIONS) {
-                    fprintf(stderr, "\n\n\tERROR! num_transactions > MAX_TRANSACTIONS!\n\n");
-                    exit(-1);
-                }
-
-                n = num_transactions++;
+                n = transactionAdd();
                 transaction[n].type = DETECTION_DURING_SIEGE;
                 transaction[n].value = 4;    /* Transfer of items. */
                 transaction[n].number1 = item_count;
@@ -6122,7 +5866,8 @@ void do_WORMHOLE_command(void) {
     ship->x = star->worm_x;
     ship->y = star->worm_y;
     ship->z = star->worm_z;
+    sectorPlaceShip(species_number - 1, ship - ship_data[species_number - 1]);
     ship->just_jumped = 99;    /* 99 indicates that a wormhole was used. */
 
-    if (!first_pass) { star_visited(ship->x, ship->y, ship->z); }
+    star_visited(ship->x, ship->y, ship->z);
 }
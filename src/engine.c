@@ -21,6 +21,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
+#include "arena.h"
 #include "engine.h"
 #include "enginevars.h"
 #include "prng.h"
@@ -77,7 +78,7 @@ int agrep_score(char *correct_string, char *unknown_string) {
 
 /* This routine is intended to take a long argument and return a pointer to a string that has embedded commas to make the string more readable. */
 char *commas(long value) {
-    static char result_plus_commas[33];
+    static THREAD_LOCAL char result_plus_commas[33];
     int i, j, n, length, negative;
     char temp[32];
     long abs_value;
@@ -113,18 +114,6 @@ char *commas(long value) {
 }
 
 
-/* Give the gamemaster a chance to abort. */
-void gamemaster_abort_option(void) {
-    char answer[16];
-    printf("*** Gamemaster safe-abort option ... type q or Q to quit: ");
-    fflush(stdout);
-    fgets(answer, 16, stdin);
-    if (answer[0] == 'q' || answer[0] == 'Q') {
-        exit(0);
-    }
-}
-
-
 // logRandomCommand generates random numbers using the historical default seed value.
 int logRandomCommand(int argc, char *argv[]) {
     // use the historical default seed value
@@ -144,7 +133,12 @@ int logRandomCommand(int argc, char *argv[]) {
 }
 
 
+// ncalloc is calloc that exits if the memory can not be had.
+// The call site is counted when allocation statistics are on.
 void *ncalloc(const char *fn, int line, int count, int size) {
+    if (alloc_stats) {
+        allocStatsRecord(fn, line, (size_t) count * (size_t) size, FALSE);
+    }
     void *p = calloc(count, size);
     if (p == NULL) {
         char msg[256];
@@ -158,7 +152,7 @@ void *ncalloc(const char *fn, int line, int count, int size) {
 
 // readln is a helper for command parsing that coerces all line-endings to be just '\n'.
 char *readln(char *dst, int len, FILE *fp) {
-    static char buf[1024];
+    static THREAD_LOCAL char buf[1024];
     char *p;
     int i;
     p = fgets(buf, 1024, fp);
@@ -25,6 +25,10 @@
 #include "const.h"
 #include "item.h"
 
+// THREAD_LOCAL marks a global that each thread gets its own copy of.
+// Battles are fought on worker threads, so the globals they use are marked with it.
+#define THREAD_LOCAL _Thread_local
+
 
 struct galaxy_data {
     int d_num_species; /* Design number of species in galaxy. */
@@ -325,8 +329,6 @@ int agrep_score(char *correct_string, char *unknown_string);
 
 char *commas(long value);
 
-void gamemaster_abort_option(void);
-
 int logRandomCommand(int argc, char *argv[]);
 
 void *ncalloc(const char *fn, int line, int count, int size);
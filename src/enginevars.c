@@ -25,8 +25,6 @@ int correct_spelling_required = FALSE;
 
 const unsigned long defaultHistoricalSeedValue = 1924085713L;
 
-int first_pass = FALSE;
-
 int post_arrival_phase = FALSE;
 
 int prompt_gm;
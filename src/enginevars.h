@@ -24,7 +24,6 @@
 
 extern int correct_spelling_required;
 extern const unsigned long defaultHistoricalSeedValue;
-extern int first_pass;
 extern int post_arrival_phase;
 extern int prompt_gm;
 extern int test_mode;
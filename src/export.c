@@ -20,6 +20,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include "datafile.h"
 #include "export.h"
 #include "marshal.h"
 #include "galaxyio.h"
@@ -72,6 +73,10 @@ int exportCommand(int argc, char *argv[]) {
 int exportSpecies(int spNo) {
     char filename[128];
     sprintf(filename, "sp%02d.dat", spNo);
+    if (datafileIsV2(filename)) {
+        fprintf(stderr, "error: '%s' is a version 2 file, run 'fh convert v1' first\n", filename);
+        exit(2);
+    }
     FILE *fp = fopen(filename, "rb");
     if (fp == 0) {
         perror(filename);
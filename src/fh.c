@@ -20,7 +20,9 @@
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
+#include "arena.h"
 #include "combat.h"
+#include "convert.h"
 #include "create.h"
 #include "data.h"
 #include "enginevars.h"
@@ -35,6 +37,7 @@
 #include "predeparture.h"
 #include "production.h"
 #include "report.h"
+#include "runturn.h"
 #include "scan.h"
 #include "sexpr.h"
 #include "show.h"
@@ -61,8 +64,12 @@ int main(int argc, char *argv[]) {
             test_mode = TRUE;
         } else if (strcmp(argv[i], "-v") == 0) {
             verbose_mode = TRUE;
+        } else if (strcmp(argv[i], "--alloc-stats") == 0) {
+            allocStatsEnable();
         } else if (strcmp(argv[i], "combat") == 0) {
             return combatCommand(argc - i, argv + i);
+        } else if (strcmp(argv[i], "convert") == 0) {
+            return convertCommand(argc - i, argv + i);
         } else if (strcmp(argv[i], "create") == 0) {
             return createCommand(argc - i, argv + i);
         } else if (strcmp(argv[i], "export") == 0) {
@@ -70,7 +77,7 @@ int main(int argc, char *argv[]) {
         } else if (strcmp(argv[i], "finish") == 0) {
             return finishCommand(argc - i, argv + i);
         } else if (strcmp(argv[i], "import") == 0) {
-            return importCommand(argc - 1, argv + 1);
+            return importCommand(argc - i, argv + i);
         } else if (strcmp(argv[i], "inspect") == 0) {
             printf("inspect: sizeof(int)                   == %5d\n", (int) sizeof(int));
             printf("inspect: sizeof(long)                  == %5d\n", (int) sizeof(long));
@@ -106,6 +113,8 @@ int main(int argc, char *argv[]) {
             return productionCommand(argc - i, argv + i);
         } else if (strcmp(argv[i], "report") == 0) {
             return reportCommand(argc - i, argv + i);
+        } else if (strcmp(argv[i], "run-turn") == 0) {
+            return runTurnCommand(argc - i, argv + i);
         } else if (strcmp(argv[i], "scan") == 0) {
             return scanCommand(argc - i, argv + i);
         } else if (strcmp(argv[i], "scan-near") == 0) {
@@ -121,7 +130,7 @@ int main(int argc, char *argv[]) {
         } else if (strcmp(argv[i], "update") == 0) {
             return updateCommand(argc - i, argv + i);
         } else if (strcmp(argv[i], "version") == 0) {
-            return versionCommand(argc - 1, argv+1);
+            return versionCommand(argc - i, argv + i);
         } else {
             fprintf(stderr, "fh: unknown option '%s'\n", argv[i]);
             return 2;
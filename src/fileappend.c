@@ -0,0 +1,131 @@
+// Far Horizons Game Engine
+// Copyright (C) 2022 Michael D Henderson
+// Copyright (C) 2021 Raven Zachary
+// Copyright (C) 2019 Casey Link, Adam Piggott
+// Copyright (C) 1999 Richard A. Morneau
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#define _GNU_SOURCE  // copy_file_range
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+#include "engine.h"
+#include "fileappend.h"
+
+
+static size_t fileAppendCopy(FILE *dst, int fd, size_t length);
+
+static void fileAppendText(FILE *dst, const char *text, size_t length);
+
+
+// fileAppend appends the file, from its start, to dst.
+// The file is mapped rather than read. If it has no carriage returns and dst is backed by a file,
+// the kernel copies the bytes; otherwise they are written through dst, fixing the line endings.
+void fileAppend(FILE *dst, int fd, const char *filename) {
+    struct stat sb;
+    if (fstat(fd, &sb) != 0) {
+        perror("fileAppend");
+        fprintf(stderr, "\n\tCannot stat file '%s'!\n\n", filename);
+        exit(2);
+    }
+    size_t length = (size_t) sb.st_size;
+    if (length == 0) {
+        return;
+    }
+
+    char *text = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (text == MAP_FAILED) {
+        // fall back to reading the file in one block
+        text = ncalloc(__FUNCTION__, __LINE__, length, 1);
+        size_t have = 0;
+        while (have < length) {
+            ssize_t n = pread(fd, text + have, length - have, (off_t) have);
+            if (n < 0) {
+                perror("fileAppend");
+                fprintf(stderr, "\n\tCannot read file '%s'!\n\n", filename);
+                exit(2);
+            } else if (n == 0) {
+                break;  // the file shrank
+            }
+            have += (size_t) n;
+        }
+        fileAppendText(dst, text, have);
+        free(text);
+        return;
+    }
+
+    if (memchr(text, '\r', length) != NULL) {
+        fileAppendText(dst, text, length);
+    } else {
+        size_t copied = fileAppendCopy(dst, fd, length);
+        if (copied < length) {
+            fwrite(text + copied, 1, length - copied, dst);
+        }
+    }
+    munmap(text, length);
+}
+
+
+// fileAppendCopy has the kernel copy the file to the file behind dst and returns the number of bytes copied.
+// It copies nothing if dst is not backed by a file (a memory stream, say) or the kernel can not do the copy.
+static size_t fileAppendCopy(FILE *dst, int fd, size_t length) {
+    size_t copied = 0;
+#ifdef __linux__
+    int out = fileno(dst);
+    if (out < 0 || fflush(dst) != 0) {
+        return 0;
+    }
+    while (copied < length) {
+        loff_t in_offset = (loff_t) copied;
+        ssize_t n = copy_file_range(fd, &in_offset, out, NULL, length - copied, 0);
+        if (n <= 0) {
+            // older kernels can not copy between file systems, but sendfile can
+            off_t offset = (off_t) copied;
+            n = sendfile(out, fd, &offset, length - copied);
+        }
+        if (n <= 0) {
+            break;
+        }
+        copied += (size_t) n;
+    }
+#endif
+    return copied;
+}
+
+
+// fileAppendText writes the text to dst, turning CR LF and lone CR line endings into LF.
+static void fileAppendText(FILE *dst, const char *text, size_t length) {
+    const char *end = text + length;
+    while (text < end) {
+        const char *cr = memchr(text, '\r', (size_t) (end - text));
+        if (cr == NULL) {
+            fwrite(text, 1, (size_t) (end - text), dst);
+            break;
+        }
+        fwrite(text, 1, (size_t) (cr - text), dst);
+        putc('\n', dst);
+        text = cr + 1;
+        if (text < end && *text == '\n') {
+            text++;
+        }
+    }
+}
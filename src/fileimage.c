@@ -0,0 +1,193 @@
+// Far Horizons Game Engine
+// Copyright (C) 2022 Michael D Henderson
+// Copyright (C) 2021 Raven Zachary
+// Copyright (C) 2019 Casey Link, Adam Piggott
+// Copyright (C) 1999 Richard A. Morneau
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "engine.h"
+#include "fileimage.h"
+
+
+// the run of changed records that has not been written yet
+typedef struct {
+    int fd;
+    const char *filename;
+    const unsigned char *data;
+    size_t length;
+    const file_image_t *image;  // NULL if every record must be written
+    int inRun;
+    size_t runStart;
+} write_run_t;
+
+
+static void checkRecord(write_run_t *run, size_t start, size_t end);
+
+static int sameFile(const struct stat *a, const struct stat *b);
+
+
+// fileImageOpen reads the whole file into the image and returns a stream over
+// those bytes, so the usual fread code can parse it.
+// Returns NULL if the file can not be opened.
+FILE *fileImageOpen(file_image_t *fi, const char *filename) {
+    fileImageForget(fi);
+
+    FILE *fp = fopen(filename, "rb");
+    if (fp == NULL) {
+        return NULL;
+    }
+    struct stat sb;
+    if (fstat(fileno(fp), &sb) != 0) {
+        perror("fileImageOpen");
+        fprintf(stderr, "\n\tCannot stat file '%s'!\n", filename);
+        exit(2);
+    }
+    if (sb.st_size == 0) {
+        // nothing to remember, and fmemopen does not like empty buffers
+        return fp;
+    }
+    fi->data = (unsigned char *) ncalloc(__FUNCTION__, __LINE__, (int) sb.st_size, 1);
+    if (fread(fi->data, (size_t) sb.st_size, 1, fp) != 1) {
+        perror("fileImageOpen");
+        fprintf(stderr, "\n\tCannot read file '%s' into memory!\n", filename);
+        exit(2);
+    }
+    fclose(fp);
+    fi->length = (size_t) sb.st_size;
+    fi->sb = sb;
+
+    fp = fmemopen(fi->data, fi->length, "rb");
+    if (fp == NULL) {
+        perror("fileImageOpen");
+        fprintf(stderr, "\n\tCannot open memory stream for file '%s'!\n", filename);
+        exit(2);
+    }
+    return fp;
+}
+
+
+// fileImageRemember saves a copy of bytes that were loaded from the file some other way.
+void fileImageRemember(file_image_t *fi, const char *filename, const void *data, size_t length) {
+    fileImageForget(fi);
+    if (stat(filename, &fi->sb) != 0 || (size_t) fi->sb.st_size != length || length == 0) {
+        return;
+    }
+    fi->data = (unsigned char *) ncalloc(__FUNCTION__, __LINE__, (int) length, 1);
+    memcpy(fi->data, data, length);
+    fi->length = length;
+}
+
+
+void fileImageForget(file_image_t *fi) {
+    free(fi->data);
+    memset(fi, 0, sizeof(file_image_t));
+}
+
+
+// fileImageWrite makes the file hold exactly `data`.
+// If the file is still the one the image came from, only the records that
+// differ from the image are written. Bytes outside the sections (headers and
+// padding) are treated as one record per gap.
+// Otherwise, or when there is no image, everything is written.
+// Sections must be in file order. fi may be NULL.
+void fileImageWrite(file_image_t *fi, const char *filename, const void *data, size_t length, int numSections, const file_records_t sections[]) {
+    const unsigned char *bytes = (const unsigned char *) data;
+
+    int fd = open(filename, O_WRONLY | O_CREAT, 0666);
+    if (fd < 0) {
+        perror("fileImageWrite");
+        fprintf(stderr, "\n\tCannot create file '%s'!\n", filename);
+        exit(2);
+    }
+    struct stat sb;
+    if (fstat(fd, &sb) != 0) {
+        perror("fileImageWrite");
+        fprintf(stderr, "\n\tCannot stat file '%s'!\n", filename);
+        exit(2);
+    }
+    int haveImage = fi != NULL && fi->data != NULL && sameFile(&fi->sb, &sb);
+
+    // walk the file one record at a time, collecting runs of changed records
+    write_run_t run = {fd, filename, bytes, length, haveImage ? fi : NULL, FALSE, 0};
+    size_t pos = 0;
+    for (int s = 0; s <= numSections; s++) {
+        // the gap before a section, or after the last one, counts as one record
+        size_t gapEnd = s < numSections ? sections[s].offset : length;
+        if (gapEnd > pos) {
+            checkRecord(&run, pos, gapEnd);
+            pos = gapEnd;
+        }
+        for (int r = 0; s < numSections && r < sections[s].num_records; r++) {
+            checkRecord(&run, pos, pos + (size_t) sections[s].record_size);
+            pos += (size_t) sections[s].record_size;
+        }
+    }
+    checkRecord(&run, length, length);
+
+    if ((size_t) sb.st_size > length && ftruncate(fd, (off_t) length) != 0) {
+        perror("fileImageWrite");
+        fprintf(stderr, "\n\tCannot truncate file '%s'!\n", filename);
+        exit(2);
+    }
+
+    if (fi != NULL) {
+        fileImageForget(fi);
+        if (length > 0 && fstat(fd, &fi->sb) == 0) {
+            fi->data = (unsigned char *) ncalloc(__FUNCTION__, __LINE__, (int) length, 1);
+            memcpy(fi->data, bytes, length);
+            fi->length = length;
+        }
+    }
+    close(fd);
+}
+
+
+static int sameFile(const struct stat *a, const struct stat *b) {
+    return a->st_dev == b->st_dev && a->st_ino == b->st_ino && a->st_size == b->st_size
+           && a->st_mtim.tv_sec == b->st_mtim.tv_sec && a->st_mtim.tv_nsec == b->st_mtim.tv_nsec;
+}
+
+
+// checkRecord adds the record to the current run if it changed, and writes
+// out the run when it reaches a record that did not change.
+// An empty record at the end of the file flushes the last run.
+static void checkRecord(write_run_t *run, size_t start, size_t end) {
+    if (end > run->length) {
+        end = run->length;
+    }
+    int dirty = start < end
+                && (run->image == NULL || end > run->image->length || memcmp(run->data + start, run->image->data + start, end - start) != 0);
+    if (dirty && !run->inRun) {
+        run->runStart = start;
+        run->inRun = TRUE;
+    } else if (!dirty && run->inRun) {
+        for (size_t pos = run->runStart; pos < start;) {
+            ssize_t n = pwrite(run->fd, run->data + pos, start - pos, (off_t) pos);
+            if (n <= 0) {
+                perror("fileImageWrite");
+                fprintf(stderr, "\n\tCannot write to file '%s'!\n", run->filename);
+                exit(2);
+            }
+            pos += (size_t) n;
+        }
+        run->inRun = FALSE;
+    }
+}
@@ -0,0 +1,52 @@
+// Far Horizons Game Engine
+// Copyright (C) 2022 Michael D Henderson
+// Copyright (C) 2021 Raven Zachary
+// Copyright (C) 2019 Casey Link, Adam Piggott
+// Copyright (C) 1999 Richard A. Morneau
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef FAR_HORIZONS_FILEIMAGE_H
+#define FAR_HORIZONS_FILEIMAGE_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include <sys/stat.h>
+
+// a run of fixed-size records in a data file
+typedef struct {
+    size_t offset;
+    int record_size;
+    int num_records;
+} file_records_t;
+
+// the bytes of a data file as they were last read or written.
+// saves compare the new contents against it, record by record, and only
+// write the records that changed.
+typedef struct {
+    unsigned char *data;
+    size_t length;
+    struct stat sb;  // identifies the file the bytes came from
+} file_image_t;
+
+FILE *fileImageOpen(file_image_t *fi, const char *filename);
+
+void fileImageRemember(file_image_t *fi, const char *filename, const void *data, size_t length);
+
+void fileImageForget(file_image_t *fi);
+
+void fileImageWrite(file_image_t *fi, const char *filename, const void *data, size_t length, int numSections, const file_records_t sections[]);
+
+#endif //FAR_HORIZONS_FILEIMAGE_H
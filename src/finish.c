@@ -27,6 +27,7 @@
 #include "finish.h"
 #include "galaxyio.h"
 #include "log.h"
+#include "logsink.h"
 #include "logvars.h"
 #include "namplavars.h"
 #include "planetio.h"
@@ -83,7 +84,11 @@ int finishCommand(int argc, char *argv[]) {
     int ls_actual, tech, turn_number, percent_increase, old_tech_level;
     int new_tech_level, experience_points, their_level, my_level;
     int new_level, orders_received, contact_bit_number;
-    int contact_word_number, alien_number, galaxy_fd, production_penalty, max_tech_level;
+    int contact_word_number, alien_number, galaxy_fd, production_penalty;
+    /* max_tech_level carries over between techs and species; it used to be
+     * read uninitialized on the no-experience path, which a fresh process
+     * always saw as zero. Keep that behavior but make it explicit. */
+    int max_tech_level = 0;
     short ns;
     long change, total_pop_units, contact_mask, salvage_EUs;
     long salvage_value, original_cost, ib, ab, increment, old_base;
@@ -102,7 +107,7 @@ int finishCommand(int argc, char *argv[]) {
     get_planet_data();
     get_species_data();
     get_transaction_data();
-    num_locs = 0;
+    locationReset();
 
     /* Allocate memory for array "total_econ_base". */
     total = (long) num_planets * sizeof(long);
@@ -163,13 +168,8 @@ int finishCommand(int argc, char *argv[]) {
             printf("\n");
         }
 
-        /* Open log file for appending. */
-        sprintf(filename, "sp%02d.log", species_number);
-        log_file = fopen(filename, "a");
-        if (log_file == NULL) {
-            fprintf(stderr, "\n\tCannot open '%s' for appending!\n\n", filename);
-            exit(-1);
-        }
+        /* Open log file for this species. */
+        log_file = logSinkOpen(species_number);
         log_stdout = FALSE;
         header_printed = FALSE;
 
@@ -178,7 +178,7 @@ int finishCommand(int argc, char *argv[]) {
         }
 
         /* Check if any ships of this species experienced mishaps. */
-        for (int i = 0; i < num_transactions; i++) {
+        for (int i = transactionFirstTo(species_number, SHIP_MISHAP); i >= 0; i = transactionNextTo(i, SHIP_MISHAP)) {
             if (transaction[i].type == SHIP_MISHAP && transaction[i].number1 == species_number) {
                 if (!header_printed) {
                     print_header();
@@ -291,7 +291,7 @@ int finishCommand(int argc, char *argv[]) {
         }
 
         /* Check if this species is the recipient of a transfer of economic units from another species. */
-        for (int i = 0; i < num_transactions; i++) {
+        for (int i = transactionFirstTo(species_number, 0); i >= 0; i = transactionNextTo(i, 0)) {
             if (transaction[i].recipient == species_number &&
                 (transaction[i].type == EU_TRANSFER || transaction[i].type == SIEGE_EU_TRANSFER ||
                  transaction[i].type == LOOTING_EU_TRANSFER)) {
@@ -321,7 +321,7 @@ int finishCommand(int argc, char *argv[]) {
         }
 
         /* Check if any jump portals of this species were used by aliens. */
-        for (int i = 0; i < num_transactions; i++) {
+        for (int i = transactionFirstTo(species_number, ALIEN_JUMP_PORTAL_USAGE); i >= 0; i = transactionNextTo(i, ALIEN_JUMP_PORTAL_USAGE)) {
             if (transaction[i].type == ALIEN_JUMP_PORTAL_USAGE && transaction[i].number1 == species_number) {
                 if (!header_printed) { print_header(); }
                 log_string("  ");
@@ -335,7 +335,7 @@ int finishCommand(int argc, char *argv[]) {
         }
 
         /* Check if any starbases of this species detected the use of gravitic telescopes by aliens. */
-        for (int i = 0; i < num_transactions; i++) {
+        for (int i = transactionFirstTo(species_number, TELESCOPE_DETECTION); i >= 0; i = transactionNextTo(i, TELESCOPE_DETECTION)) {
             if (transaction[i].type == TELESCOPE_DETECTION && transaction[i].number1 == species_number) {
                 if (!header_printed) { print_header(); }
                 log_string("! ");
@@ -351,7 +351,7 @@ int finishCommand(int argc, char *argv[]) {
         }
 
         /* Check if this species is the recipient of a tech transfer from another species. */
-        for (int i = 0; i < num_transactions; i++) {
+        for (int i = transactionFirstTo(species_number, TECH_TRANSFER); i >= 0; i = transactionNextTo(i, TECH_TRANSFER)) {
             if (transaction[i].type == TECH_TRANSFER && transaction[i].recipient == species_number) {
                 int rec = transaction[i].recipient - 1;
                 int don = transaction[i].donor - 1;
@@ -499,7 +499,7 @@ int finishCommand(int argc, char *argv[]) {
         }
 
         /* Check if this species is the recipient of a knowledge transfer from another species. */
-        for (int i = 0; i < num_transactions; i++) {
+        for (int i = transactionFirstTo(species_number, KNOWLEDGE_TRANSFER); i >= 0; i = transactionNextTo(i, KNOWLEDGE_TRANSFER)) {
             if (transaction[i].type == KNOWLEDGE_TRANSFER && transaction[i].recipient == species_number) {
                 int rec = transaction[i].recipient - 1;
                 int don = transaction[i].donor - 1;
@@ -562,7 +562,7 @@ int finishCommand(int argc, char *argv[]) {
 
             /* Check if another species on the same planet has become
             assimilated. */
-            for (int i = 0; i < num_transactions; i++) {
+            for (int i = transactionFirstTo(species_number, ASSIMILATION); i >= 0; i = transactionNextTo(i, ASSIMILATION)) {
                 if (transaction[i].type == ASSIMILATION && transaction[i].value == species_number &&
                     transaction[i].x == nampla->x && transaction[i].y == nampla->y && transaction[i].z == nampla->z &&
                     transaction[i].pn == nampla->pn) {
@@ -790,7 +790,7 @@ int finishCommand(int argc, char *argv[]) {
         }
 
         /* Check if this species has a populated planet that another species tried to land on. */
-        for (int i = 0; i < num_transactions; i++) {
+        for (int i = transactionFirstTo(species_number, LANDING_REQUEST); i >= 0; i = transactionNextTo(i, LANDING_REQUEST)) {
             if (transaction[i].type == LANDING_REQUEST && transaction[i].number1 == species_number) {
                 if (!header_printed) {
                     print_header();
@@ -811,7 +811,7 @@ int finishCommand(int argc, char *argv[]) {
         }
 
         /* Check if this species is the recipient of interspecies construction. */
-        for (int i = 0; i < num_transactions; i++) {
+        for (int i = transactionFirstTo(species_number, INTERSPECIES_CONSTRUCTION); i >= 0; i = transactionNextTo(i, INTERSPECIES_CONSTRUCTION)) {
             if (transaction[i].type == INTERSPECIES_CONSTRUCTION && transaction[i].recipient == species_number) {
                 /* Simply log the result. */
                 if (!header_printed) {
@@ -841,7 +841,7 @@ int finishCommand(int argc, char *argv[]) {
         }
 
         /* Check if this species is besieging another species and detects forbidden construction, landings, etc. */
-        for (int i = 0; i < num_transactions; i++) {
+        for (int i = transactionFirstTo(species_number, DETECTION_DURING_SIEGE); i >= 0; i = transactionNextTo(i, DETECTION_DURING_SIEGE)) {
             if (transaction[i].type == DETECTION_DURING_SIEGE && transaction[i].number3 == species_number) {
                 /* Log what was detected and/or destroyed. */
                 if (!header_printed) {
@@ -893,7 +893,7 @@ int finishCommand(int argc, char *argv[]) {
         check_for_message:
 
         /* Check if this species is the recipient of a message from another species. */
-        for (int i = 0; i < num_transactions; i++) {
+        for (int i = transactionFirstTo(species_number, MESSAGE_TO_SPECIES); i >= 0; i = transactionNextTo(i, MESSAGE_TO_SPECIES)) {
             if (transaction[i].type == MESSAGE_TO_SPECIES && transaction[i].number2 == species_number) {
                 if (!header_printed) {
                     print_header();
@@ -906,9 +906,6 @@ int finishCommand(int argc, char *argv[]) {
                 log_string("\n  *** End of Message ***\n\n");
             }
         }
-
-        /* Close log file. */
-        fclose(log_file);
     }
 
     /* Calculate economic efficiency for each planet. */
@@ -946,14 +943,13 @@ int finishCommand(int argc, char *argv[]) {
 
         /* Update contact mask in species data if this species has met a
             new alien. */
-        for (int i = 0; i < num_locs; i++) {
-            if (loc[i].s != species_number) {
-                continue;
+        for (int i = locationFirstOf(species_number); i >= 0; i = locationNextOf(i)) {
+            if (locationCountAt(i) < 2) {
+                continue;  // no aliens here
             }
 
-            for (int j = 0; j < num_locs; j++) {
-                if (loc[j].s == species_number || loc[j].x != loc[i].x || loc[j].y != loc[i].y ||
-                    loc[j].z != loc[i].z) {
+            for (int j = locationFirstAt(loc[i].x, loc[i].y, loc[i].z); j >= 0; j = locationNextAt(j)) {
+                if (loc[j].s == species_number) {
                     continue;
                 }
 
@@ -969,16 +965,11 @@ int finishCommand(int argc, char *argv[]) {
         }
 
         /* Report results of tech transfers to donor species. */
-        for (int i = 0; i < num_transactions; i++) {
+        for (int i = transactionFirstFrom(species_number, TECH_TRANSFER); i >= 0; i = transactionNextFrom(i, TECH_TRANSFER)) {
             if (transaction[i].type == TECH_TRANSFER
                 && transaction[i].donor == species_number) {
-                /* Open log file for appending. */
-                sprintf(filename, "sp%02d.log", species_number);
-                log_file = fopen(filename, "a");
-                if (log_file == NULL) {
-                    fprintf(stderr, "\n\tCannot open '%s' for appending!\n\n", filename);
-                    exit(-1);
-                }
+                /* Open log file for this species. */
+                log_file = logSinkOpen(species_number);
                 log_stdout = FALSE;
 
                 log_string("  ");
@@ -1002,8 +993,6 @@ int finishCommand(int argc, char *argv[]) {
                 }
 
                 log_string(".\n");
-
-                fclose(log_file);
             }
         }
 
@@ -1100,6 +1089,7 @@ int finishCommand(int argc, char *argv[]) {
     save_planet_data();
     save_location_data();
     save_species_data();
+    logSinkFlush();
     free_species_data();
     free(planet_base);
     free(total_econ_base);
@@ -23,6 +23,7 @@
 #include "data.h"
 #include "galaxy.h"
 #include "galaxyio.h"
+#include "resident.h"
 
 
 struct galaxy_data galaxy;
@@ -44,6 +45,10 @@ void galaxyDataAsSexpr(FILE *fp) {
 
 
 void get_galaxy_data(void) {
+    if (galaxy_resident) {
+        residentGetGalaxyData();
+        return;
+    }
     FILE *fp = fopen("galaxy.dat", "rb");
     if (fp == NULL) {
         fprintf(stderr, "\n\tCannot open file galaxy.dat!\n");
@@ -62,6 +67,10 @@ void get_galaxy_data(void) {
 
 
 void save_galaxy_data(void) {
+    if (galaxy_resident) {
+        residentSaveGalaxyData();
+        return;
+    }
     FILE *fp = fopen("galaxy.dat", "wb");
     if (fp == NULL) {
         perror("save_galaxy_data");
@@ -26,6 +26,7 @@
 #include "speciesvars.h"
 #include "shipvars.h"
 #include "log.h"
+#include "sector.h"
 #include "transactionio.h"
 #include "intercept.h"
 
@@ -41,12 +42,14 @@ void handle_intercept(int intercept_index) {
     int i, j, n, num_enemy_ships, alien_index, enemy_index, enemy_num, num_ships_left, array_index, bit_number, is_an_enemy, is_distorted;
     char enemy_number[MAX_ENEMY_SHIPS];
     long bit_mask, cost_to_destroy;
-    struct species_data *alien;
     struct ship_data *alien_sh, *enemy_sh, *enemy_ship[MAX_ENEMY_SHIPS];
+    sector_t *sector;
 
 
     /* Make a list of all enemy ships that jumped into this system. */
     num_enemy_ships = 0;
+    sector = sectorAt(intercept[intercept_index].x, intercept[intercept_index].y, intercept[intercept_index].z);
+    if (sector == NULL) { return;    /* Nothing to intercept. */}
     for (alien_index = 0; alien_index < galaxy.num_species; alien_index++) {
         if (!data_in_memory[alien_index]) { continue; }
 
@@ -63,10 +66,9 @@ void handle_intercept(int intercept_index) {
         }
 
         /* Find enemy ships, if any, that jumped to this location. */
-        alien = &spec_data[alien_index];
-        alien_sh = ship_data[alien_index] - 1;
-        for (i = 0; i < alien->num_ships; i++) {
-            ++alien_sh;
+        for (i = 0; i < sector->num_ships; i++) {
+            if (sector->ship[i].species_index != alien_index) { continue; }
+            alien_sh = ship_data[alien_index] + sector->ship[i].index;
 
             if (alien_sh->pn == 99) { continue; }
 
@@ -157,12 +159,7 @@ void handle_intercept(int intercept_index) {
         log_string(".\n");
 
         /* Create interspecies transaction so that other player will be notified. */
-        if (num_transactions == MAX_TRANSACTIONS) {
-            fprintf(stderr, "\n\n\tERROR! num_transactions > MAX_TRANSACTIONS in handle_intercept!\n\n");
-            exit(-1);
-        }
-
-        n = num_transactions++;
+        n = transactionAdd();
         transaction[n].type = SHIP_MISHAP;
         transaction[n].value = 1;    /* Interception. */
         transaction[n].number1 = enemy_number[enemy_index];
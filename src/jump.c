@@ -29,23 +29,23 @@
 #include "galaxyio.h"
 #include "jump.h"
 #include "logvars.h"
+#include "ordercache.h"
+#include "prng.h"
 #include "planetio.h"
 #include "shipvars.h"
+#include "snapshot.h"
 #include "speciesvars.h"
 #include "stario.h"
 #include "transactionio.h"
 #include "speciesio.h"
 #include "namplavars.h"
 #include "log.h"
+#include "logsink.h"
 
 
 void do_jump_orders(void) {
     int i, command;
 
-    if (first_pass) {
-        printf("\nStart of jump orders for species #%d, SP %s...\n", species_number, species->name);
-    }
-
     while (TRUE) {
         command = get_command();
 
@@ -57,10 +57,6 @@ void do_jump_orders(void) {
         }
 
         if (end_of_file || command == END) {
-            if (first_pass) {
-                printf("End of jump orders for species #%d, SP %s.\n", species_number, species->name);
-            }
-            if (first_pass) { gamemaster_abort_option(); }
             break;            /* END for this species. */
         }
 
@@ -92,11 +88,11 @@ void do_jump_orders(void) {
 int jumpCommand(int argc, char *argv[]) {
     int do_all_species = TRUE;
     int dryRun = FALSE;
+    int preview = FALSE;
     int num_species = 0;
     int sp_num[MAX_SPECIES];
     memset(sp_num, 0, sizeof(sp_num));
 
-    first_pass = FALSE;
     ignore_field_distorters = TRUE;
 
     /* Get commonly used data. */
@@ -106,8 +102,7 @@ int jumpCommand(int argc, char *argv[]) {
     get_transaction_data();
 
     /* Check arguments.
-     * If an argument is -p, then do two passes.
-     * In the first pass, display results and prompt the GM,
+     * If an argument is -p, then display results and prompt the GM,
      * allowing the GM to abort if necessary before saving results to disk.
      * All other arguments must be species numbers.
      * If no species numbers are specified, then do all species. */
@@ -129,14 +124,14 @@ int jumpCommand(int argc, char *argv[]) {
             return 2;
         } else if (strcmp(opt, "-p") == 0 && val == NULL) {
             dryRun = TRUE;
-            first_pass = TRUE;
+            preview = TRUE;
         } else if (strcmp(opt, "-t") == 0 && val == NULL) {
             test_mode = TRUE;
         } else if (strcmp(opt, "-v") == 0 && val == NULL) {
             verbose_mode = TRUE;
         } else if (strcmp(opt, "--dry-run") == 0 && val == NULL) {
             dryRun = TRUE;
-            first_pass = TRUE;
+            preview = TRUE;
         } else if (strcmp(opt, "--test") == 0 && val == NULL) {
             test_mode = TRUE;
         } else if (val == NULL && isdigit(*opt)) {
@@ -195,19 +190,12 @@ int jumpCommand(int argc, char *argv[]) {
         species_jumped[i] = FALSE;
     }
 
-    /* Two passes through all orders will be done.
-     * The first pass will  check for errors and abort if any are found.
-     * Results will be written to disk only on the second pass. */
-
-    start_pass:
-
-    if (first_pass) {
-        printf("\nStarting first pass...\n\n");
-    }
-
-    get_star_data();
-    get_planet_data();
+    /* When previewing, the results are held until the GM has seen them.
+     * If the GM aborts, nothing is written to disk. */
     get_species_data();
+    if (preview) {
+        snapshotTake();
+    }
 
     /* Main loop. For each species, take appropriate action. */
     for (int sp_index = 0; sp_index < num_species; sp_index++) {
@@ -216,7 +204,7 @@ int jumpCommand(int argc, char *argv[]) {
         int found = data_in_memory[species_number - 1];
         if (!found) {
             if (do_all_species) {
-                if (first_pass) {
+                if (preview) {
                     printf("\n    Skipping species #%d.\n", species_number);
                 }
                 continue;
@@ -233,10 +221,9 @@ int jumpCommand(int argc, char *argv[]) {
         /* Open orders file for this species. */
         char filename[128];
         sprintf(filename, "sp%02d.ord", species_number);
-        input_file = fopen(filename, "r");
-        if (input_file == NULL) {
+        if (!ordersOpen(species_number)) {
             if (do_all_species) {
-                if (first_pass) {
+                if (preview) {
                     printf("\n    No orders for species #%d.\n", species_number);
                 }
                 continue;
@@ -246,66 +233,17 @@ int jumpCommand(int argc, char *argv[]) {
             }
         }
 
-        /* Open log file. Use stdout for first pass. */
-        if (first_pass) {
-            log_file = stdout;
-        } else {
-            /* Open log file for appending. */
-            sprintf(filename, "sp%02d.log", species_number);
-            log_file = fopen(filename, "a");
-            if (log_file == NULL) {
-                fprintf(stderr, "\n\tCannot open '%s' for appending!\n\n", filename);
-                exit(-1);
-            }
-        }
-
-        end_of_file = FALSE;
+        /* Open log file for appending. */
+        log_file = logSinkOpen(species_number);
 
-        just_opened_file = TRUE;    /* Tell command parser to skip mail header, if any. */
-        find_start:
+        /* Each species draws from its own stream of random numbers. */
+        prngUseStream("jump", galaxy.turn_number, species_number);
 
         /* Search for START JUMPS order. */
-        found = FALSE;
-        for (; found == FALSE;) {
-            int command = get_command();
-            if (command == MESSAGE) {
-                /* Skip MESSAGE text.
-                 * It may contain a line that starts with "start". */
-                while (TRUE) {
-                    command = get_command();
-                    if (command < 0) {
-                        fprintf(stderr, "WARNING: Unterminated MESSAGE command in file %s!\n", filename);
-                        break;
-                    }
-                    if (command == ZZZ) {
-                        goto find_start;
-                    }
-                }
-            }
-
-            if (command < 0) {
-                /* End of file. */
-                break;
-            }
-            if (command != START) {
-                continue;
-            }
-
-            /* Get the first three letters of the keyword and convert to upper case. */
-            skip_whitespace();
-            char keyword[4] = {0, 0, 0, 0};
-            for (int i = 0; i < 3 && *input_line_pointer != 0; i++) {
-                keyword[i] = toupper(*input_line_pointer);
-                input_line_pointer++;
-            }
-
-            if (strcmp(keyword, "JUM") == 0) {
-                found = TRUE;
-            }
-        }
+        found = ordersFind("JUM");
 
         if (!found) {
-            if (first_pass) {
+            if (preview) {
                 printf("\nNo jump orders for species #%d, SP %s.\n", species_number, species->name);
             }
             goto done_orders;
@@ -319,7 +257,7 @@ int jumpCommand(int argc, char *argv[]) {
 
         done_orders:
 
-        fclose(input_file);
+        ordersClose();
 
         /* Take care of any ships that withdrew or were forced to jump during combat. */
         ship = ship_base;
@@ -329,24 +267,7 @@ int jumpCommand(int argc, char *argv[]) {
             }
             ship++;
         }
-
-        /* If this is the second pass, close the log file. */
-        if (!first_pass) {
-            fclose(log_file);
-        }
-    }
-
-    if (first_pass) {
-        printf("\nFinal chance to abort safely!\n");
-        gamemaster_abort_option();
-        first_pass = FALSE;
-        free_species_data();
-        free(star_base);    /* In case data was modified. */
-        free(planet_base);    /* In case data was modified. */
-
-        printf("\nStarting second pass...\n\n");
-
-        goto start_pass;
+        prngUseGlobal();
     }
 
     no_jump_orders:
@@ -367,17 +288,12 @@ int jumpCommand(int argc, char *argv[]) {
         nampla_base = namp_data[species_number - 1];
         ship_base = ship_data[species_number - 1];
 
+        prngUseStream("jump-withdrawal", galaxy.turn_number, species_number);
         ship = ship_base;
         for (ship_index = 0; ship_index < species->num_ships; ship_index++) {
             if (ship->status == FORCED_JUMP || ship->status == JUMPED_IN_COMBAT) {
                 if (!log_file_open) {
-                    char filename[128];
-                    sprintf(filename, "sp%02d.log", species_number);
-                    log_file = fopen(filename, "a");
-                    if (log_file == NULL) {
-                        fprintf(stderr, "\n\tCannot open '%s' for appending!\n\n", filename);
-                        exit(2);
-                    }
+                    log_file = logSinkOpen(species_number);
                     log_file_open = TRUE;
                     log_string("\nWithdrawals and forced jumps during combat:\n");
                 }
@@ -386,13 +302,18 @@ int jumpCommand(int argc, char *argv[]) {
             }
             ship++;
         }
+        prngUseGlobal();
 
         data_modified[species_number - 1] = log_file_open;
 
-        if (log_file_open) {
-            fclose(log_file);
-            log_file_open = FALSE;
-        }
+        log_file_open = FALSE;
+    }
+
+    if (preview && !snapshotPreview()) {
+        free_species_data();
+        free(star_base);
+        free(planet_base);
+        return 0;
     }
 
     save_species_data();
@@ -403,6 +324,7 @@ int jumpCommand(int argc, char *argv[]) {
     if (planet_data_modified) {
         save_planet_data();
     }
+    logSinkFlush();
     free_species_data();
     free(star_base);
     free(planet_base);
@@ -19,6 +19,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include "datafile.h"
 #include "galaxy.h"
 #include "galaxyio.h"
 #include "planetio.h"
@@ -39,6 +40,7 @@ int listCommand(int argc, char *argv[]) {
     const char *cmdName = argv[0];
 
     // load data used to derive locations
+    map_data_in_place = TRUE;
     get_galaxy_data();
     get_star_data();
     get_planet_data();
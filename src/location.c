@@ -35,29 +35,14 @@
 
 
 void add_location(int x, int y, int z) {
-    for (int i = 0; i < num_locs; i++) {
-        if (loc[i].x == x && loc[i].y == y && loc[i].z == z && loc[i].s == species_number) {
-            return; /* This location is already in list for this species. */
-        }
-    }
-
-    /* Add new location to the list. */
-    loc[num_locs].x = x;
-    loc[num_locs].y = y;
-    loc[num_locs].z = z;
-    loc[num_locs].s = species_number;
-    num_locs++;
-    if (num_locs < MAX_LOCATIONS) {
-        return;
-    }
-    fprintf(stderr, "\n\n\tInternal error. Overflow of 'loc' arrays!\n\n");
-    exit(-1);
+    /* A location that is already in the list for this species is not added again. */
+    locationAdd(species_number, x, y, z);
 }
 
 
 /* This routine will create the "loc" array based on current species' data. */
 void do_locations(void) {
-    num_locs = 0;
+    locationReset();
     for (species_number = 1; species_number <= galaxy.num_species; species_number++) {
         int spidx = species_number - 1;
         if (data_in_memory[spidx] == FALSE) {
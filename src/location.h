@@ -22,8 +22,6 @@
 
 #include <stdio.h>
 
-#define MAX_LOCATIONS    10000
-
 struct sp_loc_data {
     int s;    /* Species number */
     int x;
@@ -20,15 +20,37 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/stat.h>
+#include "arena.h"
 #include "engine.h"
 #include "locationio.h"
 #include "location.h"
+#include "resident.h"
 
 
-struct sp_loc_data loc[MAX_LOCATIONS];
+// the locations, in the order they were added. the array grows as needed.
+struct sp_loc_data *loc;
 int num_locs;
 
+// hash tables over the locations, kept at most half full.
+// byKey maps (species, x, y, z) to a location and byCoords maps (x, y, z) to the first location there.
+// the locations at the same coordinates are chained together in the order they were added,
+// and so are the locations of each species.
+static struct {
+    int max_locs;
+    int *next_at;     // index of the next location at the same coordinates, or -1
+    int *last_at;     // for the first location at the coordinates, index of the last one there
+    int *first_at;    // index of the first location at the same coordinates
+    int *count_at;    // for the first location at the coordinates, number of locations there
+    int *next_of;     // index of the next location of the same species, or -1
+    int first_of[MAX_SPECIES + 1]; // index of the species' first location plus one, or zero if it has none
+    int last_of[MAX_SPECIES + 1];  // index of the species' last location
+    int table_size;   // always a power of two
+    int *byKey;       // index of the location plus one, or zero if the slot is empty
+    int *byCoords;    // index of the first location at the coordinates plus one, or zero if the slot is empty
+} locs;
+
 
 typedef struct {
     uint8_t s;    /* Species number */
@@ -38,34 +60,48 @@ typedef struct {
 } binary_ship_data_t;
 
 
+static int locationAppend(int s, int x, int y, int z);
+
+static void locationGrow(void);
+
+static void locationHash(int index);
+
+static void locationRehash(void);
+
+static unsigned locationSlot(int s, int x, int y, int z, int size);
+
+
 void get_location_data(void) {
+    if (galaxy_resident) {
+        residentGetLocationData();
+        return;
+    }
+
+    locationReset();
+
     /* Get size of file. */
     struct stat sb;
     if (stat("locations.dat", &sb) != 0) {
-        num_locs = 0;
         return;
     }
 
     // get number of records in the file
-    num_locs = sb.st_size / sizeof(binary_ship_data_t);
-    if (sb.st_size != num_locs * sizeof(binary_ship_data_t)) {
+    int numRecords = sb.st_size / sizeof(binary_ship_data_t);
+    if (sb.st_size != numRecords * sizeof(binary_ship_data_t)) {
         fprintf(stderr, "\nFile locations.dat contains extra bytes (%ld > %ld)!\n\n",
-                sb.st_size, num_locs * sizeof(binary_ship_data_t));
+                sb.st_size, numRecords * sizeof(binary_ship_data_t));
         exit(-1);
-    } else if (num_locs == 0) {
+    } else if (numRecords == 0) {
         // nothing to do
         return;
-    } else if (num_locs > MAX_LOCATIONS) {
-        fprintf(stderr, "\nFile locations.dat contains too many records (%d > %d)!\n\n", num_locs, MAX_LOCATIONS);
-        exit(-1);
     }
 
     /* Allocate enough memory for all records. */
-    binary_ship_data_t *binData = (binary_ship_data_t *) ncalloc(__FUNCTION__, __LINE__, num_locs, sizeof(binary_ship_data_t));
+    binary_ship_data_t *binData = (binary_ship_data_t *) arenaAlloc(__FUNCTION__, __LINE__, numRecords, sizeof(binary_ship_data_t));
     if (binData == NULL) {
         perror("get_location_data");
         fprintf(stderr, "\nCannot allocate enough memory for location data!\n");
-        fprintf(stderr, "\n\tattempted to allocate %d location entries\n\n", num_locs);
+        fprintf(stderr, "\n\tattempted to allocate %d location entries\n\n", numRecords);
         exit(-1);
     }
 
@@ -77,23 +113,112 @@ void get_location_data(void) {
         exit(-1);
     }
     /* Read it all into memory. */
-    if (fread(binData, sizeof(binary_ship_data_t), num_locs, fp) != num_locs) {
+    if (fread(binData, sizeof(binary_ship_data_t), numRecords, fp) != numRecords) {
         fprintf(stderr, "\nCannot read file 'locations.dat' into memory!\n");
-        fprintf(stderr, "\n\tattempted to read %d location entries\n\n", num_locs);
+        fprintf(stderr, "\n\tattempted to read %d location entries\n\n", numRecords);
         exit(-1);
     }
 
     /* translate data */
-    for (int i = 0; i < num_locs; i++) {
-        loc[i].x = binData[i].x;
-        loc[i].y = binData[i].y;
-        loc[i].z = binData[i].z;
-        loc[i].s = binData[i].s;
+    for (int i = 0; i < numRecords; i++) {
+        locationAppend(binData[i].s, binData[i].x, binData[i].y, binData[i].z);
     }
 
     fclose(fp);
+}
+
+
+// locationAdd adds a location for the species, unless the species is already listed at the coordinates.
+// Returns the index of the location.
+int locationAdd(int s, int x, int y, int z) {
+    int index = locationFind(s, x, y, z);
+    if (index < 0) {
+        index = locationAppend(s, x, y, z);
+    }
+    return index;
+}
+
+
+// locationCountAt returns the number of species at the coordinates of the location, including its own.
+int locationCountAt(int index) {
+    return locs.count_at[locs.first_at[index]];
+}
+
+
+// locationFind returns the index of the location for the species at the coordinates, or -1 if there isn't one.
+int locationFind(int s, int x, int y, int z) {
+    if (locs.table_size == 0) {
+        return -1;
+    }
+    unsigned slot = locationSlot(s, x, y, z, locs.table_size);
+    for (; locs.byKey[slot] != 0; slot = (slot + 1) & (locs.table_size - 1)) {
+        sp_loc_data_t *p = &loc[locs.byKey[slot] - 1];
+        if (p->s == s && p->x == x && p->y == y && p->z == z) {
+            return locs.byKey[slot] - 1;
+        }
+    }
+    return -1;
+}
+
+
+// locationFirstAt returns the index of the first location at the coordinates, or -1 if no species is there.
+// Use locationNextAt to visit the other species at the same coordinates.
+int locationFirstAt(int x, int y, int z) {
+    if (locs.table_size == 0) {
+        return -1;
+    }
+    unsigned slot = locationSlot(0, x, y, z, locs.table_size);
+    for (; locs.byCoords[slot] != 0; slot = (slot + 1) & (locs.table_size - 1)) {
+        sp_loc_data_t *p = &loc[locs.byCoords[slot] - 1];
+        if (p->x == x && p->y == y && p->z == z) {
+            return locs.byCoords[slot] - 1;
+        }
+    }
+    return -1;
+}
+
+
+// locationFirstOf returns the index of the first location of the species, or -1 if it has none.
+// Use locationNextOf to visit the rest of the species' locations.
+int locationFirstOf(int s) {
+    if (s < 1 || s > MAX_SPECIES) {
+        return -1;
+    }
+    return locs.first_of[s] - 1;
+}
+
+
+// locationNextAt returns the index of the next location at the same coordinates, or -1 if there are no more.
+// Locations at the same coordinates are visited in the order they appear in the loc array.
+int locationNextAt(int index) {
+    return locs.next_at[index];
+}
+
+
+// locationNextOf returns the index of the next location of the same species, or -1 if there are no more.
+// A species' locations are visited in the order they appear in the loc array.
+int locationNextOf(int index) {
+    return locs.next_of[index];
+}
+
 
-    free(binData);
+// locationReplace replaces all the locations with a copy of the given ones.
+void locationReplace(const sp_loc_data_t *data, int count) {
+    locationReset();
+    for (int i = 0; i < count; i++) {
+        locationAppend(data[i].s, data[i].x, data[i].y, data[i].z);
+    }
+}
+
+
+// locationReset removes all the locations.
+void locationReset(void) {
+    num_locs = 0;
+    memset(locs.first_of, 0, sizeof(locs.first_of));
+    if (locs.table_size != 0) {
+        memset(locs.byKey, 0, locs.table_size * sizeof(int));
+        memset(locs.byCoords, 0, locs.table_size * sizeof(int));
+    }
 }
 
 
@@ -122,6 +247,11 @@ void locationDataAsSExpr(FILE *fp) {
 
 
 void save_location_data(void) {
+    if (galaxy_resident) {
+        residentSaveLocationData();
+        return;
+    }
+
     /* Open file 'locations.dat' for writing. */
     FILE *fp = fopen("locations.dat", "wb");
     if (fp == NULL) {
@@ -132,7 +262,7 @@ void save_location_data(void) {
 
     if (num_locs > 0) {
         /* Allocate enough memory for all records. */
-        binary_ship_data_t *binData = (binary_ship_data_t *) ncalloc(__FUNCTION__, __LINE__, num_locs, sizeof(binary_ship_data_t));
+        binary_ship_data_t *binData = (binary_ship_data_t *) arenaAlloc(__FUNCTION__, __LINE__, num_locs, sizeof(binary_ship_data_t));
         if (binData == NULL) {
             perror("save_location_data");
             fprintf(stderr, "\nCannot allocate enough memory for location data!\n");
@@ -154,10 +284,122 @@ void save_location_data(void) {
             fprintf(stderr, "\n\n\tCannot write to 'locations.dat'!\n\n");
             exit(-1);
         }
-        free(binData);
     }
     fclose(fp);
 }
 
 
+// locationAppend adds a location to the end of the array and to the hash tables.
+// The caller must make sure that the species is not already listed at the coordinates.
+static int locationAppend(int s, int x, int y, int z) {
+    if (num_locs == locs.max_locs) {
+        locationGrow();
+    }
+    int index = num_locs++;
+    loc[index].s = s;
+    loc[index].x = x;
+    loc[index].y = y;
+    loc[index].z = z;
+    if (2 * num_locs > locs.table_size) {
+        locationRehash();
+    } else {
+        locationHash(index);
+    }
+    return index;
+}
+
 
+// locationGrow doubles the space for locations.
+static void locationGrow(void) {
+    int size = locs.max_locs == 0 ? 1024 : 2 * locs.max_locs;
+    sp_loc_data_t *data = (sp_loc_data_t *) ncalloc(__FUNCTION__, __LINE__, size, sizeof(sp_loc_data_t));
+    int *next_at = (int *) ncalloc(__FUNCTION__, __LINE__, size, sizeof(int));
+    int *last_at = (int *) ncalloc(__FUNCTION__, __LINE__, size, sizeof(int));
+    int *first_at = (int *) ncalloc(__FUNCTION__, __LINE__, size, sizeof(int));
+    int *count_at = (int *) ncalloc(__FUNCTION__, __LINE__, size, sizeof(int));
+    int *next_of = (int *) ncalloc(__FUNCTION__, __LINE__, size, sizeof(int));
+    if (num_locs > 0) {
+        memcpy(data, loc, num_locs * sizeof(sp_loc_data_t));
+        memcpy(next_at, locs.next_at, num_locs * sizeof(int));
+        memcpy(last_at, locs.last_at, num_locs * sizeof(int));
+        memcpy(first_at, locs.first_at, num_locs * sizeof(int));
+        memcpy(count_at, locs.count_at, num_locs * sizeof(int));
+        memcpy(next_of, locs.next_of, num_locs * sizeof(int));
+    }
+    free(loc);
+    free(locs.next_at);
+    free(locs.last_at);
+    free(locs.first_at);
+    free(locs.count_at);
+    free(locs.next_of);
+    loc = data;
+    locs.next_at = next_at;
+    locs.last_at = last_at;
+    locs.first_at = first_at;
+    locs.count_at = count_at;
+    locs.next_of = next_of;
+    locs.max_locs = size;
+}
+
+
+// locationHash adds a location to both hash tables and to the end of the chains for its coordinates and its species.
+static void locationHash(int index) {
+    sp_loc_data_t *p = &loc[index];
+
+    unsigned slot = locationSlot(p->s, p->x, p->y, p->z, locs.table_size);
+    while (locs.byKey[slot] != 0) {
+        slot = (slot + 1) & (locs.table_size - 1);
+    }
+    locs.byKey[slot] = index + 1;
+
+    locs.next_of[index] = -1;
+    if (p->s >= 1 && p->s <= MAX_SPECIES) {
+        if (locs.first_of[p->s] == 0) {
+            locs.first_of[p->s] = index + 1;
+        } else {
+            locs.next_of[locs.last_of[p->s]] = index;
+        }
+        locs.last_of[p->s] = index;
+    }
+
+    locs.next_at[index] = -1;
+    locs.last_at[index] = index;
+    slot = locationSlot(0, p->x, p->y, p->z, locs.table_size);
+    for (; locs.byCoords[slot] != 0; slot = (slot + 1) & (locs.table_size - 1)) {
+        int first = locs.byCoords[slot] - 1;
+        if (loc[first].x == p->x && loc[first].y == p->y && loc[first].z == p->z) {
+            locs.next_at[locs.last_at[first]] = index;
+            locs.last_at[first] = index;
+            locs.first_at[index] = first;
+            locs.count_at[first]++;
+            return;
+        }
+    }
+    locs.byCoords[slot] = index + 1;
+    locs.first_at[index] = index;
+    locs.count_at[index] = 1;
+}
+
+
+// locationRehash doubles the size of the hash tables and adds every location to them again.
+static void locationRehash(void) {
+    int size = locs.table_size == 0 ? 2048 : 2 * locs.table_size;
+    free(locs.byKey);
+    free(locs.byCoords);
+    locs.byKey = (int *) ncalloc(__FUNCTION__, __LINE__, size, sizeof(int));
+    locs.byCoords = (int *) ncalloc(__FUNCTION__, __LINE__, size, sizeof(int));
+    locs.table_size = size;
+    memset(locs.first_of, 0, sizeof(locs.first_of));
+    for (int i = 0; i < num_locs; i++) {
+        locationHash(i);
+    }
+}
+
+
+// locationSlot packs the species and coordinates into a key and hashes it to a slot in a table of the given size.
+// The coordinates table uses zero for the species.
+static unsigned locationSlot(int s, int x, int y, int z, int size) {
+    unsigned key = ((unsigned) (s & 0xff) << 24) | ((unsigned) (x & 0xff) << 16) | ((unsigned) (y & 0xff) << 8) | (unsigned) (z & 0xff);
+    unsigned hash = key * 2654435761u;
+    return (hash ^ (hash >> 15)) & (unsigned) (size - 1);
+}
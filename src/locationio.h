@@ -25,15 +25,33 @@
 
 void get_location_data(void);
 
+int locationAdd(int s, int x, int y, int z);
+
 void locationDataAsJson(FILE *fp);
 
 void locationDataAsSExpr(FILE *fp);
 
+int locationCountAt(int index);
+
+int locationFind(int s, int x, int y, int z);
+
+int locationFirstAt(int x, int y, int z);
+
+int locationFirstOf(int s);
+
+int locationNextAt(int index);
+
+int locationNextOf(int index);
+
+void locationReplace(const sp_loc_data_t *data, int count);
+
+void locationReset(void);
+
 void save_location_data(void);
 
 // globals. ugh.
 
-extern struct sp_loc_data loc[MAX_LOCATIONS];
+extern struct sp_loc_data *loc;
 extern int num_locs;
 
 #endif //FAR_HORIZONS_LOCATIONIO_H
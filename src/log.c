@@ -17,18 +17,21 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <fcntl.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdarg.h>
+#include <unistd.h>
 #include "engine.h"
+#include "fileappend.h"
 #include "log.h"
 #include "logvars.h"
 
 
-static int log_indentation = 0;
-static char log_line[128];
-static int log_position = 0;
-static int log_start_of_line = TRUE;
+static THREAD_LOCAL int log_indentation = 0;
+static THREAD_LOCAL char log_line[128];
+static THREAD_LOCAL int log_position = 0;
+static THREAD_LOCAL int log_start_of_line = TRUE;
 
 
 /* The following routines will post an item to standard output and to an externally defined log file and summary file. */
@@ -126,23 +129,20 @@ void log_long(long value) {
 
 
 void log_message(char *message_filename) {
-    char message_line[256];
     /* Open message file. */
-    FILE *message_file = fopen(message_filename, "r");
-    if (message_file == NULL) {
+    int message_fd = open(message_filename, O_RDONLY);
+    if (message_fd < 0) {
         fprintf(stderr, "\n\tWARNING! log_message: cannot open message file '%s'!\n\n", message_filename);
         return;
     }
     /* Copy message to log file. */
-    while (readln(message_line, 256, message_file) != NULL) {
-        fputs(message_line, log_file);
-    }
-    fclose(message_file);
+    fileAppend(log_file, message_fd, message_filename);
+    close(message_fd);
 }
 
 
 void log_printf(char *fmt, ...) {
-    static char buffer[4096];
+    static THREAD_LOCAL char buffer[4096];
     if (!logging_disabled) {
         va_list arg_ptr;
         va_start(arg_ptr, fmt);
@@ -0,0 +1,118 @@
+// Far Horizons Game Engine
+// Copyright (C) 2022 Michael D Henderson
+// Copyright (C) 2021 Raven Zachary
+// Copyright (C) 2019 Casey Link, Adam Piggott
+// Copyright (C) 1999 Richard A. Morneau
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "engine.h"
+#include "logsink.h"
+
+
+// the in-memory log for one species
+typedef struct {
+    FILE *fp;
+    char *text;
+    size_t length;
+} log_sink_t;
+
+static log_sink_t sink[MAX_SPECIES];
+
+
+static void logSinkClose(log_sink_t *ls);
+
+
+// logSinkOpen returns the log for the species, starting it if nothing has been logged for the species yet.
+// The log stays open until it is flushed or dropped, so callers must not close it.
+FILE *logSinkOpen(int species_number) {
+    log_sink_t *ls = &sink[species_number - 1];
+    if (ls->fp == NULL) {
+        ls->fp = open_memstream(&ls->text, &ls->length);
+        if (ls->fp == NULL) {
+            perror("logSinkOpen");
+            fprintf(stderr, "\n\tCannot create log for species #%d!\n\n", species_number);
+            exit(2);
+        }
+    }
+    return ls->fp;
+}
+
+
+// logSinkText points text at what has been logged for the species so far.
+// Returns FALSE if nothing has been logged for it.
+int logSinkText(int species_number, const char **text, size_t *length) {
+    log_sink_t *ls = &sink[species_number - 1];
+    if (ls->fp == NULL) {
+        return FALSE;
+    }
+    fflush(ls->fp);
+    *text = ls->text;
+    *length = ls->length;
+    return TRUE;
+}
+
+
+// logSinkFlush appends every log to its spNN.log, with a single write per species, and then drops the logs.
+void logSinkFlush(void) {
+    for (int i = 0; i < MAX_SPECIES; i++) {
+        log_sink_t *ls = &sink[i];
+        if (ls->fp == NULL) {
+            continue;
+        }
+        fclose(ls->fp);
+        ls->fp = NULL;
+
+        char filename[32];
+        sprintf(filename, "sp%02d.log", i + 1);
+        int fd = open(filename, O_WRONLY | O_APPEND | O_CREAT, 0666);
+        if (fd < 0) {
+            perror("logSinkFlush");
+            fprintf(stderr, "\n\tCannot open '%s' for appending!\n\n", filename);
+            exit(2);
+        }
+        if (write(fd, ls->text, ls->length) != (ssize_t) ls->length) {
+            perror("logSinkFlush");
+            fprintf(stderr, "\n\tCannot append to '%s'!\n\n", filename);
+            exit(2);
+        }
+        close(fd);
+
+        logSinkClose(ls);
+    }
+}
+
+
+// logSinkDrop throws away every log without writing it.
+void logSinkDrop(void) {
+    for (int i = 0; i < MAX_SPECIES; i++) {
+        logSinkClose(&sink[i]);
+    }
+}
+
+
+static void logSinkClose(log_sink_t *ls) {
+    if (ls->fp != NULL) {
+        fclose(ls->fp);
+        ls->fp = NULL;
+    }
+    free(ls->text);
+    ls->text = NULL;
+    ls->length = 0;
+}
@@ -0,0 +1,42 @@
+// Far Horizons Game Engine
+// Copyright (C) 2022 Michael D Henderson
+// Copyright (C) 2021 Raven Zachary
+// Copyright (C) 2019 Casey Link, Adam Piggott
+// Copyright (C) 1999 Richard A. Morneau
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef FAR_HORIZONS_LOGSINK_H
+#define FAR_HORIZONS_LOGSINK_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+// A log sink holds what a phase logs for one species in memory.
+// The phases log into the sinks and flush them once their results are saved,
+// which appends each sink to its spNN.log with a single write. If the results
+// are thrown away (the GM aborts a preview), the sinks are dropped and the log
+// files are never touched. Every species has its own sink, so several species
+// can be logged at the same time.
+
+FILE *logSinkOpen(int species_number);
+
+int logSinkText(int species_number, const char **text, size_t *length);
+
+void logSinkFlush(void);
+
+void logSinkDrop(void);
+
+#endif //FAR_HORIZONS_LOGSINK_H
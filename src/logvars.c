@@ -20,17 +20,17 @@
 #include "engine.h"
 #include "logvars.h"
 
-int header_printed;
+THREAD_LOCAL int header_printed;
 
-FILE *log_file;
+THREAD_LOCAL FILE *log_file;
 
-int log_stdout = TRUE;
+THREAD_LOCAL int log_stdout = TRUE;
 
-int log_summary = FALSE;
+THREAD_LOCAL int log_summary = FALSE;
 
-int log_to_file = TRUE;
+THREAD_LOCAL int log_to_file = TRUE;
 
-int logging_disabled = FALSE;
+THREAD_LOCAL int logging_disabled = FALSE;
 
-FILE *summary_file;
+THREAD_LOCAL FILE *summary_file;
 
@@ -21,15 +21,16 @@
 #define FAR_HORIZONS_LOGVARS_H
 
 #include <stdio.h>
+#include "engine.h"
 
 // globals. ugh.
 
-extern int header_printed;
-extern FILE *log_file;
-extern int log_stdout;
-extern int log_summary;
-extern int log_to_file;
-extern int logging_disabled;
-extern FILE *summary_file;
+extern THREAD_LOCAL int header_printed;
+extern THREAD_LOCAL FILE *log_file;
+extern THREAD_LOCAL int log_stdout;
+extern THREAD_LOCAL int log_summary;
+extern THREAD_LOCAL int log_to_file;
+extern THREAD_LOCAL int logging_disabled;
+extern THREAD_LOCAL FILE *summary_file;
 
 #endif //FAR_HORIZONS_LOGVARS_H
@@ -0,0 +1,318 @@
+// Far Horizons Game Engine
+// Copyright (C) 2022 Michael D Henderson
+// Copyright (C) 2021 Raven Zachary
+// Copyright (C) 2019 Casey Link, Adam Piggott
+// Copyright (C) 1999 Richard A. Morneau
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "engine.h"
+#include "nameindex.h"
+#include "namplavars.h"
+#include "shipvars.h"
+#include "speciesio.h"
+
+// the letters of a name are counted in this many buckets
+#define NAME_BUCKETS 64
+
+#define KIND_NAMPLA 0
+#define KIND_SHIP   1
+
+
+// the names of the ships or of the named planets of one species
+typedef struct {
+    int num_names;                       // number of records indexed
+    int max_names;
+    char (*upper)[32];                   // upper case copy of the name of each record
+    uint8_t (*letters)[NAME_BUCKETS];    // number of times each letter appears in the upper case name
+    int table_size;                      // always a power of two
+    int table_used;
+    int *table;                          // index of the record plus one, or zero if the slot is empty
+} name_list_t;
+
+static struct {
+    int indexed[MAX_SPECIES];
+    name_list_t list[MAX_SPECIES][2];    // indexed by KIND_NAMPLA or KIND_SHIP
+} names;
+
+
+static int nameBest(int kind, int species_index, const char *upper_name, int *best_score, int *next_best_score);
+
+static int nameFind(int kind, int species_index, const char *upper_name);
+
+static unsigned nameHash(const char *upper_name);
+
+static void nameIndexSpecies(int species_index);
+
+static void nameInsert(name_list_t *list, int index);
+
+static void namePlace(name_list_t *list, int index, const char *name);
+
+static int nameRecords(int kind, int species_index);
+
+static int nameUnused(int kind, int species_index, int index);
+
+
+// nameIndexBestNampla finds the named planet whose name is the closest match for a misspelled name.
+// It scores every name with agrep_score, in the same order as the planet array, and returns the index
+// of the first planet with the best score or -1 if the species has no named planets.
+int nameIndexBestNampla(int species_index, const char *upper_name, int *best_score, int *next_best_score) {
+    return nameBest(KIND_NAMPLA, species_index, upper_name, best_score, next_best_score);
+}
+
+
+// nameIndexBestShip finds the ship whose name is the closest match for a misspelled name.
+// It works the same way as nameIndexBestNampla.
+int nameIndexBestShip(int species_index, const char *upper_name, int *best_score, int *next_best_score) {
+    return nameBest(KIND_SHIP, species_index, upper_name, best_score, next_best_score);
+}
+
+
+// nameIndexFindNampla returns the index of the first named planet with the upper case name, or -1 if there isn't one.
+int nameIndexFindNampla(int species_index, const char *upper_name) {
+    return nameFind(KIND_NAMPLA, species_index, upper_name);
+}
+
+
+// nameIndexFindShip returns the index of the first ship with the upper case name, or -1 if there isn't one.
+int nameIndexFindShip(int species_index, const char *upper_name) {
+    return nameFind(KIND_SHIP, species_index, upper_name);
+}
+
+
+// nameIndexPlaceNampla must be called whenever a named planet is created or renamed.
+void nameIndexPlaceNampla(int species_index, int nampla_index) {
+    if (!names.indexed[species_index]) {
+        return;  // the name will be found when the species is indexed
+    }
+    name_list_t *list = &names.list[species_index][KIND_NAMPLA];
+    for (int i = list->num_names; i < nampla_index; i++) {
+        namePlace(list, i, namp_data[species_index][i].name);
+    }
+    namePlace(list, nampla_index, namp_data[species_index][nampla_index].name);
+}
+
+
+// nameIndexPlaceShip must be called whenever a ship is created or renamed.
+void nameIndexPlaceShip(int species_index, int ship_index) {
+    if (!names.indexed[species_index]) {
+        return;  // the name will be found when the species is indexed
+    }
+    name_list_t *list = &names.list[species_index][KIND_SHIP];
+    for (int i = list->num_names; i < ship_index; i++) {
+        namePlace(list, i, ship_data[species_index][i].name);
+    }
+    namePlace(list, ship_index, ship_data[species_index][ship_index].name);
+}
+
+
+// nameIndexReset throws the index away. Each species is indexed again when its names are next looked up.
+void nameIndexReset(void) {
+    for (int species_index = 0; species_index < MAX_SPECIES; species_index++) {
+        for (int kind = KIND_NAMPLA; kind <= KIND_SHIP; kind++) {
+            name_list_t *list = &names.list[species_index][kind];
+            free(list->upper);
+            free(list->letters);
+            free(list->table);
+            memset(list, 0, sizeof(name_list_t));
+        }
+        names.indexed[species_index] = FALSE;
+    }
+}
+
+
+// nameBest scores the names of a species against a misspelled name, exactly as a linear
+// scan with agrep_score would. agrep_score only scores letters that appear in both names,
+// so a name that can't share enough letters with the misspelled one to beat the best score
+// so far is skipped without being scored. Skipped names would have scored lower than the
+// best, so they can't change the result or make the next best score equal to the best.
+static int nameBest(int kind, int species_index, const char *upper_name, int *best_score, int *next_best_score) {
+    nameIndexSpecies(species_index);
+    name_list_t *list = &names.list[species_index][kind];
+
+    // count the letters in the misspelled name
+    uint8_t letters[NAME_BUCKETS] = {0};
+    int bucket[32], num_buckets = 0;
+    for (const char *p = upper_name; *p != 0; p++) {
+        int b = (unsigned char) *p % NAME_BUCKETS;
+        if (letters[b]++ == 0) {
+            bucket[num_buckets++] = b;
+        }
+    }
+
+    int best_index = -1;
+    *best_score = -9999;
+    *next_best_score = -9999;
+    int num_records = nameRecords(kind, species_index);
+    for (int i = 0; i < num_records; i++) {
+        if (nameUnused(kind, species_index, i)) {
+            continue;
+        }
+
+        // the score can't be more than the number of letters the names have in common
+        int most = 0;
+        for (int j = 0; j < num_buckets; j++) {
+            int b = bucket[j];
+            most += letters[b] < list->letters[i][b] ? letters[b] : list->letters[i][b];
+        }
+        if (most < *best_score && strcmp(list->upper[i], upper_name) != 0) {
+            continue;
+        }
+
+        int n = agrep_score(list->upper[i], (char *) upper_name);
+        if (n > *best_score) {
+            /* Best match so far. */
+            *best_score = n;
+            best_index = i;
+        } else if (n > *next_best_score) {
+            *next_best_score = n;
+        }
+    }
+    return best_index;
+}
+
+
+// nameFind returns the lowest index of a record in use with the upper case name, or -1 if there isn't one.
+static int nameFind(int kind, int species_index, const char *upper_name) {
+    nameIndexSpecies(species_index);
+    name_list_t *list = &names.list[species_index][kind];
+
+    int found = -1;
+    if (list->table_size == 0) {
+        return found;
+    }
+    unsigned slot = nameHash(upper_name) & (list->table_size - 1);
+    for (; list->table[slot] != 0; slot = (slot + 1) & (list->table_size - 1)) {
+        int index = list->table[slot] - 1;
+        if (found >= 0 && index > found) {
+            continue;
+        }
+        // the slot may be left over from a record that has since been renamed or deleted
+        if (strcmp(list->upper[index], upper_name) != 0 || nameUnused(kind, species_index, index)) {
+            continue;
+        }
+        found = index;
+    }
+    return found;
+}
+
+
+// nameHash returns the FNV-1a hash of the name.
+static unsigned nameHash(const char *upper_name) {
+    unsigned hash = 2166136261u;
+    for (const char *p = upper_name; *p != 0; p++) {
+        hash = (hash ^ (unsigned char) *p) * 16777619u;
+    }
+    return hash;
+}
+
+
+// nameIndexSpecies indexes the names of every ship and named planet of the species.
+// Records added to the end of the arrays since the species was indexed are picked up here, too.
+static void nameIndexSpecies(int species_index) {
+    names.indexed[species_index] = TRUE;
+    for (int i = names.list[species_index][KIND_NAMPLA].num_names; i < spec_data[species_index].num_namplas; i++) {
+        nameIndexPlaceNampla(species_index, i);
+    }
+    for (int i = names.list[species_index][KIND_SHIP].num_names; i < spec_data[species_index].num_ships; i++) {
+        nameIndexPlaceShip(species_index, i);
+    }
+}
+
+
+// nameInsert adds the record to the hash table unless it is already listed under its current name.
+// The table is rebuilt from the current names when it gets more than half full, which drops the
+// slots left over from renamed records.
+static void nameInsert(name_list_t *list, int index) {
+    if (2 * (list->table_used + 1) > list->table_size) {
+        int size = list->table_size == 0 ? 64 : list->table_size;
+        while (4 * list->num_names > size) {
+            size *= 2;
+        }
+        free(list->table);
+        list->table = (int *) ncalloc(__FUNCTION__, __LINE__, size, sizeof(int));
+        list->table_size = size;
+        list->table_used = 0;
+        for (int i = 0; i < list->num_names; i++) {
+            if (i != index) {
+                nameInsert(list, i);
+            }
+        }
+    }
+
+    unsigned slot = nameHash(list->upper[index]) & (list->table_size - 1);
+    for (; list->table[slot] != 0; slot = (slot + 1) & (list->table_size - 1)) {
+        if (list->table[slot] == index + 1) {
+            return;
+        }
+    }
+    list->table[slot] = index + 1;
+    list->table_used++;
+}
+
+
+// namePlace records the name of a record and adds it to the hash table.
+static void namePlace(name_list_t *list, int index, const char *name) {
+    if (index >= list->max_names) {
+        int size = list->max_names == 0 ? 64 : list->max_names;
+        while (index >= size) {
+            size *= 2;
+        }
+        char (*upper)[32] = ncalloc(__FUNCTION__, __LINE__, size, 32);
+        uint8_t (*letters)[NAME_BUCKETS] = ncalloc(__FUNCTION__, __LINE__, size, NAME_BUCKETS);
+        if (list->num_names > 0) {
+            memcpy(upper, list->upper, list->num_names * 32);
+            memcpy(letters, list->letters, list->num_names * NAME_BUCKETS);
+        }
+        free(list->upper);
+        free(list->letters);
+        list->upper = upper;
+        list->letters = letters;
+        list->max_names = size;
+    }
+    if (index >= list->num_names) {
+        list->num_names = index + 1;
+    }
+
+    /* Make upper case copy of name. */
+    for (int i = 0; i < 32; i++) {
+        list->upper[index][i] = toupper(name[i]);
+    }
+    list->upper[index][31] = 0;
+    memset(list->letters[index], 0, NAME_BUCKETS);
+    for (const char *p = list->upper[index]; *p != 0; p++) {
+        list->letters[index][(unsigned char) *p % NAME_BUCKETS]++;
+    }
+
+    nameInsert(list, index);
+}
+
+
+// nameRecords returns the number of records of the kind that the species has.
+static int nameRecords(int kind, int species_index) {
+    return kind == KIND_SHIP ? spec_data[species_index].num_ships : spec_data[species_index].num_namplas;
+}
+
+
+// nameUnused returns TRUE if the record is not in use.
+static int nameUnused(int kind, int species_index, int index) {
+    if (kind == KIND_SHIP) {
+        return ship_data[species_index][index].pn == 99;
+    }
+    return namp_data[species_index][index].pn == 99;
+}
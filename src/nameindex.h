@@ -0,0 +1,46 @@
+// Far Horizons Game Engine
+// Copyright (C) 2022 Michael D Henderson
+// Copyright (C) 2021 Raven Zachary
+// Copyright (C) 2019 Casey Link, Adam Piggott
+// Copyright (C) 1999 Richard A. Morneau
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef FAR_HORIZONS_NAMEINDEX_H
+#define FAR_HORIZONS_NAMEINDEX_H
+
+// The name index finds a species' ships and named planets by their upper case names.
+// Each species is indexed the first time its names are looked up. The index is thrown
+// away when the species data are loaded, freed or rolled back, and it must be told
+// when a ship or named planet gets a new name.
+//
+// Unused records (pn == 99) are never returned, so deleting a ship or named planet
+// needs no update.
+
+int nameIndexBestNampla(int species_index, const char *upper_name, int *best_score, int *next_best_score);
+
+int nameIndexBestShip(int species_index, const char *upper_name, int *best_score, int *next_best_score);
+
+int nameIndexFindNampla(int species_index, const char *upper_name);
+
+int nameIndexFindShip(int species_index, const char *upper_name);
+
+void nameIndexPlaceNampla(int species_index, int nampla_index);
+
+void nameIndexPlaceShip(int species_index, int ship_index);
+
+void nameIndexReset(void);
+
+#endif //FAR_HORIZONS_NAMEINDEX_H
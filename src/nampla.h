@@ -22,10 +22,6 @@
 
 #include "engine.h"
 
-// Additional memory must be allocated for routines that name planets.
-// This is the default 'extras', which may be changed, if necessary, by the main program.
-#define NUM_EXTRA_NAMPLAS 50
-
 /* Status codes for named planets. These are logically ORed together. */
 #define HOME_PLANET        1
 #define COLONY             2
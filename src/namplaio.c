@@ -23,6 +23,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
+#include "arena.h"
 #include "data.h"
 #include "item.h"
 #include "nampla.h"
@@ -36,7 +37,7 @@ struct nampla_data *get_nampla_data(int numNamplas, int extraNamplas, FILE *fp)
     assert(planet_base != NULL);
 
     /* Allocate enough memory for all namplas. */
-    binary_nampla_data_t *binData = (binary_nampla_data_t *) ncalloc(__FUNCTION__, __LINE__, numNamplas + extraNamplas,
+    binary_nampla_data_t *binData = (binary_nampla_data_t *) arenaAlloc(__FUNCTION__, __LINE__, numNamplas + extraNamplas,
                                                                      sizeof(binary_nampla_data_t));
     if (binData == NULL) {
         perror("get_nampla_data");
@@ -90,7 +91,6 @@ struct nampla_data *get_nampla_data(int numNamplas, int extraNamplas, FILE *fp)
         nampla->star = nampla->planet->star;
     }
     /* release the binary data memory we allocated */
-    free(binData);
 
     return namplaData;
 }
@@ -183,7 +183,7 @@ void namplaDataAsSExpr(int spNo, struct nampla_data *namplaData, int num_namplas
 
 void save_nampla_data(struct nampla_data *namplaData, int numNamplas, FILE *fp) {
     /* Allocate enough memory for all namplas. */
-    binary_nampla_data_t *binData = (binary_nampla_data_t *) ncalloc(__FUNCTION__, __LINE__, numNamplas,
+    binary_nampla_data_t *binData = (binary_nampla_data_t *) arenaAlloc(__FUNCTION__, __LINE__, numNamplas,
                                                                      sizeof(binary_nampla_data_t));
     if (binData == NULL) {
         perror("save_nampla_data");
@@ -230,7 +230,6 @@ void save_nampla_data(struct nampla_data *namplaData, int numNamplas, FILE *fp)
         exit(-1);
     }
     /* release the binary data memory we allocated */
-    free(binData);
 }
 
 
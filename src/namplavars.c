@@ -21,7 +21,7 @@
 
 struct nampla_data *nampla;
 
-struct nampla_data *nampla_base;
+THREAD_LOCAL struct nampla_data *nampla_base;
 
 struct nampla_data *namp_data[MAX_SPECIES];
 
@@ -31,7 +31,6 @@ struct nampla_data *next_nampla;
 
 int next_nampla_index;
 
-// Additional memory must be allocated for routines that name planets.
-// This is the default 'extras', which may be changed, if necessary.
-int extra_namplas = NUM_EXTRA_NAMPLAS;
-int num_new_namplas[MAX_SPECIES];
+// The colony array of each species has room for max_namplas colonies.
+// It grows when a species names or is given more planets than it has room for.
+int max_namplas[MAX_SPECIES];
@@ -0,0 +1,196 @@
+// Far Horizons Game Engine
+// Copyright (C) 2022 Michael D Henderson
+// Copyright (C) 2021 Raven Zachary
+// Copyright (C) 2019 Casey Link, Adam Piggott
+// Copyright (C) 1999 Richard A. Morneau
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "engine.h"
+#include "command.h"
+#include "commandvars.h"
+#include "ordercache.h"
+
+
+typedef struct {
+    char keyword[4];
+    int first_line;  // index of the first line after the START order
+} order_section_t;
+
+typedef struct {
+    int num_lines;
+    char **line;  // each line exactly as readln returned it
+    int num_sections;
+    order_section_t *section;
+} order_file_t;
+
+
+// orderFile[n] is the cached orders for species n+1; NULL if there is no orders file
+static order_file_t *orderFile[MAX_SPECIES];
+static int orderFileLoaded[MAX_SPECIES];
+
+// the file being read and the index of the next line to return
+static order_file_t *current;
+static int nextLine;
+
+
+static order_file_t *loadOrderFile(const char *filename);
+
+static void scanOrderFile(order_file_t *of, const char *filename);
+
+
+// ordersOpen makes the orders for the species current.
+// Returns FALSE if the species has no orders file.
+int ordersOpen(int species_number) {
+    int i = species_number - 1;
+    if (!orderFileLoaded[i]) {
+        char filename[128];
+        sprintf(filename, "sp%02d.ord", species_number);
+        orderFile[i] = loadOrderFile(filename);
+        orderFileLoaded[i] = TRUE;
+        if (orderFile[i] != NULL) {
+            scanOrderFile(orderFile[i], filename);
+        }
+    }
+    current = orderFile[i];
+    nextLine = 0;
+    return current != NULL;
+}
+
+
+// ordersFind positions the reader on the first order after the first
+// START order whose keyword matches. Returns FALSE if there is no such section.
+int ordersFind(const char *keyword) {
+    for (int i = 0; current != NULL && i < current->num_sections; i++) {
+        if (strcmp(current->section[i].keyword, keyword) == 0) {
+            nextLine = current->section[i].first_line;
+            end_of_file = FALSE;
+            just_opened_file = FALSE;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+
+void ordersClose(void) {
+    current = NULL;
+    nextLine = 0;
+}
+
+
+// ordersReadln is the replacement for readln on an orders file.
+// Like readln, it copies the line into dst but returns a pointer to its own
+// buffer, which the command parser is free to scribble on.
+char *ordersReadln(char *dst, int len) {
+    static char buf[1024];
+    if (current == NULL || nextLine >= current->num_lines) {
+        return NULL;
+    }
+    memset(buf, 0, sizeof(buf));
+    strcpy(buf, current->line[nextLine]);
+    nextLine++;
+    for (int i = 0; i < len; i++) {
+        dst[i] = buf[i];
+    }
+    dst[len - 1] = 0;
+    return buf;
+}
+
+
+// ordersLineNumber returns the line number of the last line read.
+int ordersLineNumber(void) {
+    return nextLine;
+}
+
+
+static order_file_t *loadOrderFile(const char *filename) {
+    FILE *fp = fopen(filename, "r");
+    if (fp == NULL) {
+        return NULL;
+    }
+
+    /* Size everything with one pass so the text can go in a single block. */
+    char line[1024];
+    int numLines = 0;
+    size_t textLength = 0;
+    while (readln(line, 1024, fp) != NULL) {
+        numLines++;
+        textLength += strlen(line) + 1;
+    }
+    rewind(fp);
+
+    order_file_t *of = ncalloc(__FUNCTION__, __LINE__, 1, sizeof(order_file_t));
+    of->line = ncalloc(__FUNCTION__, __LINE__, numLines + 1, sizeof(char *));
+    of->section = ncalloc(__FUNCTION__, __LINE__, numLines + 1, sizeof(order_section_t));
+    char *text = ncalloc(__FUNCTION__, __LINE__, (int) textLength + 1, 1);
+    while (of->num_lines < numLines && readln(line, 1024, fp) != NULL) {
+        strcpy(text, line);
+        of->line[of->num_lines] = text;
+        of->num_lines++;
+        text += strlen(line) + 1;
+    }
+    fclose(fp);
+
+    return of;
+}
+
+
+// scanOrderFile runs the command parser over the whole file once, skipping
+// MESSAGE text, and records the start of every section.
+// Only the first section with a given keyword is used.
+static void scanOrderFile(order_file_t *of, const char *filename) {
+    current = of;
+    nextLine = 0;
+    end_of_file = FALSE;
+    just_opened_file = TRUE;    /* Tell command parser to skip mail header, if any. */
+
+    for (int command = get_command(); command >= 0; command = get_command()) {
+        if (command == MESSAGE) {
+            /* Skip MESSAGE text. It may contain a line that starts with "start". */
+            int messageLine = ordersLineNumber();
+            do {
+                command = get_command();
+            } while (command >= 0 && command != ZZZ);
+            if (command < 0) {
+                fprintf(stderr, "WARNING: Unterminated MESSAGE command at line %d in file %s!\n", messageLine,
+                        filename);
+                break;
+            }
+            continue;
+        }
+        if (command != START) {
+            continue;
+        }
+
+        /* Get the first three letters of the keyword and convert to upper case. */
+        skip_whitespace();
+        char keyword[4] = {0, 0, 0, 0};
+        for (int i = 0; i < 3 && *input_line_pointer != 0; i++) {
+            keyword[i] = (char) toupper(*input_line_pointer);
+            input_line_pointer++;
+        }
+        order_section_t *section = &of->section[of->num_sections];
+        strcpy(section->keyword, keyword);
+        section->first_line = nextLine;
+        of->num_sections++;
+    }
+
+    current = NULL;
+    nextLine = 0;
+}
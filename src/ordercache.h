@@ -0,0 +1,40 @@
+// Far Horizons Game Engine
+// Copyright (C) 2022 Michael D Henderson
+// Copyright (C) 2021 Raven Zachary
+// Copyright (C) 2019 Casey Link, Adam Piggott
+// Copyright (C) 1999 Richard A. Morneau
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef FAR_HORIZONS_ORDERCACHE_H
+#define FAR_HORIZONS_ORDERCACHE_H
+
+// Each spNN.ord file is read and scanned only once per process.
+// The scan skips the mail header and MESSAGE text and remembers where every
+// START section begins, so a phase can go straight to its own orders.
+// While a file is open, skip_junk and do_MESSAGE_command read their lines
+// from the cache instead of from disk.
+
+int ordersOpen(int species_number);
+
+int ordersFind(const char *keyword);
+
+void ordersClose(void);
+
+char *ordersReadln(char *dst, int len);
+
+int ordersLineNumber(void);
+
+#endif //FAR_HORIZONS_ORDERCACHE_H
@@ -17,9 +17,12 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <fcntl.h>
 #include <sys/stat.h>
 #include <stdlib.h>
+#include <unistd.h>
 #include "engine.h"
+#include "fileappend.h"
 #include "galaxyio.h"
 #include "locationio.h"
 #include "nampla.h"
@@ -95,7 +98,6 @@ void NoOrdersForSpecies(void) {
     int production_penalty;
     char filename[32];
     char *random_name();
-    char message_line[132];
     long n;
     long nn;
     long raw_material_units;
@@ -107,7 +109,7 @@ void NoOrdersForSpecies(void) {
     long AUs_needed;
     long EUs;
     long bit_mask;
-    FILE *message_file;
+    int message_fd;
     FILE *log_file;
     struct species_data *alien;
     struct nampla_data *nampla;
@@ -134,8 +136,8 @@ void NoOrdersForSpecies(void) {
 
     /* Open message file. */
     sprintf(filename, "noorders.txt");
-    message_file = fopen(filename, "r");
-    if (message_file == NULL) {
+    message_fd = open(filename, O_RDONLY);
+    if (message_fd < 0) {
         fprintf(stderr, "\n\tCannot open '%s' for reading!\n\n", filename);
         exit(2);;
     }
@@ -149,11 +151,9 @@ void NoOrdersForSpecies(void) {
     }
 
     /* Copy message to log file. */
-    while (readln(message_line, 131, message_file) != NULL) {
-        fputs(message_line, log_file);
-    }
+    fileAppend(log_file, message_fd, "noorders.txt");
 
-    fclose(message_file);
+    close(message_fd);
     fclose(log_file);
 
     /* Open orders file for writing. */
@@ -20,10 +20,15 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
+#include "arena.h"
 #include "data.h"
+#include "datafile.h"
 #include "engine.h"
+#include "fileimage.h"
 #include "planet.h"
 #include "planetio.h"
+#include "resident.h"
 #include "stario.h"
 
 int num_planets;
@@ -32,13 +37,40 @@ struct planet_data *planet_base;
 
 int planet_data_modified;
 
+// format of planets.dat when it was loaded; saves keep the same format
+int planet_data_version = 1;
+
+// backs planet_base when a version 2 file is used in place
+static datafile_t planetFile;
+
+// planets.dat as it was loaded, so saves only write the planets that changed
+static file_image_t planetImage;
+
+
+static int getPlanetDataV2(void);
+
+static void linkPlanets(void);
+
 
 void get_planet_data(void) {
     int32_t numPlanets;
     binary_planet_data_t *planetData;
 
+    if (galaxy_resident) {
+        residentGetPlanetData();
+        return;
+    }
+
+    datafileClose(&planetFile);
+    if (getPlanetDataV2()) {
+        linkPlanets();
+        planet_data_version = 2;
+        planet_data_modified = FALSE;
+        return;
+    }
+
     /* Open planet file. */
-    FILE *fp = fopen("planets.dat", "rb");
+    FILE *fp = fileImageOpen(&planetImage, "planets.dat");
     if (fp == NULL) {
         perror("get_planet_data");
         fprintf(stderr, "\n\tCannot open file planets.dat!\n");
@@ -50,7 +82,7 @@ void get_planet_data(void) {
         exit(-1);
     }
     /* Allocate enough memory for all planets. */
-    planetData = (binary_planet_data_t *) ncalloc(__FUNCTION__, __LINE__, numPlanets + NUM_EXTRA_PLANETS, sizeof(binary_planet_data_t));
+    planetData = (binary_planet_data_t *) arenaAlloc(__FUNCTION__, __LINE__, numPlanets + NUM_EXTRA_PLANETS, sizeof(binary_planet_data_t));
     if (planetData == NULL) {
         fprintf(stderr, "\nCannot allocate enough memory for planet file!\n");
         fprintf(stderr, "\n\tattempted to allocate %d + %d planet entries\n\n", numPlanets, NUM_EXTRA_PLANETS);
@@ -94,7 +126,42 @@ void get_planet_data(void) {
         p->index = i;
     }
 
-    // mdhender: added fields to help clean up code
+    linkPlanets();
+    planet_data_version = 1;
+
+    planet_data_modified = FALSE;
+}
+
+
+// getPlanetDataV2 loads planets.dat if it is a version 2 file.
+// Returns FALSE if it is not.
+static int getPlanetDataV2(void) {
+    datafile_t df;
+    if (!datafileOpen("planets.dat", &df)) {
+        return FALSE;
+    }
+    struct planet_data *records = datafileSection(&df, 0, sizeof(struct planet_data), &num_planets);
+    if (map_data_in_place) {
+        planet_base = records;
+        planetFile = df;
+        fileImageForget(&planetImage);
+    } else {
+        planet_base = (struct planet_data *) ncalloc(__FUNCTION__, __LINE__, num_planets + NUM_EXTRA_PLANETS, sizeof(struct planet_data));
+        memcpy(planet_base, records, num_planets * sizeof(struct planet_data));
+        fileImageRemember(&planetImage, "planets.dat", df.base, df.length);
+        datafileClose(&df);
+    }
+    for (int i = 0; i < num_planets; i++) {
+        planet_base[i].id = i + 1;
+        planet_base[i].index = i;
+    }
+    return TRUE;
+}
+
+
+// linkPlanets points every planet back at the star it orbits.
+// Stars must already be loaded; planets are left unlinked if they are not.
+static void linkPlanets(void) {
     for (int sn = 0; sn < num_stars; sn++) {
         star_data_t *star = star_base + sn;
         for (int pn = 0; pn < star->num_planets; pn++) {
@@ -103,10 +170,6 @@ void get_planet_data(void) {
             p->orbit = pn + 1;
         }
     }
-
-    planet_data_modified = FALSE;
-
-    free(planetData);
 }
 
 
@@ -128,7 +191,7 @@ planet_data_t *getPlanetData(int extraRecords, const char *filename) {
     }
 
     // allocate enough memory for all records
-    binary_planet_data_t *rawRecords = (binary_planet_data_t *) ncalloc(__FUNCTION__, __LINE__, numRecords, sizeof(binary_planet_data_t));
+    binary_planet_data_t *rawRecords = (binary_planet_data_t *) arenaAlloc(__FUNCTION__, __LINE__, numRecords, sizeof(binary_planet_data_t));
     if (rawRecords == NULL) {
         fprintf(stderr, "\nCannot allocate enough memory for planet file '%s'!\n", filename);
         exit(-1);
@@ -173,8 +236,6 @@ planet_data_t *getPlanetData(int extraRecords, const char *filename) {
         p->isValid = FALSE;
     }
 
-    free(rawRecords);
-
     return planetBase;
 }
 
@@ -232,9 +293,20 @@ void planetDataAsSExpr(planet_data_t *planetBase, int numPlanets, FILE *fp) {
 
 
 void save_planet_data(void) {
-    FILE *fp;
+    if (galaxy_resident) {
+        residentSavePlanetData();
+        planet_data_modified = FALSE;
+        return;
+    }
+
+    if (planet_data_version == 2) {
+        savePlanetDataV2(planet_base, num_planets, "planets.dat", &planetImage);
+        planet_data_modified = FALSE;
+        return;
+    }
+
     int32_t numPlanets = num_planets;
-    binary_planet_data_t *planetData = (binary_planet_data_t *) ncalloc(__FUNCTION__, __LINE__, numPlanets, sizeof(binary_planet_data_t));
+    binary_planet_data_t *planetData = (binary_planet_data_t *) arenaAlloc(__FUNCTION__, __LINE__, numPlanets, sizeof(binary_planet_data_t));
     if (planetData == NULL) {
         fprintf(stderr, "\nCannot allocate enough memory for planet file!\n");
         fprintf(stderr, "\n\tattempted to allocate %d planet entries\n\n", numPlanets);
@@ -258,36 +330,22 @@ void save_planet_data(void) {
         pd->message = p->message;
     }
 
-    /* Open planet file for writing. */
-    fp = fopen("planets.dat", "wb");
-    if (fp == NULL) {
-        perror("save_planet_data");
-        fprintf(stderr, "\n\tCannot create file 'planets.dat'!\n");
-        exit(-1);
-    }
-    /* Write header data. */
-    if (fwrite(&numPlanets, sizeof(numPlanets), 1, fp) != 1) {
-        perror("save_planet_data");
-        fprintf(stderr, "\n\tCannot write num_planets to file 'planets.dat'!\n\n");
-        exit(-1);
-    }
-    /* Write planet data to disk. */
-    if (fwrite(planetData, sizeof(binary_planet_data_t), numPlanets, fp) != numPlanets) {
-        perror("save_planet_data");
-        fprintf(stderr, "\nCannot write planet data to disk!\n\n");
-        exit(-1);
-    }
-    fclose(fp);
+    /* Write only the planets that changed since the file was loaded. */
+    size_t length = sizeof(numPlanets) + numPlanets * sizeof(binary_planet_data_t);
+    unsigned char *image = (unsigned char *) ncalloc(__FUNCTION__, __LINE__, (int) length, 1);
+    memcpy(image, &numPlanets, sizeof(numPlanets));
+    memcpy(image + sizeof(numPlanets), planetData, numPlanets * sizeof(binary_planet_data_t));
+    file_records_t records[1] = {{sizeof(numPlanets), sizeof(binary_planet_data_t), numPlanets}};
+    fileImageWrite(&planetImage, "planets.dat", image, length, 1, records);
+    free(image);
 
     planet_data_modified = FALSE;
-
-    free(planetData);
 }
 
 
 void savePlanetData(planet_data_t *planetBase, int numPlanets, const char *filename) {
     int32_t numRecords = numPlanets;
-    binary_planet_data_t *planetData = (binary_planet_data_t *) ncalloc(__FUNCTION__, __LINE__, numRecords, sizeof(binary_planet_data_t));
+    binary_planet_data_t *planetData = (binary_planet_data_t *) arenaAlloc(__FUNCTION__, __LINE__, numRecords, sizeof(binary_planet_data_t));
     if (planetData == NULL) {
         fprintf(stderr, "error: cannot allocate enough memory for planet file '%s'!\n", filename);
         fprintf(stderr, "       attempted to allocate %d planet records\n", numRecords);
@@ -331,6 +389,21 @@ void savePlanetData(planet_data_t *planetBase, int numPlanets, const char *filen
         exit(2);
     }
     fclose(fp);
-    free(planetData);
 }
 
+
+// savePlanetDataV2 writes the planets as a version 2 file.
+// fi, if not NULL, is the file as it was loaded.
+void savePlanetDataV2(planet_data_t *planetBase, int numPlanets, const char *filename, file_image_t *fi) {
+    planet_data_t *records = (planet_data_t *) ncalloc(__FUNCTION__, __LINE__, numPlanets + 1, sizeof(planet_data_t));
+    memcpy(records, planetBase, numPlanets * sizeof(planet_data_t));
+    for (int i = 0; i < numPlanets; i++) {
+        records[i].star = NULL;
+        records[i].orbit = 0;
+    }
+    void *sections[1] = {records};
+    int recordSize[1] = {sizeof(planet_data_t)};
+    int numRecords[1] = {numPlanets};
+    datafileWrite(filename, fi, 1, sections, recordSize, numRecords);
+    free(records);
+}
@@ -20,6 +20,7 @@
 #ifndef FAR_HORIZONS_PLANETIO_H
 #define FAR_HORIZONS_PLANETIO_H
 
+#include "fileimage.h"
 #include "planet.h"
 
 void get_planet_data(void);
@@ -34,10 +35,13 @@ void save_planet_data(void);
 
 void savePlanetData(planet_data_t *planetBase, int numPlanets, const char *filename);
 
+void savePlanetDataV2(planet_data_t *planetBase, int numPlanets, const char *filename, file_image_t *fi);
+
 // globals. ugh.
 
 extern int num_planets;
 extern struct planet_data *planet_base;
 extern int planet_data_modified;
+extern int planet_data_version;
 
 #endif //FAR_HORIZONS_PLANETIO_H
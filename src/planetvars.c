@@ -22,6 +22,6 @@
 
 char gas_string[14][4] = {"   ", "H2", "CH4", "He", "NH3", "N2", "CO2", "O2", "HCl", "Cl2", "F2", "H2O", "SO2", "H2S"};
 
-struct planet_data *home_planet;
+THREAD_LOCAL struct planet_data *home_planet;
 
-struct planet_data *planet;
+THREAD_LOCAL struct planet_data *planet;
@@ -20,12 +20,13 @@
 #ifndef FAR_HORIZONS_PLANETVARS_H
 #define FAR_HORIZONS_PLANETVARS_H
 
+#include "engine.h"
 #include "planet.h"
 
 // globals. ugh.
 
 extern char gas_string[14][4];
-extern struct planet_data *home_planet;
-extern struct planet_data *planet;
+extern THREAD_LOCAL struct planet_data *home_planet;
+extern THREAD_LOCAL struct planet_data *planet;
 
 #endif //FAR_HORIZONS_PLANETVARS_H
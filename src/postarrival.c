@@ -24,15 +24,19 @@
 #include "command.h"
 #include "engine.h"
 #include "shipvars.h"
+#include "snapshot.h"
 #include "enginevars.h"
 #include "speciesvars.h"
 #include "logvars.h"
 #include "commandvars.h"
 #include "do.h"
 #include "log.h"
+#include "logsink.h"
 #include "galaxyio.h"
 #include "stario.h"
+#include "ordercache.h"
 #include "planetio.h"
+#include "prng.h"
 #include "transactionio.h"
 #include "speciesio.h"
 #include "namplavars.h"
@@ -41,10 +45,6 @@
 void do_postarrival_orders(void) {
     int command;
 
-    if (first_pass) {
-        printf("\nStart of post-arrival orders for species #%d, SP %s...\n", species_number, species->name);
-    }
-
     /* For these commands, do not display age or landed/orbital status of ships. */
     truncate_name = TRUE;
 
@@ -58,10 +58,6 @@ void do_postarrival_orders(void) {
         }
 
         if (end_of_file || command == END) {
-            if (first_pass) {
-                printf("End of post-arrival orders for species #%d, SP %s.\n", species_number, species->name);
-            }
-            if (first_pass) { gamemaster_abort_option(); }
             break;            /* END for this species. */
         }
 
@@ -134,7 +130,8 @@ void do_postarrival_orders(void) {
 
 
 int postArrivalCommand(int argc, char *argv[]) {
-    int num_species, sp_num[MAX_SPECIES], sp_index, command, do_all_species;
+    int num_species, sp_num[MAX_SPECIES], sp_index, do_all_species;
+    int preview = FALSE;
 
     /* Get commonly used data. */
     get_galaxy_data();
@@ -145,18 +142,16 @@ int postArrivalCommand(int argc, char *argv[]) {
     ignore_field_distorters = TRUE;
 
     /* Check arguments.
-     * If an argument is -p, then do two passes.
-     * In the first pass, display results and prompt the GM, allowing him
+     * If an argument is -p, then display results and prompt the GM, allowing him
      * to abort if necessary before saving results to disk.
      * All other arguments must be species numbers.
      * If no species numbers are specified, then do all species. */
     num_species = 0;
-    first_pass = FALSE;
     test_mode = FALSE;
     verbose_mode = FALSE;
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-p") == 0) {
-            first_pass = TRUE;
+            preview = TRUE;
         } else if (strcmp(argv[i], "-t") == 0) {
             test_mode = TRUE;
         } else if (strcmp(argv[i], "-v") == 0) {
@@ -192,19 +187,12 @@ int postArrivalCommand(int argc, char *argv[]) {
         }
     }
 
-    /* Two passes through all orders will be done.
-     * The first pass will check for errors and abort if any are found.
-     * Results will be written to disk only on the second pass. */
-
-    start_pass:
-
-    if (first_pass) {
-        printf("\nStarting first pass...\n\n");
-    }
-
-    get_star_data();
-    get_planet_data();
+    /* When previewing, the results are held until the GM has seen them.
+     * If the GM aborts, nothing is written to disk. */
     get_species_data();
+    if (preview) {
+        snapshotTake();
+    }
 
     /* Main loop. For each species, take appropriate action. */
     for (sp_index = 0; sp_index < num_species; sp_index++) {
@@ -214,7 +202,7 @@ int postArrivalCommand(int argc, char *argv[]) {
         int found = data_in_memory[species_index];
         if (!found) {
             if (do_all_species) {
-                if (first_pass) { printf("\n    Skipping species #%d.\n", species_number); }
+                if (preview) { printf("\n    Skipping species #%d.\n", species_number); }
                 continue;
             } else {
                 fprintf(stderr, "\n    Cannot get data for species #%d!\n",
@@ -233,10 +221,9 @@ int postArrivalCommand(int argc, char *argv[]) {
         /* Open orders file for this species. */
         char filename[128];
         sprintf(filename, "sp%02d.ord", species_number);
-        input_file = fopen(filename, "r");
-        if (input_file == NULL) {
+        if (!ordersOpen(species_number)) {
             if (do_all_species) {
-                if (first_pass) {
+                if (preview) {
                     printf("\n    No orders for species #%d.\n", species_number);
                 }
                 continue;
@@ -246,75 +233,20 @@ int postArrivalCommand(int argc, char *argv[]) {
             }
         }
 
-        end_of_file = FALSE;
-
-        /* Tell command parser to skip mail header, if any. */
-        just_opened_file = TRUE;
-
-        find_start:
-
         /* Search for START POST-ARRIVAL order. */
-        found = FALSE;
-        while (!found) {
-            command = get_command();
-            if (command == MESSAGE) {
-                /* Skip MESSAGE text. It may contain a line that starts with "start". */
-                while (TRUE) {
-                    command = get_command();
-                    if (command < 0) {
-                        fprintf(stderr, "WARNING: Unterminated MESSAGE command in file %s!\n", filename);
-                        break;
-                    }
-
-                    if (command == ZZZ) {
-                        goto find_start;
-                    }
-                }
-            }
-
-            if (command < 0) {
-                /* End of file. */
-                break;
-            }
-
-            if (command != START) {
-                continue;
-            }
-
-            /* Get the first three letters of the keyword and convert to upper case. */
-            skip_whitespace();
-            char keyword[4] = {0, 0, 0, 0};
-            for (int i = 0; i < 3 && *input_line_pointer != 0; i++) {
-                keyword[i] = (char) toupper(*input_line_pointer);
-                input_line_pointer++;
-            }
-
-            if (strcmp(keyword, "POS") == 0) {
-                found = TRUE;
-            }
-        }
+        found = ordersFind("POS");
 
         if (!found) {
-            if (first_pass) {
+            if (preview) {
                 printf("\nNo post-arrival orders for species #%d, SP %s.\n", species_number, species->name);
             }
             goto done_orders;
         }
 
-        /* Open log file. Use stdout for first pass. */
+        /* Open log file for appending. */
         log_stdout = FALSE;  /* We will control value of log_file from here. */
-        if (first_pass) {
-            log_file = stdout;
-        } else {
-            /* Open log file for appending. */
-            sprintf(filename, "sp%02d.log", species_number);
-            log_file = fopen(filename, "a");
-            if (log_file == NULL) {
-                fprintf(stderr, "\n\tCannot open '%s' for appending!\n\n", filename);
-                exit(2);
-            }
-            log_string("\nPost-arrival orders:\n");
-        }
+        log_file = logSinkOpen(species_number);
+        log_string("\nPost-arrival orders:\n");
 
         /* For each ship, set dest_z to zero.
          * If a starbase is used as a gravitic telescope, it will be set to non-zero.
@@ -325,39 +257,25 @@ int postArrivalCommand(int argc, char *argv[]) {
             ship++;
         }
 
-        /* Handle post-arrival orders for this species. */
+        /* Handle post-arrival orders for this species, drawing from its own stream of random numbers. */
+        prngUseStream("post-arrival", galaxy.turn_number, species_number);
         do_postarrival_orders();
+        prngUseGlobal();
 
         data_modified[species_index] = TRUE;
 
-        /* If this is the second pass, close the log file. */
-        if (!first_pass) {
-            fclose(log_file);
-        }
-
         done_orders:
 
-        fclose(input_file);
+        ordersClose();
     }
 
-    if (first_pass) {
-        printf("\nFinal chance to abort safely!\n");
-        gamemaster_abort_option();
-        first_pass = FALSE;
+    if (preview && !snapshotPreview()) {
         free_species_data();
-        /* In case data was modified. */
-        if (planet_base != NULL) {
-            free(planet_base);
-            planet_base = NULL;
-        }
-        if (star_base != NULL) {
-            free(star_base);
-            star_base = NULL;
-        }
-
-        printf("\nStarting second pass...\n\n");
-
-        goto start_pass;
+        free(planet_base);
+        planet_base = NULL;
+        free(star_base);
+        star_base = NULL;
+        return 0;
     }
 
     save_species_data();
@@ -368,6 +286,7 @@ int postArrivalCommand(int argc, char *argv[]) {
     if (planet_data_modified) {
         save_planet_data();
     }
+    logSinkFlush();
     free_species_data();
     free(planet_base);
     planet_base = NULL;
@@ -28,29 +28,29 @@
 #include "enginevars.h"
 #include "galaxyio.h"
 #include "logvars.h"
+#include "ordercache.h"
 #include "planetio.h"
 #include "predeparture.h"
+#include "prng.h"
 #include "shipvars.h"
+#include "snapshot.h"
 #include "speciesvars.h"
 #include "transactionio.h"
 #include "speciesio.h"
 #include "stario.h"
 #include "namplavars.h"
 #include "log.h"
+#include "logsink.h"
 
 
-int preDeparturePass(int sp_num[], int do_all_species, int first_pass);
+int preDeparturePass(int sp_num[], int do_all_species, int preview);
 
-int preDepartureSpecies(int spNo, int do_all_species, int first_pass);
+int preDepartureSpecies(int spNo, int do_all_species, int preview);
 
 
 void do_predeparture_orders(void) {
     int i, command, old_test_mode;
 
-    if (first_pass) {
-        printf("\nStart of pre-departure orders for species #%d, SP %s...\n", species_number, species->name);
-    }
-
     truncate_name = TRUE;    /* For these commands, do not display age or landed/orbital status of ships. */
 
     while (TRUE) {
@@ -64,14 +64,6 @@ void do_predeparture_orders(void) {
         }
 
         if (end_of_file || command == END) {
-            if (first_pass) {
-                printf("End of pre-departure orders for species #%d, SP %s.\n", species_number, species->name);
-            }
-
-            if (first_pass) {
-                gamemaster_abort_option();
-            }
-
             break;            /* END for this species. */
         }
 
@@ -143,6 +135,7 @@ void do_predeparture_orders(void) {
 int preDepartureCommand(int argc, char *argv[]) {
     int do_all_species = TRUE;
     int dryRun = FALSE;
+    int preview = FALSE;
     int num_species = 0;
     int sp_num[MAX_SPECIES];
     memset(sp_num, 0, sizeof(sp_num));
@@ -157,8 +150,7 @@ int preDepartureCommand(int argc, char *argv[]) {
     ignore_field_distorters = TRUE;
 
     /* Check arguments.
-     * If an argument is -p, then do two passes.
-     * In the first pass, display results and prompt the GM,
+     * If an argument is -p, then display results and prompt the GM,
      * allowing the GM to abort if necessary before saving results to disk.
      * If an argument is -t, then set test mode.
      * All other arguments must be species numbers.
@@ -181,14 +173,14 @@ int preDepartureCommand(int argc, char *argv[]) {
             return 2;
         } else if (strcmp(opt, "-p") == 0 && val == NULL) {
             dryRun = TRUE;
-            first_pass = TRUE;
+            preview = TRUE;
         } else if (strcmp(opt, "-t") == 0 && val == NULL) {
             test_mode = TRUE;
         } else if (strcmp(opt, "-v") == 0 && val == NULL) {
             verbose_mode = TRUE;
         } else if (strcmp(opt, "--dry-run") == 0 && val == NULL) {
             dryRun = TRUE;
-            first_pass = TRUE;
+            preview = TRUE;
         } else if (strcmp(opt, "--test") == 0 && val == NULL) {
             test_mode = TRUE;
         } else if (val == NULL && isdigit(*opt)) {
@@ -221,14 +213,16 @@ int preDepartureCommand(int argc, char *argv[]) {
         do_all_species = TRUE;
     }
 
-    /* Two passes through all orders will be done.
-     * The first pass will check for errors and abort if any are found.
-     * Results will be written to disk only on the second pass. */
-    if (first_pass != FALSE) {
-        printf("\nStarting first pass...\n\n");
-        preDeparturePass(sp_num, do_all_species, TRUE);
+    /* When previewing, the results are held until the GM has seen them.
+     * If the GM aborts, nothing is written to disk. */
+    get_species_data();
+    if (preview != FALSE) {
+        snapshotTake();
+    }
+    preDeparturePass(sp_num, do_all_species, preview);
+    if (preview != FALSE && snapshotPreview() == FALSE) {
+        return 0;
     }
-    preDeparturePass(sp_num, do_all_species, FALSE);
 
     // save any updates
     if (star_data_modified) {
@@ -239,16 +233,13 @@ int preDepartureCommand(int argc, char *argv[]) {
     }
     save_species_data();
     save_transaction_data();
+    logSinkFlush();
 
     return 0;
 }
 
 
-int preDeparturePass(int sp_num[], int do_all_species, int first_pass) {
-    get_star_data();
-    get_planet_data();
-    get_species_data();
-
+int preDeparturePass(int sp_num[], int do_all_species, int preview) {
     /* Main loop. For each species, take appropriate action. */
     for (int sp_index = 0; sp_index < sp_num[sp_index] != 0; sp_index++) {
         species_number = sp_num[sp_index];
@@ -260,13 +251,13 @@ int preDeparturePass(int sp_num[], int do_all_species, int first_pass) {
                 fprintf(stderr, "\n    Cannot get data for species #%d!\n", species_number);
                 return 2;
             }
-            if (first_pass != FALSE) {
+            if (preview != FALSE) {
                 printf("\n    Skipping species #%d.\n", species_number);
             }
             continue;
         }
 
-        int result = preDepartureSpecies(species_number, do_all_species, first_pass);
+        int result = preDepartureSpecies(species_number, do_all_species, preview);
         if (result != 0) {
             fprintf(stderr, "error: unable to process pre-departure errors for species #%d\n", species_number);
             return result;
@@ -277,7 +268,7 @@ int preDeparturePass(int sp_num[], int do_all_species, int first_pass) {
 }
 
 
-int preDepartureSpecies(int spNo, int do_all_species, int first_pass) {
+int preDepartureSpecies(int spNo, int do_all_species, int preview) {
     species_number = spNo;
     species_index = species_number - 1;
 
@@ -288,92 +279,41 @@ int preDepartureSpecies(int spNo, int do_all_species, int first_pass) {
     /* Open orders file for this species. */
     char filename[128];
     sprintf(filename, "sp%02d.ord", species_number);
-    input_file = fopen(filename, "r");
-    if (input_file == NULL) {
+    if (!ordersOpen(species_number)) {
         if (do_all_species == FALSE) {
             fprintf(stderr, "\n\tCannot open '%s' for reading!\n\n", filename);
             return 2;
         }
-        if (first_pass != FALSE) {
+        if (preview != FALSE) {
             printf("\n    No orders for species #%d.\n", species_number);
         }
         return 0;
     }
 
-    end_of_file = FALSE;
-    just_opened_file = TRUE;    /* Tell command parser to skip mail header, if any. */
-
     /* Search for START PRE-DEPARTURE order. */
-    int foundStart = FALSE;
-    for (int found = FALSE; found == FALSE;) {
-        int command = get_command();
-        if (command < 0) {
-            /* End of file. */
-            break;
-        } else if (command == MESSAGE) {
-            /* Skip MESSAGE text. It may contain a line that starts with "start". */
-            for (command = get_command(); command != ZZZ; command = get_command()) {
-                if (command < 0) {
-                    fprintf(stderr, "WARNING: Unterminated MESSAGE command in file '%s'!\n", filename);
-                    fclose(input_file);
-                    input_file = NULL;
-                    return 0;
-                }
-            }
-        } else if (command == START) {
-            /* Get the first three letters of the keyword and convert to upper case. */
-            skip_whitespace();
-
-            char keyword[4] = {0, 0, 0, 0};
-            for (int i = 0; i < 3; i++) {
-                keyword[i] = toupper(*input_line_pointer);
-                input_line_pointer++;
-            }
-
-            if (strcmp(keyword, "PRE") == 0) {
-                found = TRUE;
-                foundStart = TRUE;
-            }
-        }
-    }
+    int foundStart = ordersFind("PRE");
 
     if (foundStart == FALSE) {
-        if (first_pass != FALSE) {
+        if (preview != FALSE) {
             printf("\nNo pre-departure orders for species #%d, SP %s.\n", species_number, species->name);
         }
-        fclose(input_file);
-        input_file = NULL;
+        ordersClose();
         return 0;
     }
 
-    /* Open log file. Use stdout for first pass. */
+    /* Open log file for appending. */
     log_stdout = FALSE;  /* We will control value of log_file from here. */
-    if (first_pass != FALSE) {
-        log_file = stdout;
-    } else {
-        /* Open log file for appending. */
-        sprintf(filename, "sp%02d.log", species_number);
-        log_file = fopen(filename, "a");
-        if (log_file == NULL) {
-            perror("preDepartureSpecies:");
-            fprintf(stderr, "\n\tCannot open '%s' for appending!\n\n", filename);
-            exit(2);
-        }
-        log_string("\nPre-departure orders:\n");
-    }
+    log_file = logSinkOpen(species_number);
+    log_string("\nPre-departure orders:\n");
 
-    /* Handle predeparture orders for this species. */
+    /* Handle predeparture orders for this species, drawing from its own stream of random numbers. */
+    prngUseStream("pre-departure", galaxy.turn_number, species_number);
     do_predeparture_orders();
+    prngUseGlobal();
 
     data_modified[species_index] = TRUE;
 
-    /* If this is the second pass, close the log file. */
-    if (first_pass == FALSE) {
-        fclose(log_file);
-    }
-
-    fclose(input_file);
-    input_file = NULL;
+    ordersClose();
 
     return 0;
 }
\ No newline at end of file
@@ -21,39 +21,39 @@
 #include <stdlib.h>
 #include <ctype.h>
 #include <stdint.h>
+#include <string.h>
+#include "engine.h"
 #include "prng.h"
 
 
 static uint64_t prngSeed = 0;
 
+// the seed of the selected stream, or 0 when drawing from the single historical stream.
+// Each thread selects its own stream.
+static THREAD_LOCAL uint64_t streamSeed = 0;
+
+// TRUE when FH_PRNG=historical; -1 until the environment has been checked
+static int historical = -1;
+
+
+static uint64_t initialSeed(void);
+
+static int nextValue(uint64_t *seed, unsigned int max);
+
+static uint64_t splitMix(uint64_t x);
+
 
 // prng returns a random int between 1 and max, inclusive.
+// It draws from the selected stream, if there is one, otherwise from the single historical stream.
 // It uses the so-called "Algorithm M" method, which is a combination of the congruential and shift-register methods.
 int prng(unsigned int max) {
+    if (streamSeed != 0) {
+        return nextValue(&streamSeed, max);
+    }
     if (prngSeed == 0) {
-        char *envSeed = getenv("FH_SEED");
-        if (envSeed) {
-            for (; *envSeed != 0; envSeed++) {
-                if (isdigit(*envSeed)) {
-                    prngSeed = prngSeed * 10 + *envSeed - '0';
-                }
-            }
-        }
-        if (prngSeed == 0) {
-            prngSeed = 1924085713L;
-        }
+        prngSeed = initialSeed();
     }
-
-    /* For congruential method, multiply previous value by the prime number 16417. */
-    uint64_t cong_result = prngSeed + (prngSeed << 5) + (prngSeed << 14);    /* Effectively multiply by 16417. */
-
-    /* For shift-register method, use shift-right 15 and shift-left 17 with no-carry addition (i.e., exclusive-or). */
-    uint64_t shift_result = (prngSeed >> 15) ^ prngSeed;
-    shift_result ^= (shift_result << 17);
-
-    prngSeed = cong_result ^ shift_result;
-
-    return (int) (((prngSeed & 0x0000FFFF) * (uint64_t) max) >> 16) + 1L;
+    return nextValue(&prngSeed, max);
 }
 
 
@@ -67,3 +67,81 @@ int prngSetSeed(uint64_t seed) {
 }
 
 
+// prngHistorical returns TRUE when FH_PRNG=historical.
+// In that mode the order that work is done in changes the results, so it must not run in parallel.
+int prngHistorical(void) {
+    if (historical == -1) {
+        char *mode = getenv("FH_PRNG");
+        historical = mode != NULL && strcmp(mode, "historical") == 0;
+    }
+    return historical;
+}
+
+
+// prngUseStream selects the stream that prng draws from until the next call to prngUseStream or prngUseGlobal.
+// The stream is derived from the initial seed, the name of the phase, the turn number, and a key for the
+// unit of work (a species number, the coordinates of a battle, and so on). The same arguments always give
+// the same numbers, no matter what was drawn before or from which other streams.
+// When FH_PRNG=historical, this does nothing and every number comes from the single historical stream.
+void prngUseStream(const char *name, int turn, uint64_t key) {
+    if (prngHistorical()) {
+        return;
+    }
+
+    // FNV-1a hash of the name
+    uint64_t h = 14695981039346656037ULL;
+    for (; *name != 0; name++) {
+        h = (h ^ (unsigned char) *name) * 1099511628211ULL;
+    }
+    uint64_t seed = splitMix(initialSeed() ^ h);
+    seed = splitMix(seed ^ (uint64_t) turn);
+    seed = splitMix(seed ^ key);
+    streamSeed = seed != 0 ? seed : 1;
+}
+
+
+// prngUseGlobal goes back to drawing from the single historical stream.
+void prngUseGlobal(void) {
+    streamSeed = 0;
+}
+
+
+// initialSeed returns the seed from FH_SEED, or the historical default if it is not set.
+static uint64_t initialSeed(void) {
+    uint64_t seed = 0;
+    char *envSeed = getenv("FH_SEED");
+    if (envSeed) {
+        for (; *envSeed != 0; envSeed++) {
+            if (isdigit(*envSeed)) {
+                seed = seed * 10 + *envSeed - '0';
+            }
+        }
+    }
+    if (seed == 0) {
+        seed = 1924085713L;
+    }
+    return seed;
+}
+
+
+static int nextValue(uint64_t *seed, unsigned int max) {
+    /* For congruential method, multiply previous value by the prime number 16417. */
+    uint64_t cong_result = *seed + (*seed << 5) + (*seed << 14);    /* Effectively multiply by 16417. */
+
+    /* For shift-register method, use shift-right 15 and shift-left 17 with no-carry addition (i.e., exclusive-or). */
+    uint64_t shift_result = (*seed >> 15) ^ *seed;
+    shift_result ^= (shift_result << 17);
+
+    *seed = cong_result ^ shift_result;
+
+    return (int) (((*seed & 0x0000FFFF) * (uint64_t) max) >> 16) + 1L;
+}
+
+
+// splitMix is the SplitMix64 finalizer. It spreads the bits of x so that nearby keys give unrelated streams.
+static uint64_t splitMix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
@@ -22,10 +22,19 @@
 
 // prng returns a random int between 1 and max, inclusive.
 // It uses the so-called "Algorithm M" method, which is a combination of the congruential and shift-register methods.
+// Phases that split their work into independent units (battles, species) draw each unit's
+// numbers from its own stream, so the results do not depend on the order the units run in.
+// Set FH_PRNG=historical to draw everything from the single stream, as older versions did.
 int prng(unsigned int max);
 
 uint64_t prngGetSeed(void);
 
 int prngSetSeed(uint64_t seed);
 
+int prngHistorical(void);
+
+void prngUseStream(const char *name, int turn, uint64_t key);
+
+void prngUseGlobal(void);
+
 #endif //FAR_HORIZONS_PRNG_H
@@ -25,14 +25,18 @@
 #include "galaxyio.h"
 #include "transactionio.h"
 #include "shipvars.h"
+#include "snapshot.h"
 #include "speciesio.h"
 #include "stario.h"
+#include "ordercache.h"
 #include "planetio.h"
+#include "prng.h"
 #include "speciesvars.h"
 #include "namplavars.h"
 #include "planetvars.h"
 #include "commandvars.h"
 #include "command.h"
+#include "logsink.h"
 #include "logvars.h"
 #include "production.h"
 #include "productionvars.h"
@@ -40,9 +44,9 @@
 #include "money.h"
 #include "intercept.h"
 
-int productionPass(int sp_num[], int num_species, int do_all_species, int first_pass);
+int productionPass(int sp_num[], int num_species, int do_all_species, int preview);
 
-int productionPassSpecies(int spNo, int do_all_species, int first_pass);
+int productionPassSpecies(int spNo, int do_all_species, int preview);
 
 
 void do_production_orders(void) {
@@ -50,10 +54,6 @@ void do_production_orders(void) {
 
     truncate_name = TRUE;    /* For these commands, do not display age or landed/orbital status of ships. */
 
-    if (first_pass) {
-        printf("\nStart of production orders for species #%d, SP %s...\n", species_number, species->name);
-    }
-
     doing_production = FALSE;    /* This will be set as soon as production actually starts. */
     while (TRUE) {
         command = get_command();
@@ -92,11 +92,6 @@ void do_production_orders(void) {
 
             transfer_balance();    /* Terminate production for last planet for this species. */
 
-            if (first_pass) {
-                gamemaster_abort_option();
-                printf("\nEnd of production orders for species #%d, SP %s.\n", species_number, species->name);
-            }
-
             break;            /* END for this species. */
         }
 
@@ -164,11 +159,11 @@ void do_production_orders(void) {
 int productionCommand(int argc, char *argv[]) {
     int do_all_species = TRUE;
     int dryRun = FALSE;
+    int preview = FALSE;
     int num_species = 0;
     int sp_num[MAX_SPECIES];
     memset(sp_num, 0, sizeof(sp_num));
 
-    first_pass = FALSE;
     ignore_field_distorters = TRUE;
 
     /* Get commonly used data. */
@@ -178,8 +173,7 @@ int productionCommand(int argc, char *argv[]) {
     get_transaction_data();
 
     /* Check arguments.
-     * If an argument is -p, then do two passes.
-     * In the first pass, display results and prompt the GM,
+     * If an argument is -p, then display results and prompt the GM,
      * allowing the GM to abort if necessary before saving results to disk.
      * All other arguments must be species numbers.
     * If no species numbers are specified, then do all species. */
@@ -201,14 +195,14 @@ int productionCommand(int argc, char *argv[]) {
             return 2;
         } else if (strcmp(opt, "-p") == 0 && val == NULL) {
             dryRun = TRUE;
-            first_pass = TRUE;
+            preview = TRUE;
         } else if (strcmp(opt, "-t") == 0 && val == NULL) {
             test_mode = TRUE;
         } else if (strcmp(opt, "-v") == 0 && val == NULL) {
             verbose_mode = TRUE;
         } else if (strcmp(opt, "--dry-run") == 0 && val == NULL) {
             dryRun = TRUE;
-            first_pass = TRUE;
+            preview = TRUE;
         } else if (strcmp(opt, "--test") == 0 && val == NULL) {
             test_mode = TRUE;
         } else if (val == NULL && isdigit(*opt)) {
@@ -254,14 +248,18 @@ int productionCommand(int argc, char *argv[]) {
         }
     }
 
-    /* Two passes through all orders will be done.
-     * The first pass will check for errors and abort if any are found.
-     * Results will be written to disk only on the second pass. */
-    if (first_pass != FALSE) {
-        printf("\nStarting first pass...\n\n");
-        productionPass(sp_num, num_species, do_all_species, TRUE);
+    /* When previewing, the results are held until the GM has seen them.
+     * If the GM aborts, nothing is written to disk. */
+    get_species_data();
+    if (preview) {
+        snapshotTake();
+    }
+    productionPass(sp_num, num_species, do_all_species, preview);
+    if (preview && !snapshotPreview()) {
+        free_species_data();
+        free(planet_base);
+        return 0;
     }
-    productionPass(sp_num, num_species, do_all_species, FALSE);
 
     save_species_data();
 
@@ -270,6 +268,7 @@ int productionCommand(int argc, char *argv[]) {
     }
 
     save_transaction_data();
+    logSinkFlush();
 
     free_species_data();
     free(planet_base);
@@ -278,13 +277,7 @@ int productionCommand(int argc, char *argv[]) {
 }
 
 
-int productionPass(int sp_num[], int num_species, int do_all_species, int first_pass) {
-    if (first_pass) {
-        printf("\nStarting first pass...\n\n");
-    }
-
-    get_species_data();
-
+int productionPass(int sp_num[], int num_species, int do_all_species, int preview) {
     /* Main loop. For each species, take appropriate action. */
     for (int sp_index = 0; sp_index < num_species; sp_index++) {
         species_number = sp_num[sp_index];
@@ -293,7 +286,7 @@ int productionPass(int sp_num[], int num_species, int do_all_species, int first_
         int found = data_in_memory[species_index];
         if (found == FALSE) {
             if (do_all_species) {
-                if (first_pass) {
+                if (preview) {
                     printf("\n    Skipping species #%d.\n", species_number);
                 }
                 continue;
@@ -303,32 +296,17 @@ int productionPass(int sp_num[], int num_species, int do_all_species, int first_
             }
         }
 
-        int result = productionPassSpecies(species_number, do_all_species, first_pass);
+        int result = productionPassSpecies(species_number, do_all_species, preview);
         if (result) {
             // ?
         }
     }
 
-    if (first_pass) {
-        printf("\nFinal chance to abort safely!\n");
-
-        gamemaster_abort_option();
-
-        first_pass = FALSE;
-
-        free_species_data();
-
-        free(star_base);    /* In case data was modified. */
-        free(planet_base);    /* In case data was modified. */
-
-        printf("\nStarting second pass...\n\n");
-    }
-
     return 0;
 }
 
 
-int productionPassSpecies(int spNo, int do_all_species, int first_pass) {
+int productionPassSpecies(int spNo, int do_all_species, int preview) {
 
     species = &spec_data[species_index];
     nampla_base = namp_data[species_index];
@@ -339,10 +317,9 @@ int productionPassSpecies(int spNo, int do_all_species, int first_pass) {
     /* Open orders file for this species. */
     char filename[128];
     sprintf(filename, "sp%02d.ord", species_number);
-    input_file = fopen(filename, "r");
-    if (input_file == NULL) {
+    if (!ordersOpen(species_number)) {
         if (do_all_species) {
-            if (first_pass) {
+            if (preview) {
                 printf("\n    No orders for species #%d.\n", species_number);
             }
             return 0;
@@ -352,63 +329,20 @@ int productionPassSpecies(int spNo, int do_all_species, int first_pass) {
         }
     }
 
-    end_of_file = FALSE;
-    just_opened_file = TRUE;    /* Tell command parser to skip mail header, if any. */
-
     /* Search for START PRODUCTION order. */
-    int found = FALSE;
-    for (; !found;) {
-        int command = get_command();
-        if (command == MESSAGE) {
-            /* Skip MESSAGE text. It may contain a line that starts with "start". */
-            for (; command > 0 && command != ZZZ;) {
-                command = get_command();
-            }
-            if (command < 0) {
-                /* End of file. */
-                fprintf(stderr, "WARNING: Unterminated MESSAGE command in file '%s'!\n", filename);
-            }
-        }
-
-        if (command == START) {
-            /* Get the first three letters of the keyword and convert to upper case. */
-            skip_whitespace();
-            char keyword[4] = {0, 0, 0, 0};
-            for (int i = 0; i < 3 && *input_line_pointer != 0; i++) {
-                keyword[i] = toupper(*input_line_pointer);
-                input_line_pointer++;
-            }
-            if (strcmp(keyword, "PRO") == 0) {
-                found = TRUE;
-            }
-        }
-
-        if (command < 0) {
-            /* End of file. */
-            if (first_pass) {
-                printf("\nNo production orders for species #%d, SP %s.\n", species_number, species->name);
-            }
-            fclose(input_file);
-            input_file = NULL;
-            return 0;
+    if (!ordersFind("PRO")) {
+        if (preview) {
+            printf("\nNo production orders for species #%d, SP %s.\n", species_number, species->name);
         }
+        ordersClose();
+        return 0;
     }
 
-    /* Open log file. Use stdout for first pass. */
+    /* Open log file for appending. */
     log_stdout = FALSE;  /* We will control value of log_file from here. */
-    if (first_pass) {
-        log_file = stdout;
-    } else {
-        /* Open log file for appending. */
-        sprintf(filename, "sp%02d.log", species_number);
-        log_file = fopen(filename, "a");
-        if (log_file == NULL) {
-            fprintf(stderr, "\n\tCannot open '%s' for appending!\n\n", filename);
-            exit(2);
-        }
-        fprintf(log_file, "\nProduction orders:\n");
-        fprintf(log_file, "\n  Number of economic units at start of production: %d\n\n", species->econ_units);
-    }
+    log_file = logSinkOpen(species_number);
+    fprintf(log_file, "\nProduction orders:\n");
+    fprintf(log_file, "\n  Number of economic units at start of production: %d\n\n", species->econ_units);
 
     // initialize arrays
     for (int i = 0; i < species->num_namplas; i++) {
@@ -433,6 +367,9 @@ int productionPassSpecies(int spNo, int do_all_species, int first_pass) {
         sp_tech_level[i] = species->tech_level[i];
     }
 
+    /* Each species draws from its own stream of random numbers. */
+    prngUseStream("production", galaxy.turn_number, species_number);
+
     do_production_orders();
 
     for (int i = 0; i < 6; i++) {
@@ -443,15 +380,11 @@ int productionPassSpecies(int spNo, int do_all_species, int first_pass) {
         handle_intercept(i);
     }
 
-    data_modified[species_index] = TRUE;
+    prngUseGlobal();
 
-    /* If this is the second pass, close the log file. */
-    if (!first_pass) {
-        fclose(log_file);
-    }
+    data_modified[species_index] = TRUE;
 
-    fclose(input_file);
-    input_file = NULL;
+    ordersClose();
 
     return 0;
 }
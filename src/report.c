@@ -17,9 +17,15 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <fcntl.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <unistd.h>
+#include "cjson/helpers.h"
+#include "datafile.h"
+#include "fileappend.h"
 #include "commandvars.h"
 #include "enginevars.h"
 #include "galaxy.h"
@@ -32,47 +38,96 @@
 #include "planet.h"
 #include "planetio.h"
 #include "planetvars.h"
+#include "sector.h"
 #include "ship.h"
 #include "shipvars.h"
 #include "species.h"
 #include "speciesio.h"
 #include "speciesvars.h"
+#include "starindex.h"
 #include "stario.h"
 #include "report.h"
 
-static int fleet_percent_cost;
-static struct nampla_data *nampla1_base;
-static struct nampla_data *nampla2_base;
-static int printing_alien;
-static FILE *report_file;
-static char ship_already_listed[5000];
-static struct ship_data *ship1_base;
-static struct ship_data *ship2_base;
+// report_pool_t hands out the species to the worker threads.
+typedef struct report_pool {
+    int num_species;
+    int next_species;
+    int *sp_num;
+    int log_species;
+    int ignore_field_distorters;  // the worker threads start with the main thread's setting
+    pthread_mutex_t lock;
+} report_pool_t;
+
+// each thread writes one report at a time
+static int json_wanted;  // set by --json; read but never changed while the reports are written
+static THREAD_LOCAL int fleet_percent_cost;
+static THREAD_LOCAL cJSON *json_report;  // the structured copy of the report, or NULL when it is not wanted
+static THREAD_LOCAL cJSON *json_ships;   // the array that print_ship adds ships to, or NULL
+static THREAD_LOCAL struct nampla_data *nampla1_base;
+static THREAD_LOCAL struct nampla_data *nampla2_base;
+static THREAD_LOCAL int printing_alien;
+static THREAD_LOCAL FILE *report_file;
+static THREAD_LOCAL char *ship_already_listed;
+static THREAD_LOCAL struct ship_data *ship1_base;
+static THREAD_LOCAL struct ship_data *ship2_base;
+static THREAD_LOCAL int *ships_by_location;  // indexes of the ships sorted by x, y, z and then index
+
+
+static cJSON *jsonArray(cJSON *obj, const char *objName, const char *propName);
+
+static void jsonItems(cJSON *obj, const char *objName, int *item_quantity);
+
+static cJSON *jsonObject(cJSON *array, const char *arrayName);
+
+static cJSON *jsonOwnShip(cJSON *array, struct ship_data *ship, const char *name, int location_known);
+
+static int shipLocationCompare(const void *a, const void *b);
+
+static int shipsAtOrAfter(int x, int y, int z, int index);
+
+
+static void writeReport(int report_species_number, int log_species);
+
+static void writeReports(int num_species, int *sp_num, int log_species, int jobs);
+
+static void *writeReportsWorker(void *arg);
 
 
 void do_planet_report(struct nampla_data *nampla, struct ship_data *s_base, struct species_data *species) {
     int i, j, ship_index, header_printed, ls_needed, production_penalty;
     long n1, n2, n3, raw_material_units, production_capacity, available_to_spend, n, ib, ab, current_base, md, denom;
     struct ship_data *ship;
+    const char *type;
+    cJSON *json_planet = NULL;
 
     /* Print type of planet, name and coordinates. */
     fprintf(report_file, "\n\n");
 
     if (nampla->status & HOME_PLANET) {
-        fprintf(report_file, "HOME PLANET");
+        type = "HOME PLANET";
     } else if (nampla->status & MINING_COLONY) {
-        fprintf(report_file, "MINING COLONY");
+        type = "MINING COLONY";
     } else if (nampla->status & RESORT_COLONY) {
-        fprintf(report_file, "RESORT COLONY");
+        type = "RESORT COLONY";
     } else if (nampla->status & POPULATED) {
-        fprintf(report_file, "COLONY PLANET");
-    } else { fprintf(report_file, "PLANET"); }
+        type = "COLONY PLANET";
+    } else { type = "PLANET"; }
 
-    fprintf(report_file, ": PL %s", nampla->name);
+    fprintf(report_file, "%s: PL %s", type, nampla->name);
 
     fprintf(report_file, "\n   Coordinates: x = %d, y = %d, z = %d, planet number %d\n", nampla->x, nampla->y,
             nampla->z, nampla->pn);
 
+    if (json_report != NULL) {
+        json_planet = jsonObject(cJSON_GetObjectItemCaseSensitive(json_report, "producing_planets"), "producing_planets");
+        jsonAddStringToObj(json_planet, "planet", "type", type);
+        jsonAddStringToObj(json_planet, "planet", "name", nampla->name);
+        jsonAddIntToObj(json_planet, "planet", "x", nampla->x);
+        jsonAddIntToObj(json_planet, "planet", "y", nampla->y);
+        jsonAddIntToObj(json_planet, "planet", "z", nampla->z);
+        jsonAddIntToObj(json_planet, "planet", "pn", nampla->pn);
+    }
+
     if (nampla->status & HOME_PLANET) {
         ib = nampla->mi_base;
         ab = nampla->ma_base;
@@ -97,6 +152,10 @@ void do_planet_report(struct nampla_data *nampla, struct ship_data *s_base, stru
 
             fprintf(report_file, "\nWARNING! Home planet has not yet completely recovered from bombardment!\n");
             fprintf(report_file, "         %d IUs and %d AUs will have to be installed for complete recovery.\n", i, j);
+            if (json_planet != NULL) {
+                jsonAddIntToObj(json_planet, "planet", "recovery_ius", i);
+                jsonAddIntToObj(json_planet, "planet", "recovery_aus", j);
+            }
         }
     }
 
@@ -109,6 +168,15 @@ void do_planet_report(struct nampla_data *nampla, struct ship_data *s_base, stru
         // do nothing
     } else {
         fprintf(report_file, "\nAvailable population units = %d\n", nampla->pop_units);
+        if (json_planet != NULL) {
+            jsonAddIntToObj(json_planet, "planet", "pop_units", nampla->pop_units);
+        }
+    }
+
+    if (json_planet != NULL) {
+        jsonAddBoolToObj(json_planet, "planet", "under_siege", nampla->siege_eff != 0);
+        jsonAddBoolToObj(json_planet, "planet", "ambush", nampla->use_on_ambush > 0);
+        jsonAddBoolToObj(json_planet, "planet", "hidden", nampla->hidden);
     }
 
     if (nampla->siege_eff != 0) {
@@ -141,6 +209,15 @@ void do_planet_report(struct nampla_data *nampla, struct ship_data *s_base, stru
 
     fprintf(report_file, "\nEconomic efficiency = %d%%\n", planet->econ_efficiency);
 
+    if (json_planet != NULL) {
+        jsonAddIntToObj(json_planet, "planet", "production_penalty", production_penalty);
+        jsonAddIntToObj(json_planet, "planet", "ls_needed", ls_needed);
+        jsonAddIntToObj(json_planet, "planet", "econ_efficiency", planet->econ_efficiency);
+        jsonAddIntToObj(json_planet, "planet", "mi_base", nampla->mi_base);
+        jsonAddIntToObj(json_planet, "planet", "ma_base", nampla->ma_base);
+        jsonAddIntToObj(json_planet, "planet", "mining_difficulty", planet->mining_difficulty);
+    }
+
     raw_material_units -= (production_penalty * raw_material_units) / 100;
     raw_material_units = (((long) planet->econ_efficiency * raw_material_units) + 50) / 100;
     production_capacity -= (production_penalty * production_capacity) / 100;
@@ -158,10 +235,16 @@ void do_planet_report(struct nampla_data *nampla, struct ship_data *s_base, stru
             n3 = n1 - n2;
             fprintf(report_file, "   This mining colony will generate %ld - %ld = %ld economic units this turn.\n", n1,
                     n2, n3);
+            if (json_planet != NULL) {
+                jsonAddIntToObj(json_planet, "planet", "econ_units", (int) n3);
+            }
 
             nampla->use_on_ambush = n3;        /* Temporary use only. */
         } else {
             fprintf(report_file, "   %ld raw material units will be produced this turn.\n", raw_material_units);
+            if (json_planet != NULL) {
+                jsonAddIntToObj(json_planet, "planet", "raw_material_units", (int) raw_material_units);
+            }
         }
     }
 
@@ -178,10 +261,16 @@ void do_planet_report(struct nampla_data *nampla, struct ship_data *s_base, stru
             n3 = n1 - n2;
             fprintf(report_file, "   This resort colony will generate %ld - %ld = %ld economic units this turn.\n", n1,
                     n2, n3);
+            if (json_planet != NULL) {
+                jsonAddIntToObj(json_planet, "planet", "econ_units", (int) n3);
+            }
 
             nampla->use_on_ambush = n3;        /* Temporary use only. */
         } else {
             fprintf(report_file, "   Production capacity this turn will be %ld.\n", production_capacity);
+            if (json_planet != NULL) {
+                jsonAddIntToObj(json_planet, "planet", "production_capacity", (int) production_capacity);
+            }
         }
     }
 
@@ -211,10 +300,20 @@ void do_planet_report(struct nampla_data *nampla, struct ship_data *s_base, stru
         nampla->use_on_ambush = n3;    /* Temporary use only. */
 
         fprintf(report_file, "\nShipyard capacity = %d\n", nampla->shipyards);
+        if (json_planet != NULL) {
+            jsonAddIntToObj(json_planet, "planet", "available_to_spend", (int) n1);
+            jsonAddIntToObj(json_planet, "planet", "fleet_maintenance", (int) n2);
+            jsonAddIntToObj(json_planet, "planet", "shipyards", nampla->shipyards);
+        }
     }
 
     do_inventory:
 
+    if (json_planet != NULL) {
+        jsonItems(json_planet, "planet", nampla->item_quantity);
+        json_ships = jsonArray(json_planet, "planet", "ships");
+    }
+
     header_printed = FALSE;
 
     for (i = 0; i < MAX_ITEMS; i++) {
@@ -295,6 +394,8 @@ void do_planet_report(struct nampla_data *nampla, struct ship_data *s_base, stru
 
         ship_already_listed[ship_index] = TRUE;
     }
+
+    json_ships = NULL;
 }
 
 
@@ -311,30 +412,18 @@ void print_ship_header(void) {
 
 
 void print_mishap_chance(struct ship_data *ship, int destx, int desty, int destz) {
-    int mishap_GV, mishap_age;
-    long x, y, z, mishap_chance, success_chance;
+    long x, y, z, mishap_chance;
 
     if (destx == 9999) {
         fprintf(report_file, "Mishap chance = ???");
         return;
     }
 
-    mishap_GV = species->tech_level[GV];
-    mishap_age = ship->age;
-
     x = destx;
     y = desty;
     z = destz;
-    mishap_chance = (100 * (((x - ship->x) * (x - ship->x)) + ((y - ship->y) * (y - ship->y)) +
-                            ((z - ship->z) * (z - ship->z)))) / mishap_GV;
-
-    if (mishap_age > 0 && mishap_chance < 10000) {
-        success_chance = 10000L - mishap_chance;
-        success_chance -= (2L * (long) mishap_age * success_chance) / 100L;
-        mishap_chance = 10000L - success_chance;
-    }
-
-    if (mishap_chance > 10000) { mishap_chance = 10000; }
+    mishap_chance = mishapChance(((x - ship->x) * (x - ship->x)) + ((y - ship->y) * (y - ship->y)) +
+                                 ((z - ship->z) * (z - ship->z)), species->tech_level[GV], ship->age);
 
     fprintf(report_file, "mishap chance = %ld.%02ld%%",
             mishap_chance / 100L, mishap_chance % 100L);
@@ -343,6 +432,7 @@ void print_mishap_chance(struct ship_data *ship, int destx, int desty, int destz
 
 void print_ship(struct ship_data *ship, struct species_data *species, int species_number) {
     int i, n, length, capacity, need_comma;
+    cJSON *json_ship = NULL;
 
     if (printing_alien) {
         ignore_field_distorters = FALSE;
@@ -371,12 +461,25 @@ void print_ship(struct ship_data *ship, struct species_data *species, int specie
         capacity = ship->tonnage;
     }
 
+    if (json_ships != NULL) {
+        if (printing_alien) {
+            json_ship = jsonObject(json_ships, "ships");
+            jsonAddStringToObj(json_ship, "ship", "name", full_ship_id);
+        } else {
+            json_ship = jsonOwnShip(json_ships, ship, full_ship_id, TRUE);
+            jsonAddIntToObj(json_ship, "ship", "capacity", capacity);
+        }
+    }
+
     if (printing_alien) {
         fprintf(report_file, " ");
     } else {
         fprintf(report_file, "%4d  ", capacity);
         if (ship->status == UNDER_CONSTRUCTION) {
             fprintf(report_file, "Left to pay = %d\n", ship->remaining_cost);
+            if (json_ship != NULL) {
+                jsonAddIntToObj(json_ship, "ship", "remaining_cost", ship->remaining_cost);
+            }
             return;
         }
     }
@@ -384,8 +487,14 @@ void print_ship(struct ship_data *ship, struct species_data *species, int specie
     if (printing_alien) {
         if (ship->status == ON_SURFACE || ship->item_quantity[FD] != ship->tonnage) {
             fprintf(report_file, "SP %s", species->name);
+            if (json_ship != NULL) {
+                jsonAddStringToObj(json_ship, "ship", "species", species->name);
+            }
         } else {
             fprintf(report_file, "SP %d", distorted(species_number));
+            if (json_ship != NULL) {
+                jsonAddIntToObj(json_ship, "ship", "species_number", distorted(species_number));
+            }
         }
     } else {
         need_comma = FALSE;
@@ -405,18 +514,10 @@ void print_ship(struct ship_data *ship, struct species_data *species, int specie
 int reportCommand(int argc, char *argv[]) {
     const char *cmdName = argv[0];
 
-    int i, j, k, ship_index, locations_fd, my_loc_index, its_loc_index;
-    int industry, species_fd;
-    int header_printed, alien_can_hide, sp_index;
-    int array_index, bit_number, we_have_colony_here, nampla_index;
-    int we_have_planet_here, found, ls_needed, production_penalty;
-    int temp_ignore_field_distorters;
-    char filename[32], log_line[256], temp2[128];
-    long n, nn, bit_mask;
-    struct species_data *alien;
-    struct nampla_data *nampla, *alien_nampla, *our_nampla, *temp_nampla;
-    struct ship_data *ship, *ship2, *alien_ship;
-    struct sp_loc_data *locations_base, *my_loc, *its_loc;
+    int j;
+    int jobs = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    int num_species = 0;
+    int sp_num[MAX_SPECIES];
 
     // consolidate logic for reporting and logging flags
     // by default, log and report on all species
@@ -426,16 +527,33 @@ int reportCommand(int argc, char *argv[]) {
         reportSpecies[j] = 1;
     }
 
+    json_wanted = FALSE;
+
     // process the arguments and reset flags as needed
-    for (i = 1; i < argc; i++) {
+    for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "-?") == 0) {
-            fprintf(stderr, "usage: report [--skip-log] [list-of-species]\n");
+            fprintf(stderr, "usage: report [--skip-log] [--json] [-j N | --jobs=N] [list-of-species]\n");
             fprintf(stderr, "\t--skip-log       do not include prior turn results in report\n");
+            fprintf(stderr, "\t--json           also write the report as JSON to spNN.rpt.tN.json\n");
+            fprintf(stderr, "\t-j N, --jobs=N   write at most N reports at the same time\n");
             fprintf(stderr, "\tlist-of-species  you may specify individual species numbers to report on\n");
             return 2;
         } else if (strcmp(argv[i], "--skip-log") == 0) {
             // turn off logging for all species
             logSpecies = 0;
+        } else if (strcmp(argv[i], "--json") == 0) {
+            json_wanted = TRUE;
+        } else if (strncmp(argv[i], "--jobs=", 7) == 0 || strcmp(argv[i], "-j") == 0) {
+            if (strcmp(argv[i], "-j") == 0) {
+                i++;
+                jobs = i < argc ? atoi(argv[i]) : 0;
+            } else {
+                jobs = atoi(argv[i] + 7);
+            }
+            if (jobs < 1) {
+                fprintf(stderr, "error: invalid number of jobs\n");
+                return 2;
+            }
         } else { // should be the species to report
             int speciesNo = atoi(argv[i]);
             if (speciesNo < 1 || speciesNo > MAX_SPECIES) {
@@ -455,6 +573,9 @@ int reportCommand(int argc, char *argv[]) {
         }
     }
 
+    /* Nothing is saved, so version 2 data files can be used without copying them. */
+    map_data_in_place = TRUE;
+
     /* Get all necessary data. */
     printf("fh: %s: loading   galaxy   file...\n", cmdName);
     get_galaxy_data();
@@ -470,7 +591,6 @@ int reportCommand(int argc, char *argv[]) {
     int turn_number = galaxy.turn_number;
 
     /* Generate a report for each species. */
-    int alien_number = 0;    /* Pointers to alien data not yet assigned. */
     for (species_number = 1; species_number <= galaxy.num_species; species_number++) {
         /* Check if we are doing all species, or just one or more specified ones. */
         if (reportSpecies[species_number] != 1) {
@@ -479,7 +599,7 @@ int reportCommand(int argc, char *argv[]) {
 
         /* Check if this species is still in the game. */
         if (!data_in_memory[species_number - 1]) {
-            if (argc == 1) {
+            if (reportSpecies[0] == 1) {
                 /* This species is no longer in the game. */
                 continue;
             }
@@ -488,919 +608,1247 @@ int reportCommand(int argc, char *argv[]) {
             exit(-1);
         }
 
-        species = &spec_data[species_number - 1];
-        nampla_base = namp_data[species_number - 1];
-        nampla1_base = nampla_base;
-        ship_base = ship_data[species_number - 1];
-        ship1_base = ship_base;
-        home_planet = planet_base + (long) nampla1_base->planet_index;
-
         /* Print message for gamemaster. */
         if (verbose_mode) {
             printf("Generating turn %d report for species #%d, SP %s...\n",
-                   turn_number, species_number, species->name);
+                   turn_number, species_number, spec_data[species_number - 1].name);
         }
 
-        /* Open report file for writing. */
-        sprintf(filename, "sp%02d.rpt.t%d", species_number, turn_number);
-        report_file = fopen(filename, "w");
-        if (report_file == NULL) {
-            fprintf(stderr, "\n\tCannot open '%s' for writing!\n\n", filename);
-            exit(-1);
+        sp_num[num_species] = species_number;
+        num_species++;
+    }
+
+    writeReports(num_species, sp_num, logSpecies, jobs);
+
+    /* Clean up and exit. */
+    free_species_data();
+
+    return 0;
+}
+
+
+// jsonArray adds an empty array to the object and returns it.
+static cJSON *jsonArray(cJSON *obj, const char *objName, const char *propName) {
+    cJSON *array = cJSON_CreateArray();
+    if (array == NULL) {
+        fprintf(stderr, "error: %s: unable to allocate array '%s'\n", objName, propName);
+        exit(2);
+    }
+    jsonAddItemToObj(obj, objName, propName, array);
+    return array;
+}
+
+
+// jsonItems adds the items that have a non-zero quantity to the object, keyed by their abbreviation.
+static void jsonItems(cJSON *obj, const char *objName, int *item_quantity) {
+    cJSON *items = cJSON_CreateObject();
+    if (items == NULL) {
+        fprintf(stderr, "error: %s: unable to allocate object 'items'\n", objName);
+        exit(2);
+    }
+    for (int i = 0; i < MAX_ITEMS; i++) {
+        if (item_quantity[i] > 0) {
+            jsonAddIntToObj(items, "items", item_abbr[i], item_quantity[i]);
         }
+    }
+    jsonAddItemToObj(obj, objName, "items", items);
+}
 
-        /* Copy log file, if any, to output file. */
-        if (logSpecies == 1) {
-            sprintf(filename, "sp%02d.log", species_number);
-            log_file = fopen(filename, "r");
-            if (log_file != NULL) {
-                if (turn_number > 1) {
-                    fprintf(report_file, "\n\n\t\t\tEVENT LOG FOR TURN %d\n", turn_number - 1);
-                }
 
-                while (readln(log_line, 256, log_file) != NULL) {
-                    fputs(log_line, report_file);
-                }
+// jsonObject adds an empty object to the array and returns it.
+static cJSON *jsonObject(cJSON *array, const char *arrayName) {
+    cJSON *obj = cJSON_CreateObject();
+    if (obj == NULL) {
+        fprintf(stderr, "error: %s: unable to allocate object\n", arrayName);
+        exit(2);
+    }
+    jsonAddItemToArray(array, arrayName, obj);
+    return obj;
+}
 
-                fprintf(report_file, "\n\n");
 
-                fclose(log_file);
-            }
+// jsonOwnShip adds one of the current species' ships to the array, using the name printed in the text report.
+// The coordinates are left out when the report does not show them.
+static cJSON *jsonOwnShip(cJSON *array, struct ship_data *ship, const char *name, int location_known) {
+    cJSON *obj = jsonObject(array, "ships");
+    jsonAddStringToObj(obj, "ship", "name", name);
+    if (location_known) {
+        jsonAddIntToObj(obj, "ship", "x", ship->x);
+        jsonAddIntToObj(obj, "ship", "y", ship->y);
+        jsonAddIntToObj(obj, "ship", "z", ship->z);
+        jsonAddIntToObj(obj, "ship", "pn", ship->pn);
+    }
+    jsonItems(obj, "ship", ship->item_quantity);
+    return obj;
+}
+
+
+// shipLocationCompare orders ship indexes by the coordinates of the ships and then by index.
+static int shipLocationCompare(const void *a, const void *b) {
+    int ia = *(const int *) a;
+    int ib = *(const int *) b;
+    struct ship_data *sa = ship1_base + ia;
+    struct ship_data *sb = ship1_base + ib;
+    if (sa->x != sb->x) {
+        return sa->x < sb->x ? -1 : 1;
+    } else if (sa->y != sb->y) {
+        return sa->y < sb->y ? -1 : 1;
+    } else if (sa->z != sb->z) {
+        return sa->z < sb->z ? -1 : 1;
+    }
+    return ia < ib ? -1 : ia > ib ? 1 : 0;
+}
+
+
+// shipsAtOrAfter returns the position in ships_by_location of the first ship at the coordinates
+// whose index is at least index, or of the ship that sorts after it if there is none.
+static int shipsAtOrAfter(int x, int y, int z, int index) {
+    int lo = 0, hi = species->num_ships;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        struct ship_data *ship = ship1_base + ships_by_location[mid];
+        int before;
+        if (ship->x != x) {
+            before = ship->x < x;
+        } else if (ship->y != y) {
+            before = ship->y < y;
+        } else if (ship->z != z) {
+            before = ship->z < z;
+        } else {
+            before = ships_by_location[mid] < index;
         }
+        if (before) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
 
-        /* Print header for status report. */
-        fprintf(report_file, "\n\t\t\t SPECIES STATUS\n\n\t\t\tSTART OF TURN %d\n\n", turn_number);
-        fprintf(report_file, "Species name: %s\n", species->name);
-        fprintf(report_file, "Government name: %s\n", species->govt_name);
-        fprintf(report_file, "Government type: %s\n", species->govt_type);
+// writeReport writes the turn report for one species.
+// It reads the data of every species but changes only the data of the species it reports on.
+static void writeReport(int report_species_number, int log_species) {
+    int i, j, k, ship_index, my_loc_index, its_loc_index;
+    int industry;
+    int header_printed, alien_can_hide, sp_index;
+    int array_index, bit_number, we_have_colony_here, nampla_index;
+    int we_have_planet_here, found;
+    int temp_ignore_field_distorters;
+    int x, y, z;
+    char filename[32], temp2[128];
+    long n, nn, bit_mask;
+    struct species_data *alien;
+    struct nampla_data *nampla, *alien_nampla, *our_nampla, *temp_nampla;
+    struct ship_data *ship, *ship2, *alien_ship;
+    struct sp_loc_data *locations_base, *my_loc, *its_loc;
+    sector_t *sector;
+    cJSON *json_list, *json_obj, *json_location;
 
-        fprintf(report_file, "\nTech Levels:\n");
-        for (i = 0; i < 6; i++) {
-            fprintf(report_file, "   %s = %d", tech_name[i], species->tech_level[i]);
-            if (species->tech_knowledge[i] > species->tech_level[i]) {
-                fprintf(report_file, "/%d", species->tech_knowledge[i]);
+    int turn_number = galaxy.turn_number;
+    int alien_number = 0;    /* Pointers to alien data not yet assigned. */
+
+    species_number = report_species_number;
+    species = &spec_data[species_number - 1];
+    nampla_base = namp_data[species_number - 1];
+    nampla1_base = nampla_base;
+    ship_base = ship_data[species_number - 1];
+    ship1_base = ship_base;
+    home_planet = planet_base + (long) nampla1_base->planet_index;
+
+    /* Open report file for writing. */
+    sprintf(filename, "sp%02d.rpt.t%d", species_number, turn_number);
+    report_file = fopen(filename, "w");
+    if (report_file == NULL) {
+        fprintf(stderr, "\n\tCannot open '%s' for writing!\n\n", filename);
+        exit(-1);
+    }
+
+    /* Copy log file, if any, to output file. */
+    if (log_species == 1) {
+        sprintf(filename, "sp%02d.log", species_number);
+        int log_fd = open(filename, O_RDONLY);
+        if (log_fd >= 0) {
+            if (turn_number > 1) {
+                fprintf(report_file, "\n\n\t\t\tEVENT LOG FOR TURN %d\n", turn_number - 1);
             }
-            fprintf(report_file, "\n");
+
+            fileAppend(report_file, log_fd, filename);
+
+            fprintf(report_file, "\n\n");
+
+            close(log_fd);
         }
+    }
 
-        fprintf(report_file, "\nAtmospheric Requirement: %d%%-%d%% %s", (int) species->required_gas_min,
-                (int) species->required_gas_max, gas_string[species->required_gas]);
-        fprintf(report_file, "\nNeutral Gases:");
-        for (i = 0; i < 6; i++) {
-            if (i != 0) { fprintf(report_file, ","); }
-            fprintf(report_file, " %s", gas_string[species->neutral_gas[i]]);
+    /* Print header for status report. */
+    fprintf(report_file, "\n\t\t\t SPECIES STATUS\n\n\t\t\tSTART OF TURN %d\n\n", turn_number);
+    fprintf(report_file, "Species name: %s\n", species->name);
+    fprintf(report_file, "Government name: %s\n", species->govt_name);
+    fprintf(report_file, "Government type: %s\n", species->govt_type);
+
+    /* The structured copy of the report is filled in as the text is written. */
+    json_report = NULL;
+    json_list = NULL;
+    if (json_wanted) {
+        json_report = cJSON_CreateObject();
+        if (json_report == NULL) {
+            fprintf(stderr, "error: report: unable to allocate object\n");
+            exit(2);
         }
-        fprintf(report_file, "\nPoisonous Gases:");
-        for (i = 0; i < 6; i++) {
-            if (i != 0) { fprintf(report_file, ","); }
-            fprintf(report_file, " %s", gas_string[species->poison_gas[i]]);
+        jsonAddIntToObj(json_report, "report", "turn", turn_number);
+        jsonAddIntToObj(json_report, "report", "species_number", species_number);
+        jsonAddStringToObj(json_report, "report", "species_name", species->name);
+        jsonAddStringToObj(json_report, "report", "government_name", species->govt_name);
+        jsonAddStringToObj(json_report, "report", "government_type", species->govt_type);
+        json_list = jsonArray(json_report, "report", "tech_levels");
+    }
+
+    fprintf(report_file, "\nTech Levels:\n");
+    for (i = 0; i < 6; i++) {
+        fprintf(report_file, "   %s = %d", tech_name[i], species->tech_level[i]);
+        if (species->tech_knowledge[i] > species->tech_level[i]) {
+            fprintf(report_file, "/%d", species->tech_knowledge[i]);
         }
         fprintf(report_file, "\n");
+        if (json_list != NULL) {
+            json_obj = jsonObject(json_list, "tech_levels");
+            jsonAddStringToObj(json_obj, "tech_level", "code", tech_abbr[i]);
+            jsonAddIntToObj(json_obj, "tech_level", "level", species->tech_level[i]);
+            jsonAddIntToObj(json_obj, "tech_level", "knowledge", species->tech_knowledge[i]);
+        }
+    }
 
-        /* List fleet maintenance cost and its percentage of total production. */
-        fleet_percent_cost = species->fleet_percent_cost;
+    fprintf(report_file, "\nAtmospheric Requirement: %d%%-%d%% %s", (int) species->required_gas_min,
+            (int) species->required_gas_max, gas_string[species->required_gas]);
+    if (json_report != NULL) {
+        jsonAddStringToObj(json_report, "report", "required_gas", gas_string[species->required_gas]);
+        jsonAddIntToObj(json_report, "report", "required_gas_min", species->required_gas_min);
+        jsonAddIntToObj(json_report, "report", "required_gas_max", species->required_gas_max);
+        json_list = jsonArray(json_report, "report", "neutral_gases");
+    }
+    fprintf(report_file, "\nNeutral Gases:");
+    for (i = 0; i < 6; i++) {
+        if (i != 0) { fprintf(report_file, ","); }
+        fprintf(report_file, " %s", gas_string[species->neutral_gas[i]]);
+        if (json_list != NULL) {
+            jsonAddStringToArray(json_list, "neutral_gases", gas_string[species->neutral_gas[i]]);
+        }
+    }
+    if (json_report != NULL) {
+        json_list = jsonArray(json_report, "report", "poison_gases");
+    }
+    fprintf(report_file, "\nPoisonous Gases:");
+    for (i = 0; i < 6; i++) {
+        if (i != 0) { fprintf(report_file, ","); }
+        fprintf(report_file, " %s", gas_string[species->poison_gas[i]]);
+        if (json_list != NULL) {
+            jsonAddStringToArray(json_list, "poison_gases", gas_string[species->poison_gas[i]]);
+        }
+    }
+    fprintf(report_file, "\n");
 
-        fprintf(report_file, "\nFleet maintenance cost = %d (%d.%02d%% of total production)\n",
-                species->fleet_cost, fleet_percent_cost / 100, fleet_percent_cost % 100);
+    /* List fleet maintenance cost and its percentage of total production. */
+    fleet_percent_cost = species->fleet_percent_cost;
 
-        if (fleet_percent_cost > 10000) { fleet_percent_cost = 10000; }
+    fprintf(report_file, "\nFleet maintenance cost = %d (%d.%02d%% of total production)\n",
+            species->fleet_cost, fleet_percent_cost / 100, fleet_percent_cost % 100);
+    if (json_report != NULL) {
+        jsonAddIntToObj(json_report, "report", "fleet_cost", species->fleet_cost);
+        jsonAddIntToObj(json_report, "report", "fleet_percent_cost", fleet_percent_cost);
+    }
 
-        /* List species that have been met. */
-        n = 0;
-        log_file = report_file;        /* Use log utils for this. */
-        log_stdout = FALSE;
-        header_printed = FALSE;
-        for (sp_index = 0; sp_index < galaxy.num_species; sp_index++) {
-            if (!data_in_memory[sp_index]) { continue; }
+    if (fleet_percent_cost > 10000) { fleet_percent_cost = 10000; }
 
-            array_index = (sp_index) / 32;
-            bit_number = (sp_index) % 32;
-            bit_mask = 1 << bit_number;
-            if ((species->contact[array_index] & bit_mask) == 0) { continue; }
+    /* List species that have been met. */
+    n = 0;
+    log_file = report_file;        /* Use log utils for this. */
+    log_stdout = FALSE;
+    header_printed = FALSE;
+    json_list = json_report != NULL ? jsonArray(json_report, "report", "species_met") : NULL;
+    for (sp_index = 0; sp_index < galaxy.num_species; sp_index++) {
+        if (!data_in_memory[sp_index]) { continue; }
 
-            if (!header_printed) {
-                log_string("\nSpecies met: ");
-                header_printed = TRUE;
-            }
+        array_index = (sp_index) / 32;
+        bit_number = (sp_index) % 32;
+        bit_mask = 1 << bit_number;
+        if ((species->contact[array_index] & bit_mask) == 0) { continue; }
 
-            if (n > 0) { log_string(", "); }
-            log_string("SP ");
-            log_string(spec_data[sp_index].name);
-            ++n;
+        if (!header_printed) {
+            log_string("\nSpecies met: ");
+            header_printed = TRUE;
         }
-        if (n > 0) { log_char('\n'); }
 
-        /* List declared allies. */
-        n = 0;
-        header_printed = FALSE;
-        for (sp_index = 0; sp_index < galaxy.num_species; sp_index++) {
-            if (!data_in_memory[sp_index]) { continue; }
+        if (n > 0) { log_string(", "); }
+        log_string("SP ");
+        log_string(spec_data[sp_index].name);
+        if (json_list != NULL) {
+            jsonAddStringToArray(json_list, "species", spec_data[sp_index].name);
+        }
+        ++n;
+    }
+    if (n > 0) { log_char('\n'); }
 
-            array_index = (sp_index) / 32;
-            bit_number = (sp_index) % 32;
-            bit_mask = 1 << bit_number;
-            if ((species->ally[array_index] & bit_mask) == 0) { continue; }
-            if ((species->contact[array_index] & bit_mask) == 0) { continue; }
+    /* List declared allies. */
+    n = 0;
+    header_printed = FALSE;
+    json_list = json_report != NULL ? jsonArray(json_report, "report", "allies") : NULL;
+    for (sp_index = 0; sp_index < galaxy.num_species; sp_index++) {
+        if (!data_in_memory[sp_index]) { continue; }
 
-            if (!header_printed) {
-                log_string("\nAllies: ");
-                header_printed = TRUE;
-            }
+        array_index = (sp_index) / 32;
+        bit_number = (sp_index) % 32;
+        bit_mask = 1 << bit_number;
+        if ((species->ally[array_index] & bit_mask) == 0) { continue; }
+        if ((species->contact[array_index] & bit_mask) == 0) { continue; }
 
-            if (n > 0) { log_string(", "); }
-            log_string("SP ");
-            log_string(spec_data[sp_index].name);
-            ++n;
+        if (!header_printed) {
+            log_string("\nAllies: ");
+            header_printed = TRUE;
         }
-        if (n > 0) { log_char('\n'); }
 
-        /* List declared enemies that have been met. */
-        n = 0;
-        header_printed = FALSE;
-        for (sp_index = 0; sp_index < galaxy.num_species; sp_index++) {
-            if (!data_in_memory[sp_index]) { continue; }
+        if (n > 0) { log_string(", "); }
+        log_string("SP ");
+        log_string(spec_data[sp_index].name);
+        if (json_list != NULL) {
+            jsonAddStringToArray(json_list, "species", spec_data[sp_index].name);
+        }
+        ++n;
+    }
+    if (n > 0) { log_char('\n'); }
 
-            array_index = (sp_index) / 32;
-            bit_number = (sp_index) % 32;
-            bit_mask = 1 << bit_number;
-            if ((species->enemy[array_index] & bit_mask) == 0) { continue; }
-            if ((species->contact[array_index] & bit_mask) == 0) { continue; }
+    /* List declared enemies that have been met. */
+    n = 0;
+    header_printed = FALSE;
+    json_list = json_report != NULL ? jsonArray(json_report, "report", "enemies") : NULL;
+    for (sp_index = 0; sp_index < galaxy.num_species; sp_index++) {
+        if (!data_in_memory[sp_index]) { continue; }
 
-            if (!header_printed) {
-                log_string("\nEnemies: ");
-                header_printed = TRUE;
-            }
+        array_index = (sp_index) / 32;
+        bit_number = (sp_index) % 32;
+        bit_mask = 1 << bit_number;
+        if ((species->enemy[array_index] & bit_mask) == 0) { continue; }
+        if ((species->contact[array_index] & bit_mask) == 0) { continue; }
 
-            if (n > 0) { log_string(", "); }
-            log_string("SP ");
-            log_string(spec_data[sp_index].name);
-            ++n;
+        if (!header_printed) {
+            log_string("\nEnemies: ");
+            header_printed = TRUE;
         }
-        if (n > 0) { log_char('\n'); }
 
-        fprintf(report_file, "\nEconomic units = %d\n", species->econ_units);
+        if (n > 0) { log_string(", "); }
+        log_string("SP ");
+        log_string(spec_data[sp_index].name);
+        if (json_list != NULL) {
+            jsonAddStringToArray(json_list, "species", spec_data[sp_index].name);
+        }
+        ++n;
+    }
+    if (n > 0) { log_char('\n'); }
 
-        /* Initialize flag. */
-        for (i = 0; i < species->num_ships; i++) {
-            ship_already_listed[i] = FALSE;
+    fprintf(report_file, "\nEconomic units = %d\n", species->econ_units);
+    if (json_report != NULL) {
+        jsonAddIntToObj(json_report, "report", "econ_units", species->econ_units);
+        jsonArray(json_report, "report", "producing_planets");
+    }
+
+    /* Initialize flag. */
+    ship_already_listed = ncalloc(__FUNCTION__, __LINE__, species->num_ships + 1, sizeof(char));
+
+    /* Sort the ships by location so that the ships at a planet or in a sector can be found without a scan. */
+    ships_by_location = ncalloc(__FUNCTION__, __LINE__, species->num_ships + 1, sizeof(int));
+    for (i = 0; i < species->num_ships; i++) {
+        ships_by_location[i] = i;
+    }
+    qsort(ships_by_location, species->num_ships, sizeof(int), shipLocationCompare);
+
+    /* Print report for each producing planet. */
+    nampla = nampla1_base - 1;
+    for (i = 0; i < species->num_namplas; i++) {
+        ++nampla;
+
+        if (nampla->pn == 99) { continue; }
+        if (nampla->mi_base == 0 && nampla->ma_base == 0 && (nampla->status & HOME_PLANET) == 0) {
+            continue;
         }
 
-        /* Print report for each producing planet. */
-        nampla = nampla1_base - 1;
-        for (i = 0; i < species->num_namplas; i++) {
-            ++nampla;
+        planet = planet_base + (long) nampla->planet_index;
+        fprintf(report_file, "\n\n* * * * * * * * * * * * * * * * * * * * * * * * *\n");
+        do_planet_report(nampla, ship1_base, species);
+    }
 
-            if (nampla->pn == 99) { continue; }
-            if (nampla->mi_base == 0 && nampla->ma_base == 0 && (nampla->status & HOME_PLANET) == 0) {
-                continue;
-            }
+    /* Give only a one-line listing for other planets. */
+    printing_alien = FALSE;
+    header_printed = FALSE;
+    json_list = json_report != NULL ? jsonArray(json_report, "report", "other_planets") : NULL;
+    nampla = nampla1_base - 1;
+    for (i = 0; i < species->num_namplas; i++) {
+        ++nampla;
 
-            planet = planet_base + (long) nampla->planet_index;
-            fprintf(report_file, "\n\n* * * * * * * * * * * * * * * * * * * * * * * * *\n");
-            do_planet_report(nampla, ship1_base, species);
+        if (nampla->pn == 99) { continue; }
+        if (nampla->mi_base > 0 || nampla->ma_base > 0 || (nampla->status & HOME_PLANET) != 0) {
+            continue;
         }
 
-        /* Give only a one-line listing for other planets. */
-        printing_alien = FALSE;
-        header_printed = FALSE;
-        nampla = nampla1_base - 1;
-        for (i = 0; i < species->num_namplas; i++) {
-            ++nampla;
+        if (!header_printed) {
+            fprintf(report_file, "\n\n* * * * * * * * * * * * * * * * * * * * * * * * *\n");
+            fprintf(report_file, "\n\nOther planets and ships:\n\n");
+            header_printed = TRUE;
+        }
+        fprintf(report_file, "%4d%3d%3d #%d\tPL %s", nampla->x, nampla->y, nampla->z, nampla->pn, nampla->name);
 
-            if (nampla->pn == 99) { continue; }
-            if (nampla->mi_base > 0 || nampla->ma_base > 0 || (nampla->status & HOME_PLANET) != 0) {
-                continue;
+        for (j = 0; j < MAX_ITEMS; j++) {
+            if (nampla->item_quantity[j] > 0) {
+                fprintf(report_file, ", %d %s", nampla->item_quantity[j], item_abbr[j]);
             }
+        }
+        fprintf(report_file, "\n");
 
-            if (!header_printed) {
-                fprintf(report_file, "\n\n* * * * * * * * * * * * * * * * * * * * * * * * *\n");
-                fprintf(report_file, "\n\nOther planets and ships:\n\n");
-                header_printed = TRUE;
-            }
-            fprintf(report_file, "%4d%3d%3d #%d\tPL %s", nampla->x, nampla->y, nampla->z, nampla->pn, nampla->name);
+        if (json_list != NULL) {
+            json_obj = jsonObject(json_list, "other_planets");
+            jsonAddStringToObj(json_obj, "planet", "name", nampla->name);
+            jsonAddIntToObj(json_obj, "planet", "x", nampla->x);
+            jsonAddIntToObj(json_obj, "planet", "y", nampla->y);
+            jsonAddIntToObj(json_obj, "planet", "z", nampla->z);
+            jsonAddIntToObj(json_obj, "planet", "pn", nampla->pn);
+            jsonItems(json_obj, "planet", nampla->item_quantity);
+            json_ships = jsonArray(json_obj, "planet", "ships");
+        }
+
+        /* Print any ships at this planet. */
+        for (k = shipsAtOrAfter(nampla->x, nampla->y, nampla->z, 0); k < species->num_ships; k++) {
+            ship_index = ships_by_location[k];
+            ship = ship1_base + ship_index;
+
+            if (ship->x != nampla->x || ship->y != nampla->y || ship->z != nampla->z) { break; }
+
+            if (ship_already_listed[ship_index]) { continue; }
+            if (ship->pn != nampla->pn) { continue; }
 
+            fprintf(report_file, "\t\t%s", ship_name(ship));
             for (j = 0; j < MAX_ITEMS; j++) {
-                if (nampla->item_quantity[j] > 0) {
-                    fprintf(report_file, ", %d %s", nampla->item_quantity[j], item_abbr[j]);
+                if (ship->item_quantity[j] > 0) {
+                    fprintf(report_file, ", %d %s", ship->item_quantity[j], item_abbr[j]);
                 }
             }
             fprintf(report_file, "\n");
+            if (json_ships != NULL) {
+                jsonOwnShip(json_ships, ship, full_ship_id, TRUE);
+            }
 
-            /* Print any ships at this planet. */
-            ship = ship1_base - 1;
-            for (ship_index = 0; ship_index < species->num_ships; ship_index++) {
-                ++ship;
+            ship_already_listed[ship_index] = TRUE;
+        }
+    }
 
-                if (ship_already_listed[ship_index]) { continue; }
+    json_ships = json_report != NULL ? jsonArray(json_report, "report", "other_ships") : NULL;
 
-                if (ship->x != nampla->x) { continue; }
-                if (ship->y != nampla->y) { continue; }
-                if (ship->z != nampla->z) { continue; }
-                if (ship->pn != nampla->pn) { continue; }
+    /* Report ships that are not associated with a planet. */
+    ship = ship1_base - 1;
+    for (ship_index = 0; ship_index < species->num_ships; ship_index++) {
+        ++ship;
 
-                fprintf(report_file, "\t\t%s", ship_name(ship));
-                for (j = 0; j < MAX_ITEMS; j++) {
-                    if (ship->item_quantity[j] > 0) {
-                        fprintf(report_file, ", %d %s", ship->item_quantity[j], item_abbr[j]);
-                    }
-                }
-                fprintf(report_file, "\n");
+        ship->special = 0;
 
-                ship_already_listed[ship_index] = TRUE;
-            }
+        if (ship_already_listed[ship_index]) { continue; }
+
+        ship_already_listed[ship_index] = TRUE;
+
+        if (ship->pn == 99) { continue; }
+
+        if (!header_printed) {
+            fprintf(report_file, "\n\n* * * * * * * * * * * * * * * * * * * * * * * * *\n");
+            fprintf(report_file, "\n\nOther planets and ships:\n\n");
+            header_printed = TRUE;
         }
 
-        /* Report ships that are not associated with a planet. */
-        ship = ship1_base - 1;
-        for (ship_index = 0; ship_index < species->num_ships; ship_index++) {
-            ++ship;
+        if (ship->status == JUMPED_IN_COMBAT || ship->status == FORCED_JUMP) {
+            fprintf(report_file, "  ?? ?? ??\t%s", ship_name(ship));
+        } else if (test_mode && ship->arrived_via_wormhole) {
+            fprintf(report_file, "  ?? ?? ??\t%s", ship_name(ship));
+        } else {
+            fprintf(report_file, "%4d%3d%3d\t%s", ship->x, ship->y, ship->z, ship_name(ship));
+        }
 
-            ship->special = 0;
+        for (i = 0; i < MAX_ITEMS; i++) {
+            if (ship->item_quantity[i] > 0) {
+                fprintf(report_file, ", %d %s", ship->item_quantity[i], item_abbr[i]);
+            }
+        }
+        fprintf(report_file, "\n");
 
-            if (ship_already_listed[ship_index]) { continue; }
+        if (json_ships != NULL) {
+            jsonOwnShip(json_ships, ship, full_ship_id,
+                        !(ship->status == JUMPED_IN_COMBAT || ship->status == FORCED_JUMP ||
+                          (test_mode && ship->arrived_via_wormhole)));
+        }
 
-            ship_already_listed[ship_index] = TRUE;
+        if (ship->status == JUMPED_IN_COMBAT || ship->status == FORCED_JUMP) {
+            continue;
+        }
 
-            if (ship->pn == 99) { continue; }
+        if (test_mode && ship->arrived_via_wormhole) { continue; }
 
-            if (!header_printed) {
-                fprintf(report_file, "\n\n* * * * * * * * * * * * * * * * * * * * * * * * *\n");
-                fprintf(report_file, "\n\nOther planets and ships:\n\n");
-                header_printed = TRUE;
-            }
+        /* Print other ships at the same location. */
+        for (k = shipsAtOrAfter(ship->x, ship->y, ship->z, ship_index + 1); k < species->num_ships; k++) {
+            i = ships_by_location[k];
+            ship2 = ship1_base + i;
 
-            if (ship->status == JUMPED_IN_COMBAT || ship->status == FORCED_JUMP) {
-                fprintf(report_file, "  ?? ?? ??\t%s", ship_name(ship));
-            } else if (test_mode && ship->arrived_via_wormhole) {
-                fprintf(report_file, "  ?? ?? ??\t%s", ship_name(ship));
-            } else {
-                fprintf(report_file, "%4d%3d%3d\t%s", ship->x, ship->y, ship->z, ship_name(ship));
-            }
+            if (ship2->x != ship->x || ship2->y != ship->y || ship2->z != ship->z) { break; }
+
+            if (ship_already_listed[i]) { continue; }
+            if (ship2->pn == 99) { continue; }
 
-            for (i = 0; i < MAX_ITEMS; i++) {
-                if (ship->item_quantity[i] > 0) {
-                    fprintf(report_file, ", %d %s", ship->item_quantity[i], item_abbr[i]);
+            fprintf(report_file, "\t\t%s", ship_name(ship2));
+            for (j = 0; j < MAX_ITEMS; j++) {
+                if (ship2->item_quantity[j] > 0) {
+                    fprintf(report_file, ", %d %s", ship2->item_quantity[j], item_abbr[j]);
                 }
             }
             fprintf(report_file, "\n");
-
-            if (ship->status == JUMPED_IN_COMBAT || ship->status == FORCED_JUMP) {
-                continue;
+            if (json_ships != NULL) {
+                jsonOwnShip(json_ships, ship2, full_ship_id, TRUE);
             }
 
-            if (test_mode && ship->arrived_via_wormhole) { continue; }
+            ship_already_listed[i] = TRUE;
+        }
+    }
 
-            /* Print other ships at the same location. */
-            ship2 = ship;
-            for (i = ship_index + 1; i < species->num_ships; i++) {
-                ++ship2;
+    fprintf(report_file, "\n\n* * * * * * * * * * * * * * * * * * * * * * * * *\n");
 
-                if (ship_already_listed[i]) { continue; }
-                if (ship2->pn == 99) { continue; }
-                if (ship2->x != ship->x) { continue; }
-                if (ship2->y != ship->y) { continue; }
-                if (ship2->z != ship->z) { continue; }
+    /* Report aliens at locations where current species has inhabited planets or ships. */
+    printing_alien = TRUE;
+    json_list = json_report != NULL ? jsonArray(json_report, "report", "aliens") : NULL;
+    json_location = NULL;
+    locations_base = &loc[0];
+    for (my_loc_index = locationFirstOf(species_number); my_loc_index >= 0; my_loc_index = locationNextOf(my_loc_index)) {
+        my_loc = locations_base + my_loc_index;
+        if (locationCountAt(my_loc_index) < 2) { continue; }
 
-                fprintf(report_file, "\t\t%s", ship_name(ship2));
-                for (j = 0; j < MAX_ITEMS; j++) {
-                    if (ship2->item_quantity[j] > 0) {
-                        fprintf(report_file, ", %d %s", ship2->item_quantity[j], item_abbr[j]);
-                    }
+        header_printed = FALSE;
+        json_location = NULL;
+        sector = sectorAt(my_loc->x, my_loc->y, my_loc->z);
+        for (its_loc_index = locationFirstAt(my_loc->x, my_loc->y, my_loc->z); its_loc_index >= 0; its_loc_index = locationNextAt(its_loc_index)) {
+            its_loc = locations_base + its_loc_index;
+            if (its_loc->s == species_number) { continue; }
+
+            /* There is an alien here. Check if pointers for data for this alien have been assigned yet. */
+            if (its_loc->s != alien_number) {
+                alien_number = its_loc->s;
+                if (!data_in_memory[alien_number - 1]) {
+                    fprintf(stderr, "\n\nWarning! Data for alien #%d is needed but is not in memory!\n\n",
+                            alien_number);
+                    continue;
                 }
-                fprintf(report_file, "\n");
-
-                ship_already_listed[i] = TRUE;
+                alien = &spec_data[alien_number - 1];
+                nampla2_base = namp_data[alien_number - 1];
+                ship2_base = ship_data[alien_number - 1];
             }
-        }
 
-        fprintf(report_file, "\n\n* * * * * * * * * * * * * * * * * * * * * * * * *\n");
+            /* Check if we have a named planet in this system. If so, use it when you print the header. */
+            we_have_planet_here = FALSE;
+            for (i = 0; sector != NULL && i < sector->num_namplas; i++) {
+                if (sector->nampla[i].species_index != species_number - 1) { continue; }
+                nampla = nampla1_base + sector->nampla[i].index;
 
-        /* Report aliens at locations where current species has inhabited planets or ships. */
-        printing_alien = TRUE;
-        locations_base = &loc[0];
-        my_loc = locations_base - 1;
-        for (my_loc_index = 0; my_loc_index < num_locs; my_loc_index++) {
-            ++my_loc;
-            if (my_loc->s != species_number) { continue; }
-
-            header_printed = FALSE;
-            its_loc = locations_base - 1;
-            for (its_loc_index = 0; its_loc_index < num_locs; its_loc_index++) {
-                ++its_loc;
-                if (its_loc->s == species_number) { continue; }
-                if (my_loc->x != its_loc->x) { continue; }
-                if (my_loc->y != its_loc->y) { continue; }
-                if (my_loc->z != its_loc->z) { continue; }
-
-                /* There is an alien here. Check if pointers for data for this alien have been assigned yet. */
-                if (its_loc->s != alien_number) {
-                    alien_number = its_loc->s;
-                    if (!data_in_memory[alien_number - 1]) {
-                        fprintf(stderr, "\n\nWarning! Data for alien #%d is needed but is not in memory!\n\n",
-                                alien_number);
-                        continue;
-                    }
-                    alien = &spec_data[alien_number - 1];
-                    nampla2_base = namp_data[alien_number - 1];
-                    ship2_base = ship_data[alien_number - 1];
-                }
+                if (nampla->x != my_loc->x) { continue; }
+                if (nampla->y != my_loc->y) { continue; }
+                if (nampla->z != my_loc->z) { continue; }
+                if (nampla->pn == 99) { continue; }
 
-                /* Check if we have a named planet in this system. If so, use it when you print the header. */
-                we_have_planet_here = FALSE;
-                nampla = nampla1_base - 1;
-                for (i = 0; i < species->num_namplas; i++) {
-                    ++nampla;
+                we_have_planet_here = TRUE;
+                our_nampla = nampla;
 
-                    if (nampla->x != my_loc->x) { continue; }
-                    if (nampla->y != my_loc->y) { continue; }
-                    if (nampla->z != my_loc->z) { continue; }
-                    if (nampla->pn == 99) { continue; }
+                break;
+            }
 
-                    we_have_planet_here = TRUE;
-                    our_nampla = nampla;
+            /* Print all inhabited alien namplas at this location. */
+            for (i = 0; sector != NULL && i < sector->num_namplas; i++) {
+                if (sector->nampla[i].species_index != alien_number - 1) { continue; }
+                alien_nampla = nampla2_base + sector->nampla[i].index;
 
-                    break;
-                }
+                if (my_loc->x != alien_nampla->x) { continue; }
+                if (my_loc->y != alien_nampla->y) { continue; }
+                if (my_loc->z != alien_nampla->z) { continue; }
+                if ((alien_nampla->status & POPULATED) == 0) { continue; }
 
-                /* Print all inhabited alien namplas at this location. */
-                alien_nampla = nampla2_base - 1;
-                for (i = 0; i < alien->num_namplas; i++) {
-                    ++alien_nampla;
+                /* Check if current species has a colony on the same planet. */
+                we_have_colony_here = FALSE;
+                for (j = 0; j < sector->num_namplas; j++) {
+                    if (sector->nampla[j].species_index != species_number - 1) { continue; }
+                    nampla = nampla1_base + sector->nampla[j].index;
 
-                    if (my_loc->x != alien_nampla->x) { continue; }
-                    if (my_loc->y != alien_nampla->y) { continue; }
-                    if (my_loc->z != alien_nampla->z) { continue; }
-                    if ((alien_nampla->status & POPULATED) == 0) { continue; }
+                    if (alien_nampla->x != nampla->x) { continue; }
+                    if (alien_nampla->y != nampla->y) { continue; }
+                    if (alien_nampla->z != nampla->z) { continue; }
+                    if (alien_nampla->pn != nampla->pn) { continue; }
+                    if ((nampla->status & POPULATED) == 0) { continue; }
 
-                    /* Check if current species has a colony on the same planet. */
-                    we_have_colony_here = FALSE;
-                    nampla = nampla1_base - 1;
-                    for (j = 0; j < species->num_namplas; j++) {
-                        ++nampla;
+                    we_have_colony_here = TRUE;
 
-                        if (alien_nampla->x != nampla->x) { continue; }
-                        if (alien_nampla->y != nampla->y) { continue; }
-                        if (alien_nampla->z != nampla->z) { continue; }
-                        if (alien_nampla->pn != nampla->pn) { continue; }
-                        if ((nampla->status & POPULATED) == 0) { continue; }
+                    break;
+                }
 
-                        we_have_colony_here = TRUE;
+                if (alien_nampla->hidden && !we_have_colony_here) {
+                    continue;
+                }
 
-                        break;
-                    }
+                if (!header_printed) {
+                    fprintf(report_file, "\n\nAliens at x = %d, y = %d, z = %d", my_loc->x, my_loc->y, my_loc->z);
 
-                    if (alien_nampla->hidden && !we_have_colony_here) {
-                        continue;
+                    if (we_have_planet_here) {
+                        fprintf(report_file, " (PL %s star system)", our_nampla->name);
                     }
 
-                    if (!header_printed) {
-                        fprintf(report_file, "\n\nAliens at x = %d, y = %d, z = %d", my_loc->x, my_loc->y, my_loc->z);
+                    fprintf(report_file, ":\n");
+                    header_printed = TRUE;
 
+                    if (json_list != NULL) {
+                        json_location = jsonObject(json_list, "aliens");
+                        jsonAddIntToObj(json_location, "aliens", "x", my_loc->x);
+                        jsonAddIntToObj(json_location, "aliens", "y", my_loc->y);
+                        jsonAddIntToObj(json_location, "aliens", "z", my_loc->z);
                         if (we_have_planet_here) {
-                            fprintf(report_file, " (PL %s star system)", our_nampla->name);
+                            jsonAddStringToObj(json_location, "aliens", "system", our_nampla->name);
                         }
-
-                        fprintf(report_file, ":\n");
-                        header_printed = TRUE;
-                    }
-
-                    industry = alien_nampla->mi_base + alien_nampla->ma_base;
-
-                    const char *temp1;
-                    if (alien_nampla->status & MINING_COLONY) {
-                        temp1 = "Mining colony";
-                    } else if (alien_nampla->status & RESORT_COLONY) {
-                        temp1 = "Resort colony";
-                    } else if (alien_nampla->status & HOME_PLANET) {
-                        temp1 = "Home planet";
-                    } else if (industry > 0) {
-                        temp1 = "Colony planet";
-                    } else {
-                        temp1 = "Uncolonized planet";
+                        jsonArray(json_location, "aliens", "planets");
+                        json_ships = jsonArray(json_location, "aliens", "ships");
                     }
+                }
 
-                    sprintf(temp2, "  %s PL %s (pl #%d)", temp1, alien_nampla->name, alien_nampla->pn);
-                    n = 53 - strlen(temp2);
-                    for (j = 0; j < n; j++) { strcat(temp2, " "); }
-                    fprintf(report_file, "%sSP %s\n", temp2, alien->name);
+                industry = alien_nampla->mi_base + alien_nampla->ma_base;
+
+                const char *temp1;
+                if (alien_nampla->status & MINING_COLONY) {
+                    temp1 = "Mining colony";
+                } else if (alien_nampla->status & RESORT_COLONY) {
+                    temp1 = "Resort colony";
+                } else if (alien_nampla->status & HOME_PLANET) {
+                    temp1 = "Home planet";
+                } else if (industry > 0) {
+                    temp1 = "Colony planet";
+                } else {
+                    temp1 = "Uncolonized planet";
+                }
 
-                    j = industry;
-                    if (industry < 100) {
-                        industry = (industry + 5) / 10;
-                    } else {
-                        industry = ((industry + 50) / 100) * 10;
-                    }
+                sprintf(temp2, "  %s PL %s (pl #%d)", temp1, alien_nampla->name, alien_nampla->pn);
+                n = 53 - strlen(temp2);
+                for (j = 0; j < n; j++) { strcat(temp2, " "); }
+                fprintf(report_file, "%sSP %s\n", temp2, alien->name);
+
+                json_obj = NULL;
+                if (json_location != NULL) {
+                    json_obj = jsonObject(cJSON_GetObjectItemCaseSensitive(json_location, "planets"), "planets");
+                    jsonAddStringToObj(json_obj, "planet", "type", temp1);
+                    jsonAddStringToObj(json_obj, "planet", "name", alien_nampla->name);
+                    jsonAddIntToObj(json_obj, "planet", "pn", alien_nampla->pn);
+                    jsonAddStringToObj(json_obj, "planet", "species", alien->name);
+                }
 
-                    if (j == 0) {
-                        fprintf(report_file, "      (No economic base.)\n");
-                    } else {
-                        fprintf(report_file, "      (Economic base is approximately %d.)\n", industry);
-                    }
+                j = industry;
+                if (industry < 100) {
+                    industry = (industry + 5) / 10;
+                } else {
+                    industry = ((industry + 50) / 100) * 10;
+                }
 
-                    /* If current species has a colony on the same planet, report any PDs and any shipyards. */
+                if (j == 0) {
+                    fprintf(report_file, "      (No economic base.)\n");
+                } else {
+                    fprintf(report_file, "      (Economic base is approximately %d.)\n", industry);
+                }
+                if (json_obj != NULL) {
+                    jsonAddIntToObj(json_obj, "planet", "economic_base", j == 0 ? 0 : industry);
+                    jsonAddBoolToObj(json_obj, "planet", "hidden", alien_nampla->hidden);
                     if (we_have_colony_here) {
-                        if (alien_nampla->item_quantity[PD] == 1) {
-                            fprintf(report_file, "      (There is 1 %s on the planet.)\n", item_name[PD]);
-                        } else if (alien_nampla->item_quantity[PD] > 1) {
-                            fprintf(report_file, "      (There are %d %ss on the planet.)\n",
-                                    alien_nampla->item_quantity[PD], item_name[PD]);
-                        }
+                        jsonAddIntToObj(json_obj, "planet", "pds", alien_nampla->item_quantity[PD]);
+                        jsonAddIntToObj(json_obj, "planet", "shipyards", alien_nampla->shipyards);
+                    }
+                }
 
-                        if (alien_nampla->shipyards == 1) {
-                            fprintf(report_file, "      (There is 1 shipyard on the planet.)\n");
-                        } else if (alien_nampla->shipyards > 1) {
-                            fprintf(report_file, "      (There are %d shipyards on the planet.)\n",
-                                    alien_nampla->shipyards);
-                        }
+                /* If current species has a colony on the same planet, report any PDs and any shipyards. */
+                if (we_have_colony_here) {
+                    if (alien_nampla->item_quantity[PD] == 1) {
+                        fprintf(report_file, "      (There is 1 %s on the planet.)\n", item_name[PD]);
+                    } else if (alien_nampla->item_quantity[PD] > 1) {
+                        fprintf(report_file, "      (There are %d %ss on the planet.)\n",
+                                alien_nampla->item_quantity[PD], item_name[PD]);
                     }
 
-                    /* Also report if alien colony is actively hiding. */
-                    if (alien_nampla->hidden) {
-                        fprintf(report_file, "      (Colony is actively hiding from alien observation.)\n");
+                    if (alien_nampla->shipyards == 1) {
+                        fprintf(report_file, "      (There is 1 shipyard on the planet.)\n");
+                    } else if (alien_nampla->shipyards > 1) {
+                        fprintf(report_file, "      (There are %d shipyards on the planet.)\n",
+                                alien_nampla->shipyards);
                     }
                 }
 
-                /* Print all alien ships at this location. */
-                alien_ship = ship2_base - 1;
-                for (i = 0; i < alien->num_ships; i++) {
-                    ++alien_ship;
-
-                    if (alien_ship->pn == 99) { continue; }
-                    if (my_loc->x != alien_ship->x) { continue; }
-                    if (my_loc->y != alien_ship->y) { continue; }
-                    if (my_loc->z != alien_ship->z) { continue; }
-
-                    /* An alien ship cannot hide if it lands on the surface of a planet populated by the current species. */
-                    alien_can_hide = TRUE;
-                    nampla = nampla1_base - 1;
-                    for (j = 0; j < species->num_namplas; j++) {
-                        ++nampla;
-
-                        if (alien_ship->x != nampla->x) { continue; }
-                        if (alien_ship->y != nampla->y) { continue; }
-                        if (alien_ship->z != nampla->z) { continue; }
-                        if (alien_ship->pn != nampla->pn) { continue; }
-                        if (nampla->status & POPULATED) {
-                            alien_can_hide = FALSE;
-                            break;
-                        }
-                    }
+                /* Also report if alien colony is actively hiding. */
+                if (alien_nampla->hidden) {
+                    fprintf(report_file, "      (Colony is actively hiding from alien observation.)\n");
+                }
+            }
 
-                    if (alien_can_hide && alien_ship->status == ON_SURFACE) {
-                        continue;
+            /* Print all alien ships at this location. */
+            for (i = 0; sector != NULL && i < sector->num_ships; i++) {
+                if (sector->ship[i].species_index != alien_number - 1) { continue; }
+                alien_ship = ship2_base + sector->ship[i].index;
+
+                if (alien_ship->pn == 99) { continue; }
+                if (my_loc->x != alien_ship->x) { continue; }
+                if (my_loc->y != alien_ship->y) { continue; }
+                if (my_loc->z != alien_ship->z) { continue; }
+
+                /* An alien ship cannot hide if it lands on the surface of a planet populated by the current species. */
+                alien_can_hide = TRUE;
+                for (j = 0; j < sector->num_namplas; j++) {
+                    if (sector->nampla[j].species_index != species_number - 1) { continue; }
+                    nampla = nampla1_base + sector->nampla[j].index;
+
+                    if (alien_ship->x != nampla->x) { continue; }
+                    if (alien_ship->y != nampla->y) { continue; }
+                    if (alien_ship->z != nampla->z) { continue; }
+                    if (alien_ship->pn != nampla->pn) { continue; }
+                    if (nampla->status & POPULATED) {
+                        alien_can_hide = FALSE;
+                        break;
                     }
+                }
+
+                if (alien_can_hide && alien_ship->status == ON_SURFACE) {
+                    continue;
+                }
 
-                    if (alien_can_hide && alien_ship->status == UNDER_CONSTRUCTION) {
-                        continue;
+                if (alien_can_hide && alien_ship->status == UNDER_CONSTRUCTION) {
+                    continue;
+                }
+
+                if (!header_printed) {
+                    fprintf(report_file, "\n\nAliens at x = %d, y = %d, z = %d", my_loc->x, my_loc->y, my_loc->z);
+
+                    if (we_have_planet_here) {
+                        fprintf(report_file, " (PL %s star system)", our_nampla->name);
                     }
 
-                    if (!header_printed) {
-                        fprintf(report_file, "\n\nAliens at x = %d, y = %d, z = %d", my_loc->x, my_loc->y, my_loc->z);
+                    fprintf(report_file, ":\n");
+                    header_printed = TRUE;
 
+                    if (json_list != NULL) {
+                        json_location = jsonObject(json_list, "aliens");
+                        jsonAddIntToObj(json_location, "aliens", "x", my_loc->x);
+                        jsonAddIntToObj(json_location, "aliens", "y", my_loc->y);
+                        jsonAddIntToObj(json_location, "aliens", "z", my_loc->z);
                         if (we_have_planet_here) {
-                            fprintf(report_file, " (PL %s star system)", our_nampla->name);
+                            jsonAddStringToObj(json_location, "aliens", "system", our_nampla->name);
                         }
-
-                        fprintf(report_file, ":\n");
-                        header_printed = TRUE;
+                        jsonArray(json_location, "aliens", "planets");
+                        json_ships = jsonArray(json_location, "aliens", "ships");
                     }
-
-                    print_ship(alien_ship, alien, alien_number);
                 }
+
+                print_ship(alien_ship, alien, alien_number);
             }
         }
+    }
 
-        printing_alien = FALSE;
+    printing_alien = FALSE;
+    json_ships = NULL;
 
-        if (test_mode) { goto done_report; }
+    if (test_mode) { goto done_report; }
 
-        /* Generate order section. */
-        truncate_name = TRUE;
-        temp_ignore_field_distorters = ignore_field_distorters;
-        ignore_field_distorters = TRUE;
+    /* Generate order section. */
+    truncate_name = TRUE;
+    temp_ignore_field_distorters = ignore_field_distorters;
+    ignore_field_distorters = TRUE;
 
-        fprintf(report_file, "\n\n* * * * * * * * * * * * * * * * * * * * * * * * *\n");
+    fprintf(report_file, "\n\n* * * * * * * * * * * * * * * * * * * * * * * * *\n");
 
-        fprintf(report_file, "\n\nORDER SECTION. Remove these two lines and everything above\n");
-        fprintf(report_file, "  them, and submit only the orders below.\n\n");
+    fprintf(report_file, "\n\nORDER SECTION. Remove these two lines and everything above\n");
+    fprintf(report_file, "  them, and submit only the orders below.\n\n");
 
-        fprintf(report_file, "START COMBAT\n");
-        fprintf(report_file, "; Place combat orders here.\n\n");
-        fprintf(report_file, "END\n\n");
+    fprintf(report_file, "START COMBAT\n");
+    fprintf(report_file, "; Place combat orders here.\n\n");
+    fprintf(report_file, "END\n\n");
 
-        fprintf(report_file, "START PRE-DEPARTURE\n");
-        fprintf(report_file, "; Place pre-departure orders here.\n\n");
+    fprintf(report_file, "START PRE-DEPARTURE\n");
+    fprintf(report_file, "; Place pre-departure orders here.\n\n");
 
-        for (nampla_index = 0; nampla_index < species->num_namplas; nampla_index++) {
-            nampla = nampla_base + nampla_index;
-            if (nampla->pn == 99) { continue; }
+    for (nampla_index = 0; nampla_index < species->num_namplas; nampla_index++) {
+        nampla = nampla_base + nampla_index;
+        if (nampla->pn == 99) { continue; }
 
-            /* Generate auto-installs for colonies that were loaded via the DEVELOP command. */
-            if (nampla->auto_IUs) {
-                fprintf(report_file, "\tInstall\t%d IU\tPL %s\n", nampla->auto_IUs, nampla->name);
+        /* Generate auto-installs for colonies that were loaded via the DEVELOP command. */
+        if (nampla->auto_IUs) {
+            fprintf(report_file, "\tInstall\t%d IU\tPL %s\n", nampla->auto_IUs, nampla->name);
+        }
+        if (nampla->auto_AUs) {
+            fprintf(report_file, "\tInstall\t%d AU\tPL %s\n", nampla->auto_AUs, nampla->name);
+        }
+        if (nampla->auto_IUs || nampla->auto_AUs) {
+            fprintf(report_file, "\n");
+        }
+
+        if (!species->auto_orders) { continue; }
+
+        /* Generate auto UNLOAD orders for transports at this nampla. */
+        for (j = 0; j < species->num_ships; j++) {
+            ship = ship_base + j;
+            if (ship->pn == 99) { continue; }
+            if (ship->x != nampla->x) { continue; }
+            if (ship->y != nampla->y) { continue; }
+            if (ship->z != nampla->z) { continue; }
+            if (ship->pn != nampla->pn) { continue; }
+            if (ship->status == JUMPED_IN_COMBAT) { continue; }
+            if (ship->status == FORCED_JUMP) { continue; }
+            if (ship->class != TR) { continue; }
+            if (ship->item_quantity[CU] < 1) { continue; }
+
+            /* New colonies will never be started automatically unless ship was loaded via a DEVELOP order. */
+            if (ship->loading_point != 0) {
+                /* Check if transport is at specified unloading point. */
+                n = ship->unloading_point;
+                if (n == nampla_index || (n == 9999 && nampla_index == 0)) {
+                    goto unload_ship;
+                }
             }
-            if (nampla->auto_AUs) {
-                fprintf(report_file, "\tInstall\t%d AU\tPL %s\n", nampla->auto_AUs, nampla->name);
+
+            if ((nampla->status & POPULATED) == 0) { continue; }
+
+            if ((nampla->mi_base + nampla->ma_base) >= 2000) { continue; }
+
+            if (nampla->x == nampla_base->x && nampla->y == nampla_base->y && nampla->z == nampla_base->z) {
+                /* Home sector. */
+                continue;
+            }
+
+            unload_ship:
+
+            n = ship->loading_point;
+            if (n == 9999) {
+                /* Home planet. */
+                n = 0;
             }
-            if (nampla->auto_IUs || nampla->auto_AUs) {
-                fprintf(report_file, "\n");
+            if (n == nampla_index) {
+                /* Ship was just loaded here. */
+                continue;
             }
 
-            if (!species->auto_orders) { continue; }
-
-            /* Generate auto UNLOAD orders for transports at this nampla. */
-            for (j = 0; j < species->num_ships; j++) {
-                ship = ship_base + j;
-                if (ship->pn == 99) { continue; }
-                if (ship->x != nampla->x) { continue; }
-                if (ship->y != nampla->y) { continue; }
-                if (ship->z != nampla->z) { continue; }
-                if (ship->pn != nampla->pn) { continue; }
-                if (ship->status == JUMPED_IN_COMBAT) { continue; }
-                if (ship->status == FORCED_JUMP) { continue; }
-                if (ship->class != TR) { continue; }
-                if (ship->item_quantity[CU] < 1) { continue; }
-
-                /* New colonies will never be started automatically unless ship was loaded via a DEVELOP order. */
-                if (ship->loading_point != 0) {
-                    /* Check if transport is at specified unloading point. */
-                    n = ship->unloading_point;
-                    if (n == nampla_index || (n == 9999 && nampla_index == 0)) {
-                        goto unload_ship;
-                    }
-                }
+            fprintf(report_file, "\tUnload\tTR%d%s %s\n\n", ship->tonnage, ship_type[ship->type], ship->name);
 
-                if ((nampla->status & POPULATED) == 0) { continue; }
+            ship->special = ship->loading_point;
+            n = nampla - nampla_base;
+            if (n == 0) { n = 9999; }
+            ship->unloading_point = n;
+        }
+    }
 
-                if ((nampla->mi_base + nampla->ma_base) >= 2000) { continue; }
+    fprintf(report_file, "END\n\n");
 
-                if (nampla->x == nampla_base->x && nampla->y == nampla_base->y && nampla->z == nampla_base->z) {
-                    /* Home sector. */
-                    continue;
-                }
+    fprintf(report_file, "START JUMPS\n");
+    fprintf(report_file, "; Place jump orders here.\n\n");
 
-                unload_ship:
+    /* Generate auto-jumps for ships that were loaded via the DEVELOP command or which were UNLOADed because of the AUTO command. */
+    for (i = 0; i < species->num_ships; i++) {
+        ship = ship_base + i;
 
-                n = ship->loading_point;
-                if (n == 9999) {
-                    /* Home planet. */
-                    n = 0;
-                }
-                if (n == nampla_index) {
-                    /* Ship was just loaded here. */
-                    continue;
-                }
+        ship->just_jumped = FALSE;
 
-                fprintf(report_file, "\tUnload\tTR%d%s %s\n\n", ship->tonnage, ship_type[ship->type], ship->name);
+        if (ship->pn == 99) { continue; }
+        if (ship->status == JUMPED_IN_COMBAT) { continue; }
+        if (ship->status == FORCED_JUMP) { continue; }
 
-                ship->special = ship->loading_point;
-                n = nampla - nampla_base;
-                if (n == 0) { n = 9999; }
-                ship->unloading_point = n;
+        j = ship->special;
+        if (j) {
+            if (j == 9999) {
+                /* Home planet. */
+                j = 0;
             }
-        }
+            temp_nampla = nampla_base + j;
 
-        fprintf(report_file, "END\n\n");
+            fprintf(report_file, "\tJump\t%s, PL %s\t; Age %d, ", ship_name(ship), temp_nampla->name, ship->age);
 
-        fprintf(report_file, "START JUMPS\n");
-        fprintf(report_file, "; Place jump orders here.\n\n");
+            print_mishap_chance(ship, temp_nampla->x, temp_nampla->y, temp_nampla->z);
 
-        /* Generate auto-jumps for ships that were loaded via the DEVELOP command or which were UNLOADed because of the AUTO command. */
-        for (i = 0; i < species->num_ships; i++) {
-            ship = ship_base + i;
+            fprintf(report_file, "\n\n");
 
-            ship->just_jumped = FALSE;
+            ship->just_jumped = TRUE;
 
-            if (ship->pn == 99) { continue; }
-            if (ship->status == JUMPED_IN_COMBAT) { continue; }
-            if (ship->status == FORCED_JUMP) { continue; }
+            continue;
+        }
 
-            j = ship->special;
-            if (j) {
-                if (j == 9999) {
-                    /* Home planet. */
-                    j = 0;
-                }
-                temp_nampla = nampla_base + j;
+        n = ship->unloading_point;
+        if (n) {
+            if (n == 9999) {
+                /* Home planet. */
+                n = 0;
+            }
 
-                fprintf(report_file, "\tJump\t%s, PL %s\t; Age %d, ", ship_name(ship), temp_nampla->name, ship->age);
+            temp_nampla = nampla_base + n;
 
-                print_mishap_chance(ship, temp_nampla->x, temp_nampla->y, temp_nampla->z);
+            fprintf(report_file, "\tJump\t%s, PL %s\t; ", ship_name(ship), temp_nampla->name);
 
-                fprintf(report_file, "\n\n");
+            print_mishap_chance(ship, temp_nampla->x, temp_nampla->y, temp_nampla->z);
 
-                ship->just_jumped = TRUE;
+            fprintf(report_file, "\n\n");
 
-                continue;
-            }
+            ship->just_jumped = TRUE;
+        }
+    }
 
-            n = ship->unloading_point;
-            if (n) {
-                if (n == 9999) {
-                    /* Home planet. */
-                    n = 0;
+    if (!species->auto_orders) { goto jump_end; }
+
+    /* Generate JUMP orders for all ships that have not yet been given orders. */
+    for (i = 0; i < species->num_ships; i++) {
+        ship = ship_base + i;
+        if (ship->pn == 99) { continue; }
+        if (ship->just_jumped) { continue; }
+        if (ship->status == UNDER_CONSTRUCTION) { continue; }
+        if (ship->status == JUMPED_IN_COMBAT) { continue; }
+        if (ship->status == FORCED_JUMP) { continue; }
+
+        if (ship->type == FTL) {
+            fprintf(report_file, "\tJump\t%s, ", ship_name(ship));
+            if (ship->class == TR && ship->tonnage == 1) {
+                closest_unvisited_star_report(ship, report_file, &x, &y, &z);
+                fprintf(report_file, "\n\t\t\t; Age %d, now at %d %d %d, ", ship->age, ship->x, ship->y, ship->z);
+
+                if (ship->status == IN_ORBIT) {
+                    fprintf(report_file, "O%d, ", ship->pn);
+                } else if (ship->status == ON_SURFACE) {
+                    fprintf(report_file, "L%d, ", ship->pn);
+                } else {
+                    fprintf(report_file, "D, ");
                 }
 
-                temp_nampla = nampla_base + n;
+                print_mishap_chance(ship, x, y, z);
+            } else {
+                fprintf(report_file, "???\t; Age %d, now at %d %d %d", ship->age, ship->x, ship->y, ship->z);
 
-                fprintf(report_file, "\tJump\t%s, PL %s\t; ", ship_name(ship), temp_nampla->name);
+                if (ship->status == IN_ORBIT) {
+                    fprintf(report_file, ", O%d", ship->pn);
+                } else if (ship->status == ON_SURFACE) {
+                    fprintf(report_file, ", L%d", ship->pn);
+                } else {
+                    fprintf(report_file, ", D");
+                }
 
-                print_mishap_chance(ship, temp_nampla->x, temp_nampla->y, temp_nampla->z);
+                x = 9999;
+            }
 
-                fprintf(report_file, "\n\n");
+            fprintf(report_file, "\n");
 
-                ship->just_jumped = TRUE;
+            /* Save destination so that we can check later if it needs to be scanned. */
+            if (x == 9999) {
+                ship->dest_x = -1;
+            } else {
+                ship->dest_x = x;
+                ship->dest_y = y;
+                ship->dest_z = z;
             }
         }
+    }
 
-        if (!species->auto_orders) { goto jump_end; }
+    jump_end:
+    fprintf(report_file, "END\n\n");
 
-        /* Generate JUMP orders for all ships that have not yet been given orders. */
-        for (i = 0; i < species->num_ships; i++) {
-            ship = ship_base + i;
-            if (ship->pn == 99) { continue; }
-            if (ship->just_jumped) { continue; }
-            if (ship->status == UNDER_CONSTRUCTION) { continue; }
-            if (ship->status == JUMPED_IN_COMBAT) { continue; }
-            if (ship->status == FORCED_JUMP) { continue; }
+    fprintf(report_file, "START PRODUCTION\n\n");
 
-            if (ship->type == FTL) {
-                fprintf(report_file, "\tJump\t%s, ", ship_name(ship));
-                if (ship->class == TR && ship->tonnage == 1) {
-                    closest_unvisited_star_report(ship, report_file);
-                    fprintf(report_file, "\n\t\t\t; Age %d, now at %d %d %d, ", ship->age, ship->x, ship->y, ship->z);
-
-                    if (ship->status == IN_ORBIT) {
-                        fprintf(report_file, "O%d, ", ship->pn);
-                    } else if (ship->status == ON_SURFACE) {
-                        fprintf(report_file, "L%d, ", ship->pn);
-                    } else {
-                        fprintf(report_file, "D, ");
-                    }
+    fprintf(report_file, ";   Economic units at start of turn = %d\n\n", species->econ_units);
 
-                    print_mishap_chance(ship, x, y, z);
-                } else {
-                    fprintf(report_file, "???\t; Age %d, now at %d %d %d", ship->age, ship->x, ship->y, ship->z);
-
-                    if (ship->status == IN_ORBIT) {
-                        fprintf(report_file, ", O%d", ship->pn);
-                    } else if (ship->status == ON_SURFACE) {
-                        fprintf(report_file, ", L%d", ship->pn);
-                    } else {
-                        fprintf(report_file, ", D");
-                    }
+    /* Generate a PRODUCTION order for each planet that can produce. */
+    for (nampla_index = species->num_namplas - 1; nampla_index >= 0; nampla_index--) {
+        nampla = nampla1_base + nampla_index;
+        if (nampla->pn == 99) { continue; }
 
-                    x = 9999;
-                }
+        if (nampla->mi_base == 0 && (nampla->status & RESORT_COLONY) == 0) { continue; }
+        if (nampla->ma_base == 0 && (nampla->status & MINING_COLONY) == 0) { continue; }
 
-                fprintf(report_file, "\n");
+        fprintf(report_file, "    PRODUCTION PL %s\n", nampla->name);
 
-                /* Save destination so that we can check later if it needs to be scanned. */
-                if (x == 9999) {
-                    ship->dest_x = -1;
+        if (nampla->status & MINING_COLONY) {
+            fprintf(report_file, "    ; The above PRODUCTION order is required for this mining colony, even\n");
+            fprintf(report_file, "    ;  if no other production orders are given for it. This mining colony\n");
+            fprintf(report_file, "    ;  will generate %d economic units this turn.\n", nampla->use_on_ambush);
+        } else if (nampla->status & RESORT_COLONY) {
+            fprintf(report_file, "    ; The above PRODUCTION order is required for this resort colony, even\n");
+            fprintf(report_file, "    ;  though no other production orders can be given for it.  This resort\n");
+            fprintf(report_file, "    ;  colony will generate %d economic units this turn.\n",
+                    nampla->use_on_ambush);
+        } else {
+            fprintf(report_file, "    ; Place production orders here for planet %s", nampla->name);
+            fprintf(report_file, " (sector %d %d %d #%d).\n", nampla->x, nampla->y, nampla->z, nampla->pn);
+            fprintf(report_file, "    ;  Avail pop = %d, shipyards = %d, to spend = %d",
+                    nampla->pop_units, nampla->shipyards, nampla->use_on_ambush);
+
+            n = nampla->use_on_ambush;
+            if (nampla->status & HOME_PLANET) {
+                if (species->hp_original_base != 0) {
+                    fprintf(report_file, " (max = %ld)", 5 * n);
                 } else {
-                    ship->dest_x = x;
-                    ship->dest_y = y;
-                    ship->dest_z = z;
+                    fprintf(report_file, " (max = no limit)");
                 }
+            } else {
+                fprintf(report_file, " (max = %ld)", 2 * n);
             }
+
+            fprintf(report_file, ".\n\n");
         }
 
-        jump_end:
-        fprintf(report_file, "END\n\n");
+        /* Build IUs and AUs for incoming ships with CUs. */
+        if (nampla->IUs_needed) {
+            fprintf(report_file, "\tBuild\t%d IU\n", nampla->IUs_needed);
+        }
+        if (nampla->AUs_needed) {
+            fprintf(report_file, "\tBuild\t%d AU\n", nampla->AUs_needed);
+        }
+        if (nampla->IUs_needed || nampla->AUs_needed) {
+            fprintf(report_file, "\n");
+        }
 
-        fprintf(report_file, "START PRODUCTION\n\n");
+        if (!species->auto_orders) { continue; }
+        if (nampla->status & MINING_COLONY) { continue; }
+        if (nampla->status & RESORT_COLONY) { continue; }
 
-        fprintf(report_file, ";   Economic units at start of turn = %d\n\n", species->econ_units);
+        /* See if there are any RMs to recycle. */
+        n = nampla->special / 5;
+        if (n > 0) {
+            fprintf(report_file, "\tRecycle\t%ld RM\n\n", 5 * n);
+        }
 
-        /* Generate a PRODUCTION order for each planet that can produce. */
-        for (nampla_index = species->num_namplas - 1; nampla_index >= 0; nampla_index--) {
-            nampla = nampla1_base + nampla_index;
-            if (nampla->pn == 99) { continue; }
+        /* Generate DEVELOP commands for ships arriving here because of
+        AUTO command. */
+        for (i = 0; i < species->num_ships; i++) {
+            ship = ship_base + i;
+            if (ship->pn == 99) { continue; }
 
-            if (nampla->mi_base == 0 && (nampla->status & RESORT_COLONY) == 0) { continue; }
-            if (nampla->ma_base == 0 && (nampla->status & MINING_COLONY) == 0) { continue; }
+            k = ship->special;
+            if (k == 0) { continue; }
+            if (k == 9999) { k = 0; }    /* Home planet. */
 
-            fprintf(report_file, "    PRODUCTION PL %s\n", nampla->name);
+            if (nampla != nampla_base + k) { continue; }
 
-            if (nampla->status & MINING_COLONY) {
-                fprintf(report_file, "    ; The above PRODUCTION order is required for this mining colony, even\n");
-                fprintf(report_file, "    ;  if no other production orders are given for it. This mining colony\n");
-                fprintf(report_file, "    ;  will generate %d economic units this turn.\n", nampla->use_on_ambush);
-            } else if (nampla->status & RESORT_COLONY) {
-                fprintf(report_file, "    ; The above PRODUCTION order is required for this resort colony, even\n");
-                fprintf(report_file, "    ;  though no other production orders can be given for it.  This resort\n");
-                fprintf(report_file, "    ;  colony will generate %d economic units this turn.\n",
-                        nampla->use_on_ambush);
-            } else {
-                fprintf(report_file, "    ; Place production orders here for planet %s", nampla->name);
-                fprintf(report_file, " (sector %d %d %d #%d).\n", nampla->x, nampla->y, nampla->z, nampla->pn);
-                fprintf(report_file, "    ;  Avail pop = %d, shipyards = %d, to spend = %d",
-                        nampla->pop_units, nampla->shipyards, nampla->use_on_ambush);
-
-                n = nampla->use_on_ambush;
-                if (nampla->status & HOME_PLANET) {
-                    if (species->hp_original_base != 0) {
-                        fprintf(report_file, " (max = %ld)", 5 * n);
-                    } else {
-                        fprintf(report_file, " (max = no limit)");
-                    }
-                } else {
-                    fprintf(report_file, " (max = %ld)", 2 * n);
-                }
+            k = ship->unloading_point;
+            if (k == 9999) { k = 0; }
+            temp_nampla = nampla_base + k;
 
-                fprintf(report_file, ".\n\n");
-            }
+            fprintf(report_file, "\tDevelop\tPL %s, TR%d%s %s\n\n", temp_nampla->name, ship->tonnage,
+                    ship_type[ship->type], ship->name);
+        }
 
-            /* Build IUs and AUs for incoming ships with CUs. */
-            if (nampla->IUs_needed) {
-                fprintf(report_file, "\tBuild\t%d IU\n", nampla->IUs_needed);
-            }
-            if (nampla->AUs_needed) {
-                fprintf(report_file, "\tBuild\t%d AU\n", nampla->AUs_needed);
-            }
-            if (nampla->IUs_needed || nampla->AUs_needed) {
-                fprintf(report_file, "\n");
-            }
+        /* Give orders to continue construction of unfinished ships and starbases. */
+        for (i = 0; i < species->num_ships; i++) {
+            ship = ship_base + i;
+            if (ship->pn == 99) { continue; }
 
-            if (!species->auto_orders) { continue; }
-            if (nampla->status & MINING_COLONY) { continue; }
-            if (nampla->status & RESORT_COLONY) { continue; }
+            if (ship->x != nampla->x) { continue; }
+            if (ship->y != nampla->y) { continue; }
+            if (ship->z != nampla->z) { continue; }
+            if (ship->pn != nampla->pn) { continue; }
 
-            /* See if there are any RMs to recycle. */
-            n = nampla->special / 5;
-            if (n > 0) {
-                fprintf(report_file, "\tRecycle\t%ld RM\n\n", 5 * n);
-            }
+            if (ship->status == UNDER_CONSTRUCTION) {
+                fprintf(report_file,
+                        "\tContinue\t%s, %d\t; Left to pay = %d\n\n",
+                        ship_name(ship), ship->remaining_cost,
+                        ship->remaining_cost);
 
-            /* Generate DEVELOP commands for ships arriving here because of
-            AUTO command. */
-            for (i = 0; i < species->num_ships; i++) {
-                ship = ship_base + i;
-                if (ship->pn == 99) { continue; }
+                continue;
+            }
 
-                k = ship->special;
-                if (k == 0) { continue; }
-                if (k == 9999) { k = 0; }    /* Home planet. */
+            if (ship->type != STARBASE) { continue; }
 
-                if (nampla != nampla_base + k) { continue; }
+            j = (species->tech_level[MA] / 2) - ship->tonnage;
+            if (j < 1) { continue; }
 
-                k = ship->unloading_point;
-                if (k == 9999) { k = 0; }
-                temp_nampla = nampla_base + k;
+            fprintf(report_file, "\tContinue\tBAS %s, %d\t; Current tonnage = %s\n\n", ship->name, 100 * j,
+                    commas(10000 * (long) ship->tonnage));
+        }
 
-                fprintf(report_file, "\tDevelop\tPL %s, TR%d%s %s\n\n", temp_nampla->name, ship->tonnage,
-                        ship_type[ship->type], ship->name);
+        /* Generate DEVELOP command if this is a colony with an economic base less than 200. */
+        n = nampla->mi_base + nampla->ma_base + nampla->IUs_needed + nampla->AUs_needed;
+        nn = nampla->item_quantity[CU];
+        for (i = 0; i < species->num_ships; i++) {
+            /* Get CUs on transports at planet. */
+            ship = ship_base + i;
+            if (ship->x != nampla->x) { continue; }
+            if (ship->y != nampla->y) { continue; }
+            if (ship->z != nampla->z) { continue; }
+            if (ship->pn != nampla->pn) { continue; }
+            nn += ship->item_quantity[CU];
+        }
+        n += nn;
+        if ((nampla->status & COLONY) && n < 2000L
+            && nampla->pop_units > 0) {
+            if (nampla->pop_units > (2000L - n)) {
+                nn = 2000L - n;
+            } else {
+                nn = nampla->pop_units;
             }
 
-            /* Give orders to continue construction of unfinished ships and starbases. */
-            for (i = 0; i < species->num_ships; i++) {
-                ship = ship_base + i;
-                if (ship->pn == 99) { continue; }
+            fprintf(report_file, "\tDevelop\t%ld\n\n", 2L * nn);
 
-                if (ship->x != nampla->x) { continue; }
-                if (ship->y != nampla->y) { continue; }
-                if (ship->z != nampla->z) { continue; }
-                if (ship->pn != nampla->pn) { continue; }
+            nampla->IUs_needed += nn;
+        }
 
-                if (ship->status == UNDER_CONSTRUCTION) {
-                    fprintf(report_file,
-                            "\tContinue\t%s, %d\t; Left to pay = %d\n\n",
-                            ship_name(ship), ship->remaining_cost,
-                            ship->remaining_cost);
+        /* For home planets and any colonies that have an economic base of
+         * at least 200, check if there are other colonized planets in
+         * the same sector that are not self-sufficient.
+         * If so, DEVELOP them. */
+        if (n >= 2000L || (nampla->status & HOME_PLANET)) {
+            /* Skip home planet. */
+            for (i = 1; i < species->num_namplas; i++) {
+                if (i == nampla_index) { continue; }
 
-                    continue;
-                }
+                temp_nampla = nampla_base + i;
 
-                if (ship->type != STARBASE) { continue; }
+                if (temp_nampla->pn == 99) { continue; }
+                if (temp_nampla->x != nampla->x) { continue; }
+                if (temp_nampla->y != nampla->y) { continue; }
+                if (temp_nampla->z != nampla->z) { continue; }
 
-                j = (species->tech_level[MA] / 2) - ship->tonnage;
-                if (j < 1) { continue; }
+                n = temp_nampla->mi_base + temp_nampla->ma_base + temp_nampla->IUs_needed + temp_nampla->AUs_needed;
 
-                fprintf(report_file, "\tContinue\tBAS %s, %d\t; Current tonnage = %s\n\n", ship->name, 100 * j,
-                        commas(10000 * (long) ship->tonnage));
-            }
+                if (n == 0) { continue; }
 
-            /* Generate DEVELOP command if this is a colony with an economic base less than 200. */
-            n = nampla->mi_base + nampla->ma_base + nampla->IUs_needed + nampla->AUs_needed;
-            nn = nampla->item_quantity[CU];
-            for (i = 0; i < species->num_ships; i++) {
-                /* Get CUs on transports at planet. */
-                ship = ship_base + i;
-                if (ship->x != nampla->x) { continue; }
-                if (ship->y != nampla->y) { continue; }
-                if (ship->z != nampla->z) { continue; }
-                if (ship->pn != nampla->pn) { continue; }
-                nn += ship->item_quantity[CU];
-            }
-            n += nn;
-            if ((nampla->status & COLONY) && n < 2000L
-                && nampla->pop_units > 0) {
-                if (nampla->pop_units > (2000L - n)) {
-                    nn = 2000L - n;
-                } else {
-                    nn = nampla->pop_units;
+                nn = temp_nampla->item_quantity[IU] + temp_nampla->item_quantity[AU];
+                if (nn > temp_nampla->item_quantity[CU]) {
+                    nn = temp_nampla->item_quantity[CU];
                 }
+                n += nn;
+                if (n >= 2000L) { continue; }
+                nn = 2000L - n;
 
-                fprintf(report_file, "\tDevelop\t%ld\n\n", 2L * nn);
+                if (nn > nampla->pop_units) { nn = nampla->pop_units; }
 
-                nampla->IUs_needed += nn;
-            }
+                fprintf(report_file, "\tDevelop\t%ld\tPL %s\n\n", 2L * nn, temp_nampla->name);
 
-            /* For home planets and any colonies that have an economic base of
-             * at least 200, check if there are other colonized planets in
-             * the same sector that are not self-sufficient.
-             * If so, DEVELOP them. */
-            if (n >= 2000L || (nampla->status & HOME_PLANET)) {
-                /* Skip home planet. */
-                for (i = 1; i < species->num_namplas; i++) {
-                    if (i == nampla_index) { continue; }
+                temp_nampla->AUs_needed += nn;
+            }
+        }
+    }
 
-                    temp_nampla = nampla_base + i;
+    fprintf(report_file, "END\n\n");
 
-                    if (temp_nampla->pn == 99) { continue; }
-                    if (temp_nampla->x != nampla->x) { continue; }
-                    if (temp_nampla->y != nampla->y) { continue; }
-                    if (temp_nampla->z != nampla->z) { continue; }
+    fprintf(report_file, "START POST-ARRIVAL\n");
+    fprintf(report_file, "; Place post-arrival orders here.\n\n");
 
-                    n = temp_nampla->mi_base + temp_nampla->ma_base + temp_nampla->IUs_needed + temp_nampla->AUs_needed;
+    if (!species->auto_orders) { goto post_end; }
 
-                    if (n == 0) { continue; }
+    /* Generate an AUTO command. */
+    fprintf(report_file, "\tAuto\n\n");
 
-                    nn = temp_nampla->item_quantity[IU] + temp_nampla->item_quantity[AU];
-                    if (nn > temp_nampla->item_quantity[CU]) {
-                        nn = temp_nampla->item_quantity[CU];
-                    }
-                    n += nn;
-                    if (n >= 2000L) { continue; }
-                    nn = 2000L - n;
+    /* Generate SCAN orders for all TR1s that are jumping to sectors which current species does not inhabit. */
+    for (i = 0; i < species->num_ships; i++) {
+        ship = ship_base + i;
+        if (ship->pn == 99) { continue; }
+        if (ship->status == UNDER_CONSTRUCTION) { continue; }
+        if (ship->class != TR) { continue; }
+        if (ship->tonnage != 1) { continue; }
+        if (ship->type != FTL) { continue; }
 
-                    if (nn > nampla->pop_units) { nn = nampla->pop_units; }
+        found = FALSE;
+        for (j = 0; j < species->num_namplas; j++) {
+            if (ship->dest_x == -1) { break; }
 
-                    fprintf(report_file, "\tDevelop\t%ld\tPL %s\n\n", 2L * nn, temp_nampla->name);
+            nampla = nampla_base + j;
+            if (nampla->pn == 99) { continue; }
+            if (nampla->x != ship->dest_x) { continue; }
+            if (nampla->y != ship->dest_y) { continue; }
+            if (nampla->z != ship->dest_z) { continue; }
 
-                    temp_nampla->AUs_needed += nn;
-                }
+            if (nampla->status & POPULATED) {
+                found = TRUE;
+                break;
             }
         }
+        if (!found) { fprintf(report_file, "\tScan\tTR1 %s\n", ship->name); }
+    }
 
-        fprintf(report_file, "END\n\n");
+    post_end:
+    fprintf(report_file, "END\n\n");
 
-        fprintf(report_file, "START POST-ARRIVAL\n");
-        fprintf(report_file, "; Place post-arrival orders here.\n\n");
+    fprintf(report_file, "START STRIKES\n");
+    fprintf(report_file, "; Place strike orders here.\n\n");
+    fprintf(report_file, "END\n");
 
-        if (!species->auto_orders) { goto post_end; }
+    truncate_name = FALSE;
+    ignore_field_distorters = temp_ignore_field_distorters;
 
-        /* Generate an AUTO command. */
-        fprintf(report_file, "\tAuto\n\n");
+    done_report:
 
-        /* Generate SCAN orders for all TR1s that are jumping to sectors which current species does not inhabit. */
-        for (i = 0; i < species->num_ships; i++) {
-            ship = ship_base + i;
-            if (ship->pn == 99) { continue; }
-            if (ship->status == UNDER_CONSTRUCTION) { continue; }
-            if (ship->class != TR) { continue; }
-            if (ship->tonnage != 1) { continue; }
-            if (ship->type != FTL) { continue; }
+    /* The order section is not part of the structured report. */
+    if (json_report != NULL) {
+        sprintf(filename, "sp%02d.rpt.t%d.json", species_number, turn_number);
+        jsonWriteFile(json_report, "report", filename);
+        cJSON_Delete(json_report);
+        json_report = NULL;
+    }
 
-            found = FALSE;
-            for (j = 0; j < species->num_namplas; j++) {
-                if (ship->dest_x == -1) { break; }
+    /* Clean up for this species. */
+    fclose(report_file);
+    free(ship_already_listed);
+    ship_already_listed = NULL;
+    free(ships_by_location);
+    ships_by_location = NULL;
+}
 
-                nampla = nampla_base + j;
-                if (nampla->pn == 99) { continue; }
-                if (nampla->x != ship->dest_x) { continue; }
-                if (nampla->y != ship->dest_y) { continue; }
-                if (nampla->z != ship->dest_z) { continue; }
 
-                if (nampla->status & POPULATED) {
-                    found = TRUE;
-                    break;
-                }
-            }
-            if (!found) { fprintf(report_file, "\tScan\tTR1 %s\n", ship->name); }
+// writeReports writes the reports for the species in sp_num, up to jobs of them at the same time.
+// Each report reads the data of every species but changes only the data of its own species,
+// so the reports are the same for any number of jobs.
+static void writeReports(int num_species, int *sp_num, int log_species, int jobs) {
+    int i, num_workers;
+    report_pool_t pool;
+    pthread_t *worker;
+
+    if (jobs < 2 || num_species < 2) {
+        for (i = 0; i < num_species; i++) {
+            writeReport(sp_num[i], log_species);
         }
+        return;
+    }
 
-        post_end:
-        fprintf(report_file, "END\n\n");
+    /* The sector and star indexes are built on first use, so build them before the threads share them. */
+    sectorCount();
+    starIndexBuild();
+
+    pool.num_species = num_species;
+    pool.next_species = 0;
+    pool.sp_num = sp_num;
+    pool.log_species = log_species;
+    pool.ignore_field_distorters = ignore_field_distorters;
+
+    num_workers = jobs < num_species ? jobs : num_species;
+    worker = ncalloc(__FUNCTION__, __LINE__, num_workers, sizeof(pthread_t));
+    pthread_mutex_init(&pool.lock, NULL);
+    for (i = 0; i < num_workers; i++) {
+        if (pthread_create(&worker[i], NULL, writeReportsWorker, &pool) != 0) {
+            fprintf(stderr, "\n\tCannot start a thread to write reports!\n\n");
+            exit(-1);
+        }
+    }
+    for (i = 0; i < num_workers; i++) {
+        pthread_join(worker[i], NULL);
+    }
+    pthread_mutex_destroy(&pool.lock);
+    free(worker);
+}
 
-        fprintf(report_file, "START STRIKES\n");
-        fprintf(report_file, "; Place strike orders here.\n\n");
-        fprintf(report_file, "END\n");
 
-        truncate_name = FALSE;
-        ignore_field_distorters = temp_ignore_field_distorters;
+// writeReportsWorker takes species from the pool and writes their reports until there are none left.
+static void *writeReportsWorker(void *arg) {
+    report_pool_t *pool = (report_pool_t *) arg;
+    int index;
 
-        done_report:
+    ignore_field_distorters = pool->ignore_field_distorters;
 
-        /* Clean up for this species. */
-        fclose(report_file);
+    while (TRUE) {
+        pthread_mutex_lock(&pool->lock);
+        index = pool->next_species++;
+        pthread_mutex_unlock(&pool->lock);
+        if (index >= pool->num_species) {
+            break;
+        }
+        writeReport(pool->sp_num[index], pool->log_species);
     }
 
-    /* Clean up and exit. */
-    free_species_data();
-
-    return 0;
+    return NULL;
 }
-
-
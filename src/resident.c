@@ -0,0 +1,325 @@
+// Far Horizons Game Engine
+// Copyright (C) 2022 Michael D Henderson
+// Copyright (C) 2021 Raven Zachary
+// Copyright (C) 2019 Casey Link, Adam Piggott
+// Copyright (C) 1999 Richard A. Morneau
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdlib.h>
+#include <string.h>
+#include "engine.h"
+#include "galaxyio.h"
+#include "locationio.h"
+#include "namplavars.h"
+#include "planetio.h"
+#include "resident.h"
+#include "shipvars.h"
+#include "species.h"
+#include "speciesio.h"
+#include "stario.h"
+#include "transactionio.h"
+
+
+int galaxy_resident = FALSE;
+
+// the last saved version of each data file.
+// modified is set when a phase saved the data and it has not been written to disk yet.
+static struct {
+    int modified;
+    struct galaxy_data galaxy;
+} rGalaxy;
+
+static struct {
+    int modified;
+    int num_stars;
+    struct star_data *base;
+} rStars;
+
+static struct {
+    int modified;
+    int num_planets;
+    struct planet_data *base;
+} rPlanets;
+
+static struct {
+    int modified;
+    int present; // FALSE if the species data file did not exist
+    struct species_data species;
+    struct nampla_data *namplas;
+    struct ship_data *ships;
+} rSpecies[MAX_SPECIES];
+
+static struct {
+    int modified;
+    int num_transactions;
+    struct trans_data *base;
+} rTransactions;
+
+static struct {
+    int modified;
+    int num_locs;
+    struct sp_loc_data *base;
+} rLocations;
+
+
+// residentBegin loads all the data files and keeps them in memory until residentEnd.
+void residentBegin(void) {
+    galaxy_resident = FALSE;
+
+    get_galaxy_data();
+    get_star_data();
+    get_planet_data();
+    get_species_data();
+    get_transaction_data();
+    get_location_data();
+
+    rGalaxy.modified = FALSE;
+    rGalaxy.galaxy = galaxy;
+
+    // the loaded arrays become the saved versions, so pointers between them stay valid
+    rStars.modified = FALSE;
+    rStars.num_stars = num_stars;
+    rStars.base = star_base;
+    star_base = NULL;
+
+    rPlanets.modified = FALSE;
+    rPlanets.num_planets = num_planets;
+    rPlanets.base = planet_base;
+    planet_base = NULL;
+
+    for (int i = 0; i < galaxy.num_species; i++) {
+        rSpecies[i].modified = FALSE;
+        rSpecies[i].present = data_in_memory[i];
+        rSpecies[i].species = spec_data[i];
+        rSpecies[i].namplas = namp_data[i];
+        rSpecies[i].ships = ship_data[i];
+        namp_data[i] = NULL;
+        ship_data[i] = NULL;
+        data_in_memory[i] = FALSE;
+        data_modified[i] = FALSE;
+    }
+
+    rTransactions.modified = FALSE;
+    rTransactions.num_transactions = num_transactions;
+    rTransactions.base = ncalloc(__FUNCTION__, __LINE__, num_transactions + 1, sizeof(struct trans_data));
+    memcpy(rTransactions.base, transaction, num_transactions * sizeof(struct trans_data));
+
+    rLocations.modified = FALSE;
+    rLocations.num_locs = num_locs;
+    rLocations.base = ncalloc(__FUNCTION__, __LINE__, num_locs + 1, sizeof(struct sp_loc_data));
+    memcpy(rLocations.base, loc, num_locs * sizeof(struct sp_loc_data));
+
+    galaxy_resident = TRUE;
+}
+
+
+// residentEnd writes every data file that was saved while the galaxy was resident.
+void residentEnd(void) {
+    galaxy_resident = FALSE;
+
+    if (rGalaxy.modified) {
+        galaxy = rGalaxy.galaxy;
+        save_galaxy_data();
+    }
+    if (rStars.modified) {
+        num_stars = rStars.num_stars;
+        star_base = rStars.base;
+        save_star_data();
+    }
+    if (rPlanets.modified) {
+        num_planets = rPlanets.num_planets;
+        planet_base = rPlanets.base;
+        save_planet_data();
+    }
+    for (int i = 0; i < galaxy.num_species; i++) {
+        spec_data[i] = rSpecies[i].species;
+        namp_data[i] = rSpecies[i].namplas;
+        ship_data[i] = rSpecies[i].ships;
+        data_in_memory[i] = rSpecies[i].present;
+        data_modified[i] = rSpecies[i].modified;
+        rSpecies[i].namplas = NULL;
+        rSpecies[i].ships = NULL;
+    }
+    save_species_data();
+    free_species_data();
+    if (rTransactions.modified) {
+        transactionReplace(rTransactions.base, rTransactions.num_transactions);
+        save_transaction_data();
+    }
+    if (rLocations.modified) {
+        locationReplace(rLocations.base, rLocations.num_locs);
+        save_location_data();
+    }
+}
+
+
+void residentGetGalaxyData(void) {
+    galaxy = rGalaxy.galaxy;
+}
+
+
+void residentSaveGalaxyData(void) {
+    rGalaxy.galaxy = galaxy;
+    rGalaxy.modified = TRUE;
+}
+
+
+void residentGetStarData(void) {
+    num_stars = rStars.num_stars;
+    star_base = (struct star_data *) ncalloc(__FUNCTION__, __LINE__, num_stars + NUM_EXTRA_STARS, sizeof(struct star_data));
+    memcpy(star_base, rStars.base, num_stars * sizeof(struct star_data));
+    for (int i = 0; i < num_stars; i++) {
+        if (star_base[i].wormholeExit != NULL) {
+            star_base[i].wormholeExit = star_base + (rStars.base[i].wormholeExit - rStars.base);
+        }
+    }
+    star_data_modified = FALSE;
+}
+
+
+void residentSaveStarData(void) {
+    if (num_stars != rStars.num_stars) {
+        free(rStars.base);
+        rStars.base = (struct star_data *) ncalloc(__FUNCTION__, __LINE__, num_stars + 1, sizeof(struct star_data));
+        rStars.num_stars = num_stars;
+    }
+    memcpy(rStars.base, star_base, num_stars * sizeof(struct star_data));
+    for (int i = 0; i < num_stars; i++) {
+        if (rStars.base[i].wormholeExit != NULL) {
+            rStars.base[i].wormholeExit = rStars.base + (star_base[i].wormholeExit - star_base);
+        }
+    }
+    rStars.modified = TRUE;
+}
+
+
+void residentGetPlanetData(void) {
+    num_planets = rPlanets.num_planets;
+    planet_base = (struct planet_data *) ncalloc(__FUNCTION__, __LINE__, num_planets + NUM_EXTRA_PLANETS, sizeof(struct planet_data));
+    memcpy(planet_base, rPlanets.base, num_planets * sizeof(struct planet_data));
+
+    // link to the stars the same way get_planet_data does
+    for (int i = 0; i < num_planets; i++) {
+        planet_base[i].star = NULL;
+    }
+    for (int sn = 0; sn < num_stars; sn++) {
+        star_data_t *star = star_base + sn;
+        for (int pn = 0; pn < star->num_planets; pn++) {
+            struct planet_data *p = &planet_base[star->planet_index + pn];
+            p->star = star;
+            p->orbit = pn + 1;
+        }
+    }
+
+    planet_data_modified = FALSE;
+}
+
+
+void residentSavePlanetData(void) {
+    if (num_planets != rPlanets.num_planets) {
+        free(rPlanets.base);
+        rPlanets.base = (struct planet_data *) ncalloc(__FUNCTION__, __LINE__, num_planets + 1, sizeof(struct planet_data));
+        rPlanets.num_planets = num_planets;
+    }
+    memcpy(rPlanets.base, planet_base, num_planets * sizeof(struct planet_data));
+    for (int i = 0; i < num_planets; i++) {
+        rPlanets.base[i].star = NULL;
+    }
+    rPlanets.modified = TRUE;
+}
+
+
+// residentGetSpeciesData expects get_species_data to have already released the previous arrays.
+void residentGetSpeciesData(void) {
+    for (int species_index = 0; species_index < galaxy.num_species; species_index++) {
+        struct species_data *sp = &spec_data[species_index];
+
+        if (!rSpecies[species_index].present) {
+            sp->pn = 0;    /* Extinct! */
+            continue;
+        }
+
+        *sp = rSpecies[species_index].species;
+
+        max_namplas[species_index] = sp->num_namplas + 1;
+        namp_data[species_index] = (struct nampla_data *) ncalloc(__FUNCTION__, __LINE__, max_namplas[species_index], sizeof(struct nampla_data));
+        memcpy(namp_data[species_index], rSpecies[species_index].namplas, sp->num_namplas * sizeof(struct nampla_data));
+        for (int i = 0; i < sp->num_namplas; i++) {
+            struct nampla_data *np = &namp_data[species_index][i];
+            np->planet = planet_base + np->planet_index;
+            np->star = np->planet->star;
+        }
+
+        max_ships[species_index] = sp->num_ships + 1;
+        ship_data[species_index] = (struct ship_data *) ncalloc(__FUNCTION__, __LINE__, max_ships[species_index], sizeof(struct ship_data));
+        memcpy(ship_data[species_index], rSpecies[species_index].ships, sp->num_ships * sizeof(struct ship_data));
+
+        data_in_memory[species_index] = TRUE;
+
+        sp->home.nampla = &namp_data[species_index][0];
+        sp->home.planet = sp->home.nampla->planet;
+        sp->home.star = sp->home.nampla->star;
+    }
+}
+
+
+void residentSaveSpeciesData(void) {
+    for (int species_index = 0; species_index < galaxy.num_species; species_index++) {
+        if (data_in_memory[species_index] == FALSE || data_modified[species_index] == FALSE) {
+            continue;
+        }
+        struct species_data *sp = &spec_data[species_index];
+
+        free(rSpecies[species_index].namplas);
+        free(rSpecies[species_index].ships);
+        rSpecies[species_index].namplas = (struct nampla_data *) ncalloc(__FUNCTION__, __LINE__, sp->num_namplas + 1, sizeof(struct nampla_data));
+        memcpy(rSpecies[species_index].namplas, namp_data[species_index], sp->num_namplas * sizeof(struct nampla_data));
+        rSpecies[species_index].ships = (struct ship_data *) ncalloc(__FUNCTION__, __LINE__, sp->num_ships + 1, sizeof(struct ship_data));
+        memcpy(rSpecies[species_index].ships, ship_data[species_index], sp->num_ships * sizeof(struct ship_data));
+        rSpecies[species_index].species = *sp;
+        rSpecies[species_index].present = TRUE;
+        rSpecies[species_index].modified = TRUE;
+
+        data_modified[species_index] = FALSE;
+    }
+}
+
+
+void residentGetTransactionData(void) {
+    transactionReplace(rTransactions.base, rTransactions.num_transactions);
+}
+
+
+void residentSaveTransactionData(void) {
+    free(rTransactions.base);
+    rTransactions.num_transactions = num_transactions;
+    rTransactions.base = ncalloc(__FUNCTION__, __LINE__, num_transactions + 1, sizeof(struct trans_data));
+    memcpy(rTransactions.base, transaction, num_transactions * sizeof(struct trans_data));
+    rTransactions.modified = TRUE;
+}
+
+
+void residentGetLocationData(void) {
+    locationReplace(rLocations.base, rLocations.num_locs);
+}
+
+
+void residentSaveLocationData(void) {
+    free(rLocations.base);
+    rLocations.num_locs = num_locs;
+    rLocations.base = ncalloc(__FUNCTION__, __LINE__, num_locs + 1, sizeof(struct sp_loc_data));
+    memcpy(rLocations.base, loc, num_locs * sizeof(struct sp_loc_data));
+    rLocations.modified = TRUE;
+}
@@ -0,0 +1,57 @@
+// Far Horizons Game Engine
+// Copyright (C) 2022 Michael D Henderson
+// Copyright (C) 2021 Raven Zachary
+// Copyright (C) 2019 Casey Link, Adam Piggott
+// Copyright (C) 1999 Richard A. Morneau
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef FAR_HORIZONS_RESIDENT_H
+#define FAR_HORIZONS_RESIDENT_H
+
+// While the galaxy is resident, the get_xxx_data and save_xxx_data routines
+// do not touch the disk. Loads copy from the last saved version in memory and
+// saves replace that version. Anything saved is written out by residentEnd.
+
+extern int galaxy_resident;
+
+void residentBegin(void);
+
+void residentEnd(void);
+
+void residentGetGalaxyData(void);
+
+void residentSaveGalaxyData(void);
+
+void residentGetStarData(void);
+
+void residentSaveStarData(void);
+
+void residentGetPlanetData(void);
+
+void residentSavePlanetData(void);
+
+void residentGetSpeciesData(void);
+
+void residentSaveSpeciesData(void);
+
+void residentGetTransactionData(void);
+
+void residentSaveTransactionData(void);
+
+void residentGetLocationData(void);
+
+void residentSaveLocationData(void);
+
+#endif //FAR_HORIZONS_RESIDENT_H
@@ -0,0 +1,152 @@
+// Far Horizons Game Engine
+// Copyright (C) 2022 Michael D Henderson
+// Copyright (C) 2021 Raven Zachary
+// Copyright (C) 2019 Casey Link, Adam Piggott
+// Copyright (C) 1999 Richard A. Morneau
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdio.h>
+#include <string.h>
+#include "arena.h"
+#include "engine.h"
+#include "combat.h"
+#include "datafile.h"
+#include "commandvars.h"
+#include "enginevars.h"
+#include "finish.h"
+#include "jump.h"
+#include "location.h"
+#include "locationio.h"
+#include "logvars.h"
+#include "nameindex.h"
+#include "planetio.h"
+#include "postarrival.h"
+#include "predeparture.h"
+#include "prng.h"
+#include "production.h"
+#include "productionvars.h"
+#include "report.h"
+#include "resident.h"
+#include "runturn.h"
+#include "sector.h"
+#include "shipvars.h"
+#include "starindex.h"
+#include "stario.h"
+#include "transactionio.h"
+
+
+typedef struct {
+    int (*command)(int argc, char *argv[]);
+    int argc;
+    char *argv[2];
+} run_turn_phase_t;
+
+// the phases of a normal turn, in the order given in doc/gm_sequence.
+static run_turn_phase_t phases[] = {
+        {locationCommand,     1, {"locations",     NULL}},
+        {combatCommand,       1, {"combat",        NULL}},
+        {preDepartureCommand, 1, {"pre-departure", NULL}},
+        {jumpCommand,         1, {"jump",          NULL}},
+        {productionCommand,   1, {"production",    NULL}},
+        {postArrivalCommand,  1, {"post-arrival",  NULL}},
+        {locationCommand,     1, {"locations",     NULL}},
+        {combatCommand,       2, {"combat",        "--strike"}},
+        {finishCommand,       1, {"finish",        NULL}},
+        {reportCommand,       1, {"report",        NULL}},
+        {NULL,                0, {NULL,            NULL}},
+};
+
+
+// runTurnStartPhase puts the globals back to the state a new process would see,
+// so that every phase behaves exactly as it does when run as a separate command.
+static void runTurnStartPhase(void) {
+    // phases free their own copies of the data; just forget the pointers
+    num_stars = 0;
+    star_base = NULL;
+    star_data_modified = FALSE;
+    num_planets = 0;
+    planet_base = NULL;
+    planet_data_modified = FALSE;
+    transactionReset();
+    locationReset();
+    sectorReset();
+    starIndexReset();
+    nameIndexReset();
+
+    // scratch memory from the previous phase is no longer referenced
+    arenaReset();
+
+    correct_spelling_required = FALSE;
+    post_arrival_phase = FALSE;
+    prompt_gm = FALSE;
+
+    end_of_file = FALSE;
+    just_opened_file = FALSE;
+
+    header_printed = FALSE;
+    log_file = NULL;
+    log_stdout = TRUE;
+    log_summary = FALSE;
+    log_to_file = TRUE;
+    logging_disabled = FALSE;
+    summary_file = NULL;
+
+    doing_production = FALSE;
+    last_planet_produced = FALSE;
+    ignore_field_distorters = FALSE;
+    truncate_name = FALSE;
+
+    map_data_in_place = FALSE;
+
+    // every process starts from the seed in the environment
+    prngSetSeed(0);
+}
+
+
+// runTurnCommand runs all the phases of a turn in a single process.
+// The data files are loaded once, kept in memory between phases, and written once at the end.
+int runTurnCommand(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "-?") == 0) {
+            fprintf(stderr, "usage: run-turn\n");
+            fprintf(stderr, "       runs locations, combat, pre-departure, jump, production, post-arrival,\n");
+            fprintf(stderr, "       locations, combat --strike, finish, and report without reloading the\n");
+            fprintf(stderr, "       data files between phases.\n");
+            return 2;
+        } else {
+            fprintf(stderr, "error: unknown option '%s'\n", argv[i]);
+            return 2;
+        }
+    }
+
+    residentBegin();
+
+    for (run_turn_phase_t *phase = phases; phase->command != NULL; phase++) {
+        if (verbose_mode) {
+            printf(" info: run-turn: %s %s\n", phase->argv[0], phase->argc > 1 ? phase->argv[1] : "");
+        }
+        runTurnStartPhase();
+        int result = phase->command(phase->argc, phase->argv);
+        if (result != 0) {
+            // the data files are untouched, but the species logs may already hold some results
+            fprintf(stderr, "error: run-turn: %s failed\n", phase->argv[0]);
+            return result;
+        }
+    }
+
+    residentEnd();
+
+    return 0;
+}
@@ -21,6 +21,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include "arena.h"
+#include "datafile.h"
 #include "galaxy.h"
 #include "galaxyio.h"
 #include "logvars.h"
@@ -30,14 +32,10 @@
 #include "speciesio.h"
 #include "speciesvars.h"
 #include "stario.h"
+#include "starindex.h"
 #include "scan.h"
 
 
-typedef struct {
-    star_data_t *star;
-    double distance;
-} scan_system_t;
-
 // scanCommand performs a scan on a system for a species.
 // It is for use by the game master only.
 int scanCommand(int argc, char *argv[]) {
@@ -52,6 +50,7 @@ int scanCommand(int argc, char *argv[]) {
     int y = atoi(argv[3]);
     int z = atoi(argv[4]);
 
+    map_data_in_place = TRUE;
     printf("fh: %s: loading   galaxy   data...\n", cmdName);
     get_galaxy_data();
     if (spno < 1 || spno > galaxy.num_species) {
@@ -135,6 +134,7 @@ int scanNearCommand(int argc, char *argv[]) {
     // external globals?
     ignore_field_distorters = TRUE;
     log_file = stdout;
+    map_data_in_place = TRUE;
 
     //printf("fh: %s: loading   galaxy   data...\n", cmdName);
     get_galaxy_data();
@@ -169,7 +169,7 @@ int scanNearCommand(int argc, char *argv[]) {
              * We will use this to prevent multiple listings of a ship. */
             for (int ship_index = 0; ship_index < species->num_ships; ship_index++) {
                 ship_data_t *sd = ship_data[spidx] + ship_index;
-                sd[ship_index].dest_x = 0;
+                sd->dest_x = 0;
             }
 
             /* Check all namplas for this species. */
@@ -270,60 +270,38 @@ int scanNearCommand(int argc, char *argv[]) {
     }
 
     printf("Systems within %d parsecs of %d %d %d:\n", radius, x, y, z);
-    scan_system_t **ss = ncalloc(__FUNCTION__, __LINE__, num_stars, sizeof(scan_system_t *));
-    if (ss == NULL) {
-        perror("scan_system_t *");
-        return 2;
-    }
-    for (int i = 0; i < num_stars; i++) {
-        ss[i] = ncalloc(__FUNCTION__, __LINE__, 1, sizeof(scan_system_t));
-        if (ss[i] == NULL) {
-            perror("scan_system_t");
-            return 2;
+    // nearest first; a whole number of parsecs squared is below radius^2 only if it is at most radius^2 - 1
+    int *near = arenaAlloc(__FUNCTION__, __LINE__, num_stars + 1, sizeof(int));
+    int num_near = starsWithin(x, y, z, radius * radius - 1, NULL, 0, near);
+    for (int i = 0; i < num_near; i++) {
+        star_data_t *star = star_base + near[i];
+        int delta_x = x - star->x;
+        int delta_y = y - star->y;
+        int delta_z = z - star->z;
+        double distance = sqrt((double) ((delta_x * delta_x) + (delta_y * delta_y) + (delta_z * delta_z)));
+        printf("System  x = %3d  y = %3d  z = %3d  %c%c%c %8.2f parsecs\n",
+               star->x, star->y, star->z,
+               type_char[star->type], color_char[star->color], size_char[star->size],
+               distance);
+        if (star->worm_here) {
+            printf("\t*** terminus of a natural wormhole.\n");
         }
-        ss[i]->star = star_base + i;
-        int delta_x = x - ss[i]->star->x;
-        int delta_y = y - ss[i]->star->y;
-        int delta_z = z - ss[i]->star->z;
-        ss[i]->distance = sqrt((double) ((delta_x * delta_x) + (delta_y * delta_y) + (delta_z * delta_z)));
-    }
-    // bubbly and proud
-    for (int i = 0; i < num_stars; i++) {
-        for (int j = i + 1; j < num_stars; j++) {
-            if (ss[i]->distance > ss[j]->distance) {
-                scan_system_t *tmp = ss[i];
-                ss[i] = ss[j];
-                ss[j] = tmp;
-            }
+        if (star->num_planets == 0) {
+            printf("\t*** nova remnant, no planets.\n\n");
+            continue;
         }
-    }
-    for (int i = 0; i < num_stars; i++) {
-        if (ss[i]->distance < (double) radius) {
-            star_data_t *star = ss[i]->star;
-            printf("System  x = %3d  y = %3d  z = %3d  %c%c%c %8.2f parsecs\n",
-                   star->x, star->y, star->z,
-                   type_char[star->type], color_char[star->color], size_char[star->size],
-                   ss[i]->distance);
-            if (star->worm_here) {
-                printf("\t*** terminus of a natural wormhole.\n");
-            }
-            if (star->num_planets == 0) {
-                printf("\t*** nova remnant, no planets.\n\n");
-                continue;
-            }
-            printf("\t#  Dia  Grav  TempClass  PressClass  MiningDiff\n");
-            printf("\t-----------------------------------------------\n");
-            for (int pn = 0; pn < star->num_planets; pn++) {
-                planet_data_t *planet = planet_base + star->planet_index + pn - 1;
-                int orbit = pn + 1;
-                printf("\t%d  %3d  %d.%02d  %9d  %10d  %7d.%02d\n",
-                       orbit,
-                       planet->diameter,
-                       planet->gravity / 100, planet->gravity % 100,
-                       planet->temperature_class,
-                       planet->pressure_class,
-                       planet->mining_difficulty / 100, planet->mining_difficulty % 100);
-            }
+        printf("\t#  Dia  Grav  TempClass  PressClass  MiningDiff\n");
+        printf("\t-----------------------------------------------\n");
+        for (int pn = 0; pn < star->num_planets; pn++) {
+            planet_data_t *planet = planet_base + star->planet_index + pn - 1;
+            int orbit = pn + 1;
+            printf("\t%d  %3d  %d.%02d  %9d  %10d  %7d.%02d\n",
+                   orbit,
+                   planet->diameter,
+                   planet->gravity / 100, planet->gravity % 100,
+                   planet->temperature_class,
+                   planet->pressure_class,
+                   planet->mining_difficulty / 100, planet->mining_difficulty % 100);
         }
     }
 
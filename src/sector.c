@@ -0,0 +1,243 @@
+// Far Horizons Game Engine
+// Copyright (C) 2022 Michael D Henderson
+// Copyright (C) 2021 Raven Zachary
+// Copyright (C) 2019 Casey Link, Adam Piggott
+// Copyright (C) 1999 Richard A. Morneau
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdlib.h>
+#include <string.h>
+#include "engine.h"
+#include "galaxyio.h"
+#include "namplavars.h"
+#include "sector.h"
+#include "shipvars.h"
+#include "speciesio.h"
+#include "stario.h"
+
+
+// the sectors, in the order they were first seen, and a hash table from packed coordinates to sector
+static struct {
+    int built;
+    int num_sectors;
+    int max_sectors;
+    sector_t *sector;
+    int table_size;  // always a power of two
+    int *table;      // index of the sector plus one, or zero if the slot is empty
+} sectors;
+
+
+static void sectorAddUnit(sector_unit_t **list, int *count, int *max, int species_index, int index);
+
+static void sectorBuild(void);
+
+static sector_t *sectorFind(int x, int y, int z, int create);
+
+static void sectorGrowTable(void);
+
+static unsigned sectorSlot(int x, int y, int z, int size);
+
+
+// sectorAt returns the sector at the coordinates, or NULL if there is nothing there.
+sector_t *sectorAt(int x, int y, int z) {
+    if (!sectors.built) {
+        sectorBuild();
+    }
+    return sectorFind(x, y, z, FALSE);
+}
+
+
+// sectorByIndex returns a sector by its position in the index, for callers that need to visit every sector.
+sector_t *sectorByIndex(int index) {
+    if (!sectors.built) {
+        sectorBuild();
+    }
+    return &sectors.sector[index];
+}
+
+
+// sectorCount returns the number of sectors in the index.
+int sectorCount(void) {
+    if (!sectors.built) {
+        sectorBuild();
+    }
+    return sectors.num_sectors;
+}
+
+
+// sectorPlaceNampla adds a colony to the sector at its current coordinates.
+// It must be called whenever a colony is created or its coordinates change.
+void sectorPlaceNampla(int species_index, int nampla_index) {
+    if (!sectors.built) {
+        return;  // the colony will be found when the index is built
+    }
+    struct nampla_data *nampla = namp_data[species_index] + nampla_index;
+    sector_t *sector = sectorFind(nampla->x, nampla->y, nampla->z, TRUE);
+    sectorAddUnit(&sector->nampla, &sector->num_namplas, &sector->max_namplas, species_index, nampla_index);
+}
+
+
+// sectorPlaceShip adds a ship to the sector at its current coordinates.
+// It must be called whenever a ship is created or moves.
+void sectorPlaceShip(int species_index, int ship_index) {
+    if (!sectors.built) {
+        return;  // the ship will be found when the index is built
+    }
+    struct ship_data *ship = ship_data[species_index] + ship_index;
+    sector_t *sector = sectorFind(ship->x, ship->y, ship->z, TRUE);
+    sectorAddUnit(&sector->ship, &sector->num_ships, &sector->max_ships, species_index, ship_index);
+}
+
+
+// sectorReset throws the index away. It is rebuilt from the data in memory when it is next used.
+void sectorReset(void) {
+    for (int i = 0; i < sectors.num_sectors; i++) {
+        free(sectors.sector[i].nampla);
+        free(sectors.sector[i].ship);
+    }
+    free(sectors.sector);
+    free(sectors.table);
+    memset(&sectors, 0, sizeof(sectors));
+}
+
+
+// sectorAddUnit inserts the unit into the list, keeping the list sorted by species and index.
+// Units are usually added in order, so the search starts at the end of the list.
+static void sectorAddUnit(sector_unit_t **list, int *count, int *max, int species_index, int index) {
+    int i = *count;
+    while (i > 0) {
+        sector_unit_t *prev = &(*list)[i - 1];
+        if (prev->species_index < species_index || (prev->species_index == species_index && prev->index < index)) {
+            break;
+        } else if (prev->species_index == species_index && prev->index == index) {
+            return;  // already here
+        }
+        i--;
+    }
+    if (*count == *max) {
+        int size = *max == 0 ? 4 : 2 * *max;
+        sector_unit_t *units = (sector_unit_t *) ncalloc(__FUNCTION__, __LINE__, size, sizeof(sector_unit_t));
+        if (*count > 0) {
+            memcpy(units, *list, *count * sizeof(sector_unit_t));
+        }
+        free(*list);
+        *list = units;
+        *max = size;
+    }
+    memmove(&(*list)[i + 1], &(*list)[i], (*count - i) * sizeof(sector_unit_t));
+    (*list)[i].species_index = species_index;
+    (*list)[i].index = index;
+    (*count)++;
+}
+
+
+// sectorBuild indexes every star and every colony and ship of the species in memory.
+static void sectorBuild(void) {
+    sectors.built = TRUE;
+    for (int i = 0; i < num_stars; i++) {
+        struct star_data *star = star_base + i;
+        sector_t *sector = sectorFind(star->x, star->y, star->z, TRUE);
+        if (sector->star_index < 0) {
+            sector->star_index = i;
+        }
+    }
+    for (int species_index = 0; species_index < galaxy.num_species; species_index++) {
+        if (!data_in_memory[species_index]) {
+            continue;
+        }
+        for (int i = 0; i < spec_data[species_index].num_namplas; i++) {
+            if (namp_data[species_index][i].pn != 99) {
+                sectorPlaceNampla(species_index, i);
+            }
+        }
+        for (int i = 0; i < spec_data[species_index].num_ships; i++) {
+            if (ship_data[species_index][i].pn != 99) {
+                sectorPlaceShip(species_index, i);
+            }
+        }
+    }
+}
+
+
+// sectorFind returns the sector at the coordinates.
+// If there is no sector there, it returns NULL or, if create is set, adds an empty sector.
+static sector_t *sectorFind(int x, int y, int z, int create) {
+    if (sectors.table_size == 0) {
+        if (!create) {
+            return NULL;
+        }
+        sectorGrowTable();
+    }
+    unsigned slot = sectorSlot(x, y, z, sectors.table_size);
+    while (sectors.table[slot] != 0) {
+        sector_t *sector = &sectors.sector[sectors.table[slot] - 1];
+        if (sector->x == x && sector->y == y && sector->z == z) {
+            return sector;
+        }
+        slot = (slot + 1) & (sectors.table_size - 1);
+    }
+    if (!create) {
+        return NULL;
+    }
+
+    if (sectors.num_sectors == sectors.max_sectors) {
+        int size = sectors.max_sectors == 0 ? 256 : 2 * sectors.max_sectors;
+        sector_t *sector = (sector_t *) ncalloc(__FUNCTION__, __LINE__, size, sizeof(sector_t));
+        if (sectors.num_sectors > 0) {
+            memcpy(sector, sectors.sector, sectors.num_sectors * sizeof(sector_t));
+        }
+        free(sectors.sector);
+        sectors.sector = sector;
+        sectors.max_sectors = size;
+    }
+    sector_t *sector = &sectors.sector[sectors.num_sectors];
+    sector->x = x;
+    sector->y = y;
+    sector->z = z;
+    sector->star_index = -1;
+    sectors.num_sectors++;
+    sectors.table[slot] = sectors.num_sectors;
+
+    // keep the table at most half full
+    if (2 * sectors.num_sectors > sectors.table_size) {
+        sectorGrowTable();
+    }
+    return sector;
+}
+
+
+// sectorGrowTable doubles the size of the hash table and re-inserts every sector.
+static void sectorGrowTable(void) {
+    int size = sectors.table_size == 0 ? 1024 : 2 * sectors.table_size;
+    free(sectors.table);
+    sectors.table = (int *) ncalloc(__FUNCTION__, __LINE__, size, sizeof(int));
+    sectors.table_size = size;
+    for (int i = 0; i < sectors.num_sectors; i++) {
+        sector_t *sector = &sectors.sector[i];
+        unsigned slot = sectorSlot(sector->x, sector->y, sector->z, size);
+        while (sectors.table[slot] != 0) {
+            slot = (slot + 1) & (size - 1);
+        }
+        sectors.table[slot] = i + 1;
+    }
+}
+
+
+// sectorSlot packs the coordinates into a key and hashes it to a slot in a table of the given size.
+static unsigned sectorSlot(int x, int y, int z, int size) {
+    unsigned key = ((unsigned) (x & 0xff) << 16) | ((unsigned) (y & 0xff) << 8) | (unsigned) (z & 0xff);
+    unsigned hash = key * 2654435761u;
+    return (hash ^ (hash >> 15)) & (unsigned) (size - 1);
+}
@@ -0,0 +1,62 @@
+// Far Horizons Game Engine
+// Copyright (C) 2022 Michael D Henderson
+// Copyright (C) 2021 Raven Zachary
+// Copyright (C) 2019 Casey Link, Adam Piggott
+// Copyright (C) 1999 Richard A. Morneau
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef FAR_HORIZONS_SECTOR_H
+#define FAR_HORIZONS_SECTOR_H
+
+// The sector index maps x-y-z coordinates to the star and to the colonies and ships of every
+// species at those coordinates. It is built from the data in memory the first time it is
+// used and is thrown away whenever the species or star data are loaded or freed.
+//
+// Colonies and ships are listed in species order and, within a species, in the order of the
+// species' arrays, so walking a sector visits units in the same order as scanning the arrays.
+// A unit that leaves a sector is not removed from it, so callers must still check that the
+// unit's coordinates match the sector's before using it.
+
+// a colony or ship in a sector
+typedef struct {
+    int species_index;
+    int index;  // index of the colony or ship in the species' array
+} sector_unit_t;
+
+typedef struct {
+    int x, y, z;
+    int star_index;  // index of the star in star_base, or -1 if there is no star here
+    int num_namplas;
+    int max_namplas;
+    sector_unit_t *nampla;
+    int num_ships;
+    int max_ships;
+    sector_unit_t *ship;
+} sector_t;
+
+sector_t *sectorAt(int x, int y, int z);
+
+sector_t *sectorByIndex(int index);
+
+int sectorCount(void);
+
+void sectorPlaceNampla(int species_index, int nampla_index);
+
+void sectorPlaceShip(int species_index, int ship_index);
+
+void sectorReset(void);
+
+#endif //FAR_HORIZONS_SECTOR_H
@@ -72,6 +72,29 @@ int disbanded_ship(struct ship_data *ship) {
 }
 
 
+// mishapChance returns the chance, in hundredths of a percent, that a jump of the given
+// squared distance goes wrong. The chance grows with the distance, shrinks with the
+// gravitics tech level and then grows by 2% of the chance of success for each year of age.
+long mishapChance(long distance_squared, int gv, int age) {
+    if (gv <= 0) {
+        return 10000L;
+    }
+    long mishap_chance = 100L * distance_squared / (long) gv;
+    if (mishap_chance >= 10000L) {
+        return 10000L;
+    }
+    if (age > 0) {
+        long success_chance = 10000L - mishap_chance;
+        success_chance -= (2L * (long) age * success_chance) / 100L;
+        if (success_chance < 0) {
+            success_chance = 0;
+        }
+        mishap_chance = 10000L - success_chance;
+    }
+    return mishap_chance;
+}
+
+
 long power(short tonnage) {
     long result;
     short t1, t2;
@@ -92,14 +115,10 @@ long power(short tonnage) {
 
 
 void printMishapChanceToOrders(struct ship_data *ship, int destx, int desty, int destz) {
-    int mishap_GV;
-    int mishap_age;
     long stx;
     long sty;
     long stz;
     long mishap_chance;
-    long success_chance;
-    long temp_distance;
 
     if (destx == -1) {
         fprintf(orders_file, "Mishap chance = ???");
@@ -109,25 +128,10 @@ void printMishapChanceToOrders(struct ship_data *ship, int destx, int desty, int
     stx = destx;
     sty = desty;
     stz = destz;
-    temp_distance = ((stx - ship->x) * (stx - ship->x))
-                    + ((sty - ship->y) * (sty - ship->y))
-                    + ((stz - ship->z) * (stz - ship->z));
-
-    mishap_age = ship->age;
-    mishap_GV = species->tech_level[GV];
-    if (mishap_GV > 0) {
-        mishap_chance = 100 * temp_distance / mishap_GV;
-    } else {
-        mishap_chance = 10000;
-    }
-    if (mishap_age > 0 && mishap_chance < 10000) {
-        success_chance = 10000L - mishap_chance;
-        success_chance -= (2L * (long) mishap_age * success_chance) / 100L;
-        mishap_chance = 10000L - success_chance;
-    }
-    if (mishap_chance > 10000) {
-        mishap_chance = 10000;
-    }
+    mishap_chance = mishapChance(((stx - ship->x) * (stx - ship->x))
+                                 + ((sty - ship->y) * (sty - ship->y))
+                                 + ((stz - ship->z) * (stz - ship->z)),
+                                 species->tech_level[GV], ship->age);
     fprintf(orders_file, "mishap chance = %ld.%02ld%%", mishap_chance / 100L, mishap_chance % 100L);
 }
 
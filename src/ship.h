@@ -22,10 +22,6 @@
 
 #include "engine.h"
 
-// Additional memory must be allocated for routines that build ships.
-// This is the default 'extras', which may be changed, if necessary, by the main program.
-#define NUM_EXTRA_SHIPS 100
-
 /* Ship classes. */
 #define    PB                  0    /* Picketboat. */
 #define    CT                  1    /* Corvette. */
@@ -65,6 +61,8 @@ void delete_ship(struct ship_data *ship);
 
 int disbanded_ship(struct ship_data *ship);
 
+long mishapChance(long distance_squared, int gv, int age);
+
 long power(short tonnage);
 
 void printMishapChanceToOrders(struct ship_data *ship, int destx, int desty, int destz);
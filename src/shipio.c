@@ -21,6 +21,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include "arena.h"
 #include "data.h"
 #include "ship.h"
 #include "shipio.h"
@@ -31,7 +32,7 @@
 /* load ship data from file and create empty slots for future use */
 struct ship_data *get_ship_data(int numShips, int extraShips, FILE *fp) {
     /* Allocate enough memory for all ships. */
-    binary_ship_data_t *binData = (binary_ship_data_t *) ncalloc(__FUNCTION__, __LINE__, numShips + extraShips,
+    binary_ship_data_t *binData = (binary_ship_data_t *) arenaAlloc(__FUNCTION__, __LINE__, numShips + extraShips,
                                                                  sizeof(binary_ship_data_t));
     if (binData == NULL) {
         perror("get_ship_data");
@@ -76,7 +77,6 @@ struct ship_data *get_ship_data(int numShips, int extraShips, FILE *fp) {
         s->special = sd->special;
     }
     /* release the binary data memory we allocated */
-    free(binData);
 
     return shipData;
 }
@@ -84,7 +84,7 @@ struct ship_data *get_ship_data(int numShips, int extraShips, FILE *fp) {
 
 void save_ship_data(struct ship_data *shipData, int numShips, FILE *fp) {
     /* Allocate enough memory for all ships. */
-    binary_ship_data_t *binData = (binary_ship_data_t *) ncalloc(__FUNCTION__, __LINE__,
+    binary_ship_data_t *binData = (binary_ship_data_t *) arenaAlloc(__FUNCTION__, __LINE__,
                                                                  numShips, sizeof(binary_ship_data_t));
     if (binData == NULL) {
         perror("save_ship_data");
@@ -127,7 +127,6 @@ void save_ship_data(struct ship_data *shipData, int numShips, FILE *fp) {
         exit(-1);
     }
     /* release the binary data memory we allocated */
-    free(binData);
 }
 
 
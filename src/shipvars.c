@@ -19,9 +19,9 @@
 
 #include "shipvars.h"
 
-char full_ship_id[64];
+THREAD_LOCAL char full_ship_id[64];
 
-int ignore_field_distorters = FALSE;
+THREAD_LOCAL int ignore_field_distorters = FALSE;
 
 struct ship_data *ship;
 
@@ -31,7 +31,7 @@ char ship_abbr[NUM_SHIP_CLASSES][4] = {
         "BW", "BR", "BA", "TR"
 };
 
-struct ship_data *ship_base;
+THREAD_LOCAL struct ship_data *ship_base;
 
 struct ship_data *ship_data[MAX_SPECIES];
 
@@ -53,11 +53,10 @@ short ship_tonnage[NUM_SHIP_CLASSES] = {
 
 char ship_type[3][2] = {"", "S", "S"};
 
-int truncate_name = FALSE;
+THREAD_LOCAL int truncate_name = FALSE;
 
 
-// Additional memory must be allocated for routines that build ships.
-// This is the default 'extras', which may be changed, if necessary.
-int extra_ships = NUM_EXTRA_SHIPS;
-int num_new_ships[MAX_SPECIES];
+// The ship array of each species has room for max_ships ships.
+// It grows when a species builds or is given more ships than it has room for.
+int max_ships[MAX_SPECIES];
 
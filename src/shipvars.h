@@ -25,18 +25,17 @@
 
 // globals. ugh.
 
-extern int extra_ships;
-extern char full_ship_id[64];
-extern int ignore_field_distorters;
-extern int num_new_ships[MAX_SPECIES];
+extern THREAD_LOCAL char full_ship_id[64];
+extern THREAD_LOCAL int ignore_field_distorters;
+extern int max_ships[MAX_SPECIES];
 extern struct ship_data *ship;
 extern char ship_abbr[NUM_SHIP_CLASSES][4];
 extern short ship_cost[NUM_SHIP_CLASSES];
-extern struct ship_data *ship_base;
+extern THREAD_LOCAL struct ship_data *ship_base;
 extern struct ship_data *ship_data[MAX_SPECIES];
 extern int ship_index;
 extern short ship_tonnage[NUM_SHIP_CLASSES];
 extern char ship_type[3][2];
-extern int truncate_name;
+extern THREAD_LOCAL int truncate_name;
 
 #endif //FAR_HORIZONS_SHIPVARS_H
@@ -21,6 +21,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include "datafile.h"
 #include "galaxyio.h"
 #include "planetio.h"
 #include "show.h"
@@ -42,6 +43,8 @@ static int star_here[MAX_DIAMETER][MAX_DIAMETER];
 int showCommand(int argc, char *argv[]) {
     const char *sep = "";
 
+    map_data_in_place = TRUE;
+
     for (int i = 1; i < argc; i++) {
         char *opt = argv[i];
         char *val = NULL;
@@ -119,6 +122,7 @@ int showCommand(int argc, char *argv[]) {
 
 
 int showGalaxyCommand(int argc, char *argv[]) {
+    map_data_in_place = TRUE;
     for (int i = 1; i < argc; i++) {
         char *opt = argv[i];
         char *val = NULL;
@@ -402,6 +406,7 @@ int showHelp(void) {
     printf("  opt: --help          show this helpful text and exit\n");
     printf("       -t | --test     enable test mode\n");
     printf("       -v | --verbose  enable verbose mode\n");
+    printf("       --alloc-stats   print the memory allocated by each call site on exit\n");
     printf("  cmd: turn            display the current turn number\n");
     printf("       locations       create locations data file and update\n");
     printf("                       economic efficiency in planets data file\n");
@@ -414,9 +419,10 @@ int showHelp(void) {
     printf("       post-arrival    run post-arrival commands\n");
     printf("       finish          run end of turn logic\n");
     printf("       report          create end of turn reports\n");
+    printf("       run-turn        run all of the above phases without reloading data\n");
     printf("       stats           display statistics\n");
     printf("       create          create a new galaxy, home system templates\n");
-    printf("       convert         convert between binary and json formats\n");
+    printf("       convert         rewrite binary .dat files in format v1 or v2\n");
     printf("       export          convert binary .dat to json or s-expression\n");
     //printf("           args:  (json | sexpr) galaxy | stars | planets | species | locations | transactions\n");
     printf("       logrnd          display a list of random values for testing the PRNG\n");
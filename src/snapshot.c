@@ -0,0 +1,218 @@
+// Far Horizons Game Engine
+// Copyright (C) 2022 Michael D Henderson
+// Copyright (C) 2021 Raven Zachary
+// Copyright (C) 2019 Casey Link, Adam Piggott
+// Copyright (C) 1999 Richard A. Morneau
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "engine.h"
+#include "galaxyio.h"
+#include "logsink.h"
+#include "nameindex.h"
+#include "namplavars.h"
+#include "planetio.h"
+#include "prng.h"
+#include "sector.h"
+#include "shipvars.h"
+#include "snapshot.h"
+#include "speciesio.h"
+#include "stario.h"
+#include "transactionio.h"
+
+
+// Nothing in the engine reports its writes, so the snapshot copies the arrays
+// when it is taken. Restoring copies them back into the same buffers, which
+// keeps every pointer into them valid.
+typedef struct {
+    int taken;
+    uint64_t seed;
+    struct galaxy_data galaxy;
+    int num_stars;
+    struct star_data *stars;
+    int star_data_modified;
+    int num_planets;
+    struct planet_data *planets;
+    int planet_data_modified;
+    int data_in_memory[MAX_SPECIES];
+    int data_modified[MAX_SPECIES];
+    struct species_data species[MAX_SPECIES];
+    struct nampla_data *namplas[MAX_SPECIES];
+    struct ship_data *ships[MAX_SPECIES];
+    int num_transactions;
+    struct trans_data *transactions;
+    // files created during the phase, removed if it is rolled back
+    int num_files;
+    char **files;
+} snapshot_t;
+
+static snapshot_t snapshot;
+
+
+static void copyBack(void *dst, const void *src, int count, int size);
+
+static void *copyOf(const void *src, int count, int size);
+
+static void snapshotRelease(void);
+
+
+// snapshotTake remembers the loaded data so that the phase can be rolled back.
+void snapshotTake(void) {
+    if (snapshot.taken) {
+        fprintf(stderr, "\n\tInternal error! A snapshot has already been taken!\n\n");
+        exit(2);
+    }
+    snapshot.taken = TRUE;
+    snapshot.seed = prngGetSeed();
+    snapshot.galaxy = galaxy;
+    snapshot.num_stars = num_stars;
+    snapshot.stars = copyOf(star_base, num_stars, sizeof(struct star_data));
+    snapshot.star_data_modified = star_data_modified;
+    snapshot.num_planets = num_planets;
+    snapshot.planets = copyOf(planet_base, num_planets, sizeof(struct planet_data));
+    snapshot.planet_data_modified = planet_data_modified;
+    for (int i = 0; i < MAX_SPECIES; i++) {
+        snapshot.data_in_memory[i] = data_in_memory[i];
+        snapshot.data_modified[i] = data_modified[i];
+        if (data_in_memory[i]) {
+            snapshot.species[i] = spec_data[i];
+            snapshot.namplas[i] = copyOf(namp_data[i], spec_data[i].num_namplas, sizeof(struct nampla_data));
+            snapshot.ships[i] = copyOf(ship_data[i], spec_data[i].num_ships, sizeof(struct ship_data));
+        }
+    }
+    snapshot.num_transactions = num_transactions;
+    snapshot.transactions = copyOf(transaction, num_transactions, sizeof(struct trans_data));
+}
+
+
+// snapshotPreview shows the gamemaster the logs and asks whether to keep the results.
+// Returns TRUE if the phase was committed, FALSE if it was rolled back.
+int snapshotPreview(void) {
+    for (int i = 0; i < MAX_SPECIES; i++) {
+        const char *text;
+        size_t length;
+        if (!logSinkText(i + 1, &text, &length)) {
+            continue;
+        }
+        printf("\n*** Log for species #%d, SP %s:\n", i + 1, spec_data[i].name);
+        fwrite(text, 1, length, stdout);
+    }
+
+    char answer[16];
+    printf("\nFinal chance to abort safely!\n");
+    printf("*** Gamemaster safe-abort option ... type q or Q to quit: ");
+    fflush(stdout);
+    if (fgets(answer, 16, stdin) != NULL && (answer[0] == 'q' || answer[0] == 'Q')) {
+        snapshotRestore();
+        return FALSE;
+    }
+    snapshotCommit();
+    return TRUE;
+}
+
+
+// snapshotCommit keeps the results of the phase.
+// The logs are written by the phase when it saves its results.
+void snapshotCommit(void) {
+    snapshotRelease();
+}
+
+
+// snapshotRestore puts the data back the way it was when the snapshot was taken,
+// removes any files the phase created, and throws away the held logs.
+void snapshotRestore(void) {
+    prngSetSeed(snapshot.seed);
+    galaxy = snapshot.galaxy;
+    num_stars = snapshot.num_stars;
+    copyBack(star_base, snapshot.stars, num_stars, sizeof(struct star_data));
+    star_data_modified = snapshot.star_data_modified;
+    num_planets = snapshot.num_planets;
+    copyBack(planet_base, snapshot.planets, num_planets, sizeof(struct planet_data));
+    planet_data_modified = snapshot.planet_data_modified;
+    for (int i = 0; i < MAX_SPECIES; i++) {
+        data_in_memory[i] = snapshot.data_in_memory[i];
+        data_modified[i] = snapshot.data_modified[i];
+        if (data_in_memory[i]) {
+            spec_data[i] = snapshot.species[i];
+            // the arrays may have grown and moved since the snapshot was taken
+            spec_data[i].home.nampla = namp_data[i];
+            copyBack(namp_data[i], snapshot.namplas[i], spec_data[i].num_namplas, sizeof(struct nampla_data));
+            copyBack(ship_data[i], snapshot.ships[i], spec_data[i].num_ships, sizeof(struct ship_data));
+        }
+    }
+    transactionReplace(snapshot.transactions, snapshot.num_transactions);
+    // units may be back in sectors the index no longer lists them in
+    sectorReset();
+    nameIndexReset();
+    for (int i = 0; i < snapshot.num_files; i++) {
+        unlink(snapshot.files[i]);
+    }
+    logSinkDrop();
+    snapshotRelease();
+}
+
+
+// snapshotFileCreated records a file created by the phase so that a roll back can remove it.
+void snapshotFileCreated(const char *filename) {
+    if (!snapshot.taken) {
+        return;
+    }
+    char **files = (char **) ncalloc(__FUNCTION__, __LINE__, snapshot.num_files + 1, sizeof(char *));
+    if (snapshot.num_files > 0) {
+        memcpy(files, snapshot.files, snapshot.num_files * sizeof(char *));
+    }
+    free(snapshot.files);
+    files[snapshot.num_files] = strdup(filename);
+    snapshot.files = files;
+    snapshot.num_files++;
+}
+
+
+static void copyBack(void *dst, const void *src, int count, int size) {
+    if (src != NULL && count > 0) {
+        memcpy(dst, src, (size_t) count * size);
+    }
+}
+
+
+static void *copyOf(const void *src, int count, int size) {
+    if (src == NULL || count == 0) {
+        return NULL;
+    }
+    void *dst = ncalloc(__FUNCTION__, __LINE__, count, size);
+    memcpy(dst, src, (size_t) count * size);
+    return dst;
+}
+
+
+static void snapshotRelease(void) {
+    free(snapshot.stars);
+    free(snapshot.planets);
+    for (int i = 0; i < MAX_SPECIES; i++) {
+        free(snapshot.namplas[i]);
+        free(snapshot.ships[i]);
+    }
+    free(snapshot.transactions);
+    for (int i = 0; i < snapshot.num_files; i++) {
+        free(snapshot.files[i]);
+    }
+    free(snapshot.files);
+    memset(&snapshot, 0, sizeof(snapshot));
+}
@@ -20,7 +20,9 @@
 #include <stdlib.h>
 #include "galaxy.h"
 #include "galaxyio.h"
+#include "nameindex.h"
 #include "planet.h"
+#include "sector.h"
 #include "species.h"
 #include "speciesio.h"
 #include "namplavars.h"
@@ -29,15 +31,18 @@
 
 int alien_is_visible(int x, int y, int z, int species_number, int alien_number) {
     int i, j;
-    struct species_data *species, *alien;
     struct nampla_data *nampla, *alien_nampla;
     struct ship_data *alien_ship;
 
+    sector_t *sector = sectorAt(x, y, z);
+    if (sector == NULL) {
+        return FALSE;
+    }
+
     /* Check if the alien has a ship or starbase here that is in orbit or in deep space. */
-    alien = &spec_data[alien_number - 1];
-    alien_ship = ship_data[alien_number - 1] - 1;
-    for (i = 0; i < alien->num_ships; i++) {
-        ++alien_ship;
+    for (i = 0; i < sector->num_ships; i++) {
+        if (sector->ship[i].species_index != alien_number - 1) { continue; }
+        alien_ship = ship_data[alien_number - 1] + sector->ship[i].index;
 
         if (alien_ship->x != x) { continue; }
         if (alien_ship->y != y) { continue; }
@@ -50,9 +55,9 @@ int alien_is_visible(int x, int y, int z, int species_number, int alien_number)
     }
 
     /* Check if alien has a planet that is not hidden. */
-    alien_nampla = namp_data[alien_number - 1] - 1;
-    for (i = 0; i < alien->num_namplas; i++) {
-        ++alien_nampla;
+    for (i = 0; i < sector->num_namplas; i++) {
+        if (sector->nampla[i].species_index != alien_number - 1) { continue; }
+        alien_nampla = namp_data[alien_number - 1] + sector->nampla[i].index;
 
         if (alien_nampla->x != x) { continue; }
         if (alien_nampla->y != y) { continue; }
@@ -62,10 +67,9 @@ int alien_is_visible(int x, int y, int z, int species_number, int alien_number)
         if (!alien_nampla->hidden) { return TRUE; }
 
         /* The colony is hidden. See if we have population on the same planet. */
-        species = &spec_data[species_number - 1];
-        nampla = namp_data[species_number - 1] - 1;
-        for (j = 0; j < species->num_namplas; j++) {
-            ++nampla;
+        for (j = 0; j < sector->num_namplas; j++) {
+            if (sector->nampla[j].species_index != species_number - 1) { continue; }
+            nampla = namp_data[species_number - 1] + sector->nampla[j].index;
 
             if (nampla->x != x) { continue; }
             if (nampla->y != y) { continue; }
@@ -102,15 +106,10 @@ int distorted(int species_number) {
 
 // free_species_data will free memory used for all species data
 void free_species_data(void) {
+    sectorReset();
+    nameIndexReset();
     for (int species_index = 0; species_index < galaxy.num_species; species_index++) {
-        if (namp_data[species_index] != NULL) {
-            free(namp_data[species_index]);
-            namp_data[species_index] = NULL;
-        }
-        if (ship_data[species_index] != NULL) {
-            free(ship_data[species_index]);
-            ship_data[species_index] = NULL;
-        }
+        freeSpeciesArrays(species_index);
         data_in_memory[species_index] = FALSE;
         data_modified[species_index] = FALSE;
     }
@@ -22,13 +22,20 @@
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
+#include "arena.h"
 #include "data.h"
+#include "datafile.h"
 #include "engine.h"
+#include "fileimage.h"
 #include "galaxy.h"
 #include "galaxyio.h"
 #include "species.h"
 #include "speciesio.h"
+#include "nameindex.h"
 #include "namplaio.h"
+#include "planetio.h"
+#include "resident.h"
+#include "sector.h"
 #include "namplavars.h"
 #include "shipio.h"
 #include "shipvars.h"
@@ -41,37 +48,55 @@ int data_modified[MAX_SPECIES];
 
 struct species_data spec_data[MAX_SPECIES];
 
+// format of each species file when it was loaded; saves keep the same format
+int species_data_version[MAX_SPECIES];
+
+// backs namp_data and ship_data when a version 2 file is used in place
+static datafile_t speciesFile[MAX_SPECIES];
+
+// each species file as it was loaded, so saves only write the records that changed
+static file_image_t speciesImage[MAX_SPECIES];
+
+
+static int getSpeciesDataV2(int species_index, const char *filename);
+
+static void growSpeciesArrays(int species_index, int num_namplas, int num_ships);
+
+static void linkSpecies(int species_index);
+
+static void saveSpeciesText(species_data_t *sp);
+
 
 // get_species_data will read in data files for all species
 void get_species_data(void) {
-    // allocate memory to load the data into memory
-    binary_species_data_t *data = (binary_species_data_t *) ncalloc(__FUNCTION__, __LINE__,
-                                                                    sizeof(binary_species_data_t), 1);
-    if (data == NULL) {
-        perror("get_species_data");
-        fprintf(stderr, "\nCannot allocate enough memory for species file!\n\n");
-        exit(2);
-    }
+    // the sector index points into the species data
+    sectorReset();
+    nameIndexReset();
 
     for (int species_index = 0; species_index < galaxy.num_species; species_index++) {
         struct species_data *sp = &spec_data[species_index];
 
         // clear out any existing species data
         memset(&spec_data[species_index], 0, sizeof(struct species_data));
-        if (namp_data[species_index] != NULL) {
-            free(namp_data[species_index]);
-            namp_data[species_index] = NULL;
-        }
-        if (ship_data[species_index] != NULL) {
-            free(ship_data[species_index]);
-            ship_data[species_index] = NULL;
-        }
-        num_new_namplas[species_index] = 0;
-        num_new_ships[species_index] = 0;
+        freeSpeciesArrays(species_index);
         data_modified[species_index] = FALSE;
         data_in_memory[species_index] = FALSE;
     }
 
+    if (galaxy_resident) {
+        residentGetSpeciesData();
+        return;
+    }
+
+    // allocate memory to load the data into memory
+    binary_species_data_t *data = (binary_species_data_t *) arenaAlloc(__FUNCTION__, __LINE__,
+                                                                    sizeof(binary_species_data_t), 1);
+    if (data == NULL) {
+        perror("get_species_data");
+        fprintf(stderr, "\nCannot allocate enough memory for species file!\n\n");
+        exit(2);
+    }
+
     for (int species_index = 0; species_index < galaxy.num_species; species_index++) {
         struct species_data *sp = &spec_data[species_index];
 
@@ -86,8 +111,13 @@ void get_species_data(void) {
             continue;
         }
 
+        if (getSpeciesDataV2(species_index, filename)) {
+            species_data_version[species_index] = 2;
+            continue;
+        }
+
         /* Open the species data file. */
-        FILE *fp = fopen(filename, "rb");
+        FILE *fp = fileImageOpen(&speciesImage[species_index], filename);
         if (fp == NULL) {
             perror("get_species_data");
             continue;
@@ -137,51 +167,188 @@ void get_species_data(void) {
             sp->enemy[j] = data->enemy[j];
         }
 
-        /* load nampla data from file and create empty slots for future use */
-        namp_data[species_index] = get_nampla_data(sp->num_namplas, extra_namplas, fp);
+        /* load nampla data from file, with an empty slot for the next new one */
+        namp_data[species_index] = get_nampla_data(sp->num_namplas, 1, fp);
+        max_namplas[species_index] = sp->num_namplas + 1;
 
-        /* load ship data from file and create empty slots for future use */
-        ship_data[species_index] = get_ship_data(sp->num_ships, extra_ships, fp);
+        /* load ship data from file, with an empty slot for the next new one */
+        ship_data[species_index] = get_ship_data(sp->num_ships, 1, fp);
+        max_ships[species_index] = sp->num_ships + 1;
 
-        data_in_memory[species_index] = TRUE;
-        num_new_namplas[species_index] = 0;
-        num_new_ships[species_index] = 0;
-
-        // mdhender: added fields to help clean up code
-        sp->id = species_index + 1;
-        sp->index = species_index;
-        sp->home.nampla = &namp_data[species_index][0];
-        sp->home.planet = sp->home.nampla->planet;
-        sp->home.star = sp->home.nampla->star;
+        linkSpecies(species_index);
+        species_data_version[species_index] = 1;
 
         fclose(fp);
     }
 
-    free(data);
+}
+
+
+// getSpeciesDataV2 loads a species file if it is a version 2 file.
+// Returns FALSE if it is not.
+static int getSpeciesDataV2(int species_index, const char *filename) {
+    datafile_t df;
+    if (!datafileOpen(filename, &df)) {
+        return FALSE;
+    }
+    struct species_data *sp = &spec_data[species_index];
+    int numRecords, numNamplas, numShips;
+    memcpy(sp, datafileSection(&df, 0, sizeof(struct species_data), &numRecords), sizeof(struct species_data));
+    struct nampla_data *namplas = datafileSection(&df, 1, sizeof(struct nampla_data), &numNamplas);
+    struct ship_data *ships = datafileSection(&df, 2, sizeof(struct ship_data), &numShips);
+    if (numRecords != 1 || numNamplas != sp->num_namplas || numShips != sp->num_ships) {
+        fprintf(stderr, "\nSpecies record does not match colony and ship counts in file '%s'!\n\n", filename);
+        exit(2);
+    }
+    if (map_data_in_place) {
+        namp_data[species_index] = namplas;
+        ship_data[species_index] = ships;
+        max_namplas[species_index] = numNamplas;
+        max_ships[species_index] = numShips;
+        speciesFile[species_index] = df;
+        fileImageForget(&speciesImage[species_index]);
+    } else {
+        max_namplas[species_index] = numNamplas + 1;
+        namp_data[species_index] = (struct nampla_data *) ncalloc(__FUNCTION__, __LINE__, max_namplas[species_index], sizeof(struct nampla_data));
+        memcpy(namp_data[species_index], namplas, numNamplas * sizeof(struct nampla_data));
+        max_ships[species_index] = numShips + 1;
+        ship_data[species_index] = (struct ship_data *) ncalloc(__FUNCTION__, __LINE__, max_ships[species_index], sizeof(struct ship_data));
+        memcpy(ship_data[species_index], ships, numShips * sizeof(struct ship_data));
+        fileImageRemember(&speciesImage[species_index], filename, df.base, df.length);
+        datafileClose(&df);
+    }
+    for (int i = 0; i < numNamplas; i++) {
+        struct nampla_data *nampla = &namp_data[species_index][i];
+        nampla->id = i + 1;
+        nampla->planet = planet_base + nampla->planet_index;
+        nampla->star = nampla->planet->star;
+    }
+    linkSpecies(species_index);
+    return TRUE;
+}
+
+
+// linkSpecies marks a species as loaded and sets the fields that are not saved.
+static void linkSpecies(int species_index) {
+    struct species_data *sp = &spec_data[species_index];
+
+    data_in_memory[species_index] = TRUE;
+
+    // mdhender: added fields to help clean up code
+    sp->id = species_index + 1;
+    sp->index = species_index;
+    sp->home.nampla = &namp_data[species_index][0];
+    sp->home.planet = sp->home.nampla->planet;
+    sp->home.star = sp->home.nampla->star;
+}
+
+
+// freeSpeciesArrays releases the colony and ship arrays for a species.
+void freeSpeciesArrays(int species_index) {
+    if (speciesFile[species_index].base != NULL) {
+        // the arrays point into the mapped file
+        datafileClose(&speciesFile[species_index]);
+    } else {
+        free(namp_data[species_index]);
+        free(ship_data[species_index]);
+    }
+    namp_data[species_index] = NULL;
+    ship_data[species_index] = NULL;
+    max_namplas[species_index] = 0;
+    max_ships[species_index] = 0;
+}
+
+
+// growSpeciesArrays gives a species room for num_namplas colonies and num_ships ships.
+// An array that grows is moved. Indexes into it stay valid, and the global pointers into
+// the old array are moved to the new one; callers must refresh any other pointers they hold.
+static void growSpeciesArrays(int species_index, int num_namplas, int num_ships) {
+    struct species_data *sp = &spec_data[species_index];
+    struct nampla_data *old_namplas = namp_data[species_index];
+    struct ship_data *old_ships = ship_data[species_index];
+    int mapped = speciesFile[species_index].base != NULL;
+
+    /* Arrays that point into a mapped file are always moved, since the file is closed. */
+    if (mapped || num_namplas != max_namplas[species_index]) {
+        struct nampla_data *namplas = (struct nampla_data *) ncalloc(__FUNCTION__, __LINE__, num_namplas + 1, sizeof(struct nampla_data));
+        memcpy(namplas, old_namplas, sp->num_namplas * sizeof(struct nampla_data));
+
+        /* Pointers may sit one before the start of the array while scanning it. */
+        if (nampla_base == old_namplas) { nampla_base = namplas; }
+        if (nampla != NULL && nampla >= old_namplas - 1 && nampla <= old_namplas + max_namplas[species_index]) {
+            nampla = namplas + (nampla - old_namplas);
+        }
+        if (next_nampla != NULL && next_nampla >= old_namplas - 1 && next_nampla <= old_namplas + max_namplas[species_index]) {
+            next_nampla = namplas + (next_nampla - old_namplas);
+        }
+        if (sp->home.nampla == old_namplas) { sp->home.nampla = namplas; }
+
+        if (!mapped) { free(old_namplas); }
+        namp_data[species_index] = namplas;
+        max_namplas[species_index] = num_namplas;
+    }
+
+    if (mapped || num_ships != max_ships[species_index]) {
+        struct ship_data *ships = (struct ship_data *) ncalloc(__FUNCTION__, __LINE__, num_ships + 1, sizeof(struct ship_data));
+        memcpy(ships, old_ships, sp->num_ships * sizeof(struct ship_data));
+
+        if (ship_base == old_ships) { ship_base = ships; }
+        if (ship != NULL && ship >= old_ships - 1 && ship <= old_ships + max_ships[species_index]) {
+            ship = ships + (ship - old_ships);
+        }
+
+        if (!mapped) { free(old_ships); }
+        ship_data[species_index] = ships;
+        max_ships[species_index] = num_ships;
+    }
+
+    if (mapped) {
+        datafileClose(&speciesFile[species_index]);
+    }
 }
 
 
 // save_species_data will write all data that has been modified
 void save_species_data(void) {
+    if (galaxy_resident) {
+        residentSaveSpeciesData();
+        return;
+    }
+
     for (int species_index = 0; species_index < galaxy.num_species; species_index++) {
         if (data_in_memory[species_index] != FALSE && data_modified[species_index] != FALSE) {
             // get the filename for the species
             char filename[128];
             sprintf(filename, "sp%02d.dat", species_index + 1);
 
-            /* Open the species data file. */
-            FILE *fp = fopen(filename, "wb");
+            if (species_data_version[species_index] == 2) {
+                saveSpeciesDataV2(&spec_data[species_index], namp_data[species_index], ship_data[species_index], filename, &speciesImage[species_index]);
+                data_modified[species_index] = FALSE;
+                continue;
+            }
+
+            // translate the species, colonies, and ship data into memory
+            char *image = NULL;
+            size_t length = 0;
+            FILE *fp = open_memstream(&image, &length);
             if (fp == NULL) {
                 perror("save_species_data");
                 fprintf(stderr, "\n\tCannot create new version of file '%s'!\n", filename);
                 exit(2);
             }
-            // save the species, colonies, and ship data
             saveSpeciesData(&spec_data[species_index], namp_data[species_index], ship_data[species_index], fp);
+            fclose(fp);
+            // then write only the records that changed since the file was loaded
+            species_data_t *sp = &spec_data[species_index];
+            file_records_t records[3] = {
+                    {0, sizeof(binary_species_data_t), 1},
+                    {sizeof(binary_species_data_t), sizeof(binary_nampla_data_t), sp->num_namplas},
+                    {sizeof(binary_species_data_t) + sp->num_namplas * sizeof(binary_nampla_data_t), sizeof(binary_ship_data_t), sp->num_ships},
+            };
+            fileImageWrite(&speciesImage[species_index], filename, image, length, 3, records);
+            free(image);
             // be kind and signal that it's been saved
             data_modified[species_index] = FALSE;
-            // closing the file is always nice
-            fclose(fp);
         }
     }
 }
@@ -237,9 +404,36 @@ void saveSpeciesData(species_data_t *sp, nampla_data_t *colonies, ship_data_t *s
     // save ships data
     save_ship_data(ships, sp->num_ships, fp);
 
+    saveSpeciesText(sp);
+}
+
+
+// saveSpeciesDataV2 writes the species, colonies, and ships as a version 2 file.
+// fi, if not NULL, is the file as it was loaded.
+void saveSpeciesDataV2(species_data_t *sp, nampla_data_t *colonies, ship_data_t *ships, const char *filename, file_image_t *fi) {
+    species_data_t spRecord = *sp;
+    memset(&spRecord.home, 0, sizeof(spRecord.home));
+    nampla_data_t *namplaRecords = (nampla_data_t *) ncalloc(__FUNCTION__, __LINE__, sp->num_namplas + 1, sizeof(nampla_data_t));
+    memcpy(namplaRecords, colonies, sp->num_namplas * sizeof(nampla_data_t));
+    for (int i = 0; i < sp->num_namplas; i++) {
+        namplaRecords[i].star = NULL;
+        namplaRecords[i].planet = NULL;
+    }
+
+    void *sections[3] = {&spRecord, namplaRecords, ships};
+    int recordSize[3] = {sizeof(species_data_t), sizeof(nampla_data_t), sizeof(ship_data_t)};
+    int numRecords[3] = {1, sp->num_namplas, sp->num_ships};
+    datafileWrite(filename, fi, 3, sections, recordSize, numRecords);
+    free(namplaRecords);
+
+    saveSpeciesText(sp);
+}
+
+
+static void saveSpeciesText(species_data_t *sp) {
     char filename[128];
     sprintf(filename, "species%03d.txt", sp->id);
-    fp = fopen(filename, "wb");
+    FILE *fp = fopen(filename, "wb");
     if (fp != NULL) {
         speciesDataAsSExpr(sp, fp);
         fclose(fp);
@@ -360,3 +554,24 @@ void speciesDataAsSExpr(species_data_t *sp, FILE *fp) {
     fprintf(fp, ")\n");
 }
 
+
+// speciesReserveNampla makes sure that there is room for one more colony at the end of the
+// colony array of a species and returns that slot. The array may move; see growSpeciesArrays.
+struct nampla_data *speciesReserveNampla(int species_index) {
+    struct species_data *sp = &spec_data[species_index];
+    if (sp->num_namplas >= max_namplas[species_index]) {
+        growSpeciesArrays(species_index, 2 * sp->num_namplas + 1, max_ships[species_index]);
+    }
+    return namp_data[species_index] + sp->num_namplas;
+}
+
+
+// speciesReserveShip makes sure that there is room for one more ship at the end of the
+// ship array of a species and returns that slot. The array may move; see growSpeciesArrays.
+struct ship_data *speciesReserveShip(int species_index) {
+    struct species_data *sp = &spec_data[species_index];
+    if (sp->num_ships >= max_ships[species_index]) {
+        growSpeciesArrays(species_index, max_namplas[species_index], 2 * sp->num_ships + 1);
+    }
+    return ship_data[species_index] + sp->num_ships;
+}
@@ -21,6 +21,7 @@
 #define FAR_HORIZONS_SPECIESIO_H
 
 #include <stdio.h>
+#include "fileimage.h"
 #include "species.h"
 
 
@@ -28,12 +29,20 @@ void get_species_data(void);
 
 void save_species_data(void);
 
+void freeSpeciesArrays(int species_index);
+
 void saveSpeciesData(species_data_t *sp, nampla_data_t *colonies, ship_data_t *ships, FILE *fp);
 
+void saveSpeciesDataV2(species_data_t *sp, nampla_data_t *colonies, ship_data_t *ships, const char *filename, file_image_t *fi);
+
 void speciesDataAsJson(species_data_t *sp, FILE *fp);
 
 void speciesDataAsSExpr(species_data_t *sp, FILE *fp);
 
+struct nampla_data *speciesReserveNampla(int species_index);
+
+struct ship_data *speciesReserveShip(int species_index);
+
 
 // globals. ugh.
 
@@ -43,4 +52,6 @@ extern int data_modified[MAX_SPECIES];
 
 extern struct species_data spec_data[MAX_SPECIES];
 
+extern int species_data_version[MAX_SPECIES];
+
 #endif //FAR_HORIZONS_SPECIESIO_H
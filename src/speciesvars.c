@@ -22,10 +22,10 @@
 
 int sp_tech_level[6];
 
-struct species_data *species;
+THREAD_LOCAL struct species_data *species;
 
 int species_index; // zero-based index, mostly for accessing arrays
 
-int species_number; // one-based index, for reports and file names
+THREAD_LOCAL int species_number; // one-based index, for reports and file names
 
 const char *tech_level_names[6] = {"MI", "MA", "ML", "GV", "LS", "BI"};
@@ -20,14 +20,15 @@
 #ifndef FAR_HORIZONS_SPECIESVARS_H
 #define FAR_HORIZONS_SPECIESVARS_H
 
+#include "engine.h"
 #include "species.h"
 
 // globals. ugh.
 
 extern int sp_tech_level[6];
-extern struct species_data *species;
+extern THREAD_LOCAL struct species_data *species;
 extern int species_index;
-extern int species_number;
+extern THREAD_LOCAL int species_number;
 
 extern const char *tech_level_names[6];
 
@@ -20,6 +20,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#include <pthread.h>
 #include "locationvars.h"
 #include "log.h"
 #include "logvars.h"
@@ -28,7 +29,9 @@
 #include "ordersvars.h"
 #include "planetio.h"
 #include "planetvars.h"
+#include "sector.h"
 #include "star.h"
+#include "starindex.h"
 #include "stario.h"
 #include "starvars.h"
 #include "species.h"
@@ -41,6 +44,16 @@ char size_char[] = "0123456789";
 
 char type_char[] = " dD g";
 
+// guards visited_by while reports are written
+static pthread_mutex_t visited_lock = PTHREAD_MUTEX_INITIALIZER;
+
+
+static int starIsHomeSystem(star_data_t *star, int unused);
+
+static void starMarkVisited(star_data_t *star);
+
+static int starNotVisited(star_data_t *star, int number);
+
 
 // changeSystemToHomeSystem replaces the planets in a system with ones
 // from the related homesystem template. the template flags one of the
@@ -155,56 +168,18 @@ int chToStarType(char ch) {
 }
 
 void closest_unvisited_star(struct ship_data *ship) {
-    int found = FALSE;
-    long shx;
-    long shy;
-    long shz;
-    long stx;
-    long sty;
-    long stz;
-    long closest_distance = 999999;
-    long temp_distance;
-    struct star_data *star;
-    struct star_data *closest_star;
-
-    /* Get array index and bit mask. */
-    int species_array_index = (species_number - 1) / 32;
-    int species_bit_number = (species_number - 1) % 32;
-    long species_bit_mask = 1 << species_bit_number;
-
-    shx = ship->x;
-    shy = ship->y;
-    shz = ship->z;
+    int closest;
 
     x = -1;
 
-    for (int i = 0; i < num_stars; i++) {
-        star = star_base + i;
-
-        /* Check if bit is already set. */
-        if (star->visited_by[species_array_index] & species_bit_mask) {
-            continue;
-        }
-
-        stx = star->x;
-        sty = star->y;
-        stz = star->z;
-        temp_distance = ((shx - stx) * (shx - stx)) + ((shy - sty) * (shy - sty)) + ((shz - stz) * (shz - stz));
-
-        if (temp_distance < closest_distance) {
-            x = stx;
-            y = sty;
-            z = stz;
-            closest_distance = temp_distance;
-            closest_star = star;
-            found = TRUE;
-        }
-    }
-
-    if (found) {
+    if (starNearest(ship->x, ship->y, ship->z, 999998, starNotVisited, species_number, &closest, 1) > 0) {
+        struct star_data *closest_star = star_base + closest;
+        x = closest_star->x;
+        y = closest_star->y;
+        z = closest_star->z;
         fprintf(orders_file, "%d %d %d", x, y, z);
         /* So that we don't send more than one ship to the same place. */
-        closest_star->visited_by[species_array_index] |= species_bit_mask;
+        starMarkVisited(closest_star);
     } else {
         fprintf(orders_file, "???");
     }
@@ -212,53 +187,26 @@ void closest_unvisited_star(struct ship_data *ship) {
 
 
 // closest_unvisited_star_report is just slight different? why?
-void closest_unvisited_star_report(struct ship_data *ship, FILE *fp) {
-    int i, found, species_array_index, species_bit_number;
-    long shx, shy, shz, stx, sty, stz, closest_distance, temp_distance, species_bit_mask;
-    struct star_data *star, *closest_star;
-
-    /* Get array index and bit mask. */
-    species_array_index = (species_number - 1) / 32;
-    species_bit_number = (species_number - 1) % 32;
-    species_bit_mask = 1 << species_bit_number;
-
-    shx = ship->x;
-    shy = ship->y;
-    shz = ship->z;
-
-    x = 9999;
-    closest_distance = 999999;
-
-    found = FALSE;
-    for (i = 0; i < num_stars; i++) {
-        star = star_base + i;
-
-        /* Check if bit is already set. */
-        if (star->visited_by[species_array_index] & species_bit_mask) { continue; }
-
-        stx = star->x;
-        sty = star->y;
-        stz = star->z;
-
-        temp_distance = ((shx - stx) * (shx - stx)) + ((shy - sty) * (shy - sty)) + ((shz - stz) * (shz - stz));
-
-        if (temp_distance < closest_distance) {
-            x = stx;
-            y = sty;
-            z = stz;
-            closest_distance = temp_distance;
-            closest_star = star;
-            found = TRUE;
-        }
-    }
-
-    if (found) {
-        fprintf(fp, "%d %d %d", x, y, z);
-        closest_star->visited_by[species_array_index] |= species_bit_mask;
+// It returns the coordinates in dest_x, dest_y and dest_z, with dest_x set to 9999 if there is no such star.
+// Reports are written on several threads, so the search and the update of the visited bits are locked.
+void closest_unvisited_star_report(struct ship_data *ship, FILE *fp, int *dest_x, int *dest_y, int *dest_z) {
+    int closest;
+
+    *dest_x = 9999;
+
+    pthread_mutex_lock(&visited_lock);
+    if (starNearest(ship->x, ship->y, ship->z, 999998, starNotVisited, species_number, &closest, 1) > 0) {
+        struct star_data *closest_star = star_base + closest;
+        *dest_x = closest_star->x;
+        *dest_y = closest_star->y;
+        *dest_z = closest_star->z;
+        fprintf(fp, "%d %d %d", *dest_x, *dest_y, *dest_z);
+        starMarkVisited(closest_star);
         /* So that we don't send more than one ship to the same place. */
     } else {
         fprintf(fp, "???");
     }
+    pthread_mutex_unlock(&visited_lock);
 }
 
 
@@ -323,20 +271,8 @@ star_data_t *findHomeSystemCandidate(int radius) {
 
 // hasHomeSystemNeighbor returns TRUE if the star has a neighbor within the given radius that is a home system.
 int hasHomeSystemNeighbor(star_data_t *star, int radius) {
-    int radiusSquared = radius * radius;
-    for (int i = 0; i < num_stars; i++) {
-        star_data_t *star2 = star_base + i;
-        if (star2->home_system == FALSE) {
-            continue;
-        }
-        int dx = star->x - star2->x;
-        int dy = star->y - star2->y;
-        int dz = star->z - star2->z;
-        if (dx * dx + dy * dy + dz * dz <= radiusSquared) {
-            return TRUE;
-        }
-    }
-    return FALSE;
+    int neighbor;
+    return starNearest(star->x, star->y, star->z, radius * radius, starIsHomeSystem, 0, &neighbor, 1) > 0;
 }
 
 
@@ -469,19 +405,35 @@ int star_visited(int x, int y, int z) {
     int species_bit_number = (species_number - 1) % 32;
     long species_bit_mask = 1 << species_bit_number;
 
-    for (int i = 0; i < num_stars; i++) {
-        struct star_data *star = star_base + i;
-        if (x != star->x) { continue; }
-        if (y != star->y) { continue; }
-        if (z != star->z) { continue; }
+    sector_t *sector = sectorAt(x, y, z);
+    if (sector != NULL && sector->star_index >= 0) {
+        struct star_data *star = star_base + sector->star_index;
         found = TRUE;
         /* Check if bit is already set. */
-        if (star->visited_by[species_array_index] & species_bit_mask) { break; }
-        /* Set the appropriate bit. */
-        star->visited_by[species_array_index] |= species_bit_mask;
-        star_data_modified = TRUE;
-        break;
+        if ((star->visited_by[species_array_index] & species_bit_mask) == 0) {
+            /* Set the appropriate bit. */
+            star->visited_by[species_array_index] |= species_bit_mask;
+            star_data_modified = TRUE;
+        }
     }
 
     return found;
 }
+
+
+// starIsHomeSystem is the search filter for home systems.
+static int starIsHomeSystem(star_data_t *star, int unused) {
+    return star->home_system != FALSE;
+}
+
+
+// starMarkVisited sets the current species' bit in the star's visited list.
+static void starMarkVisited(star_data_t *star) {
+    star->visited_by[(species_number - 1) / 32] |= (uint32_t) 1 << ((species_number - 1) % 32);
+}
+
+
+// starNotVisited is the search filter for stars the species has not visited.
+static int starNotVisited(star_data_t *star, int number) {
+    return (star->visited_by[(number - 1) / 32] & ((uint32_t) 1 << ((number - 1) % 32))) == 0;
+}
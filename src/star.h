@@ -51,7 +51,7 @@ int chToStarType(char ch);
 
 void closest_unvisited_star(struct ship_data *ship);
 
-void closest_unvisited_star_report(struct ship_data *ship, FILE *fp);
+void closest_unvisited_star_report(struct ship_data *ship, FILE *fp, int *dest_x, int *dest_y, int *dest_z);
 
 double distanceBetween(star_data_t *s1, star_data_t *s2);
 
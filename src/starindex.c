@@ -0,0 +1,244 @@
+// Far Horizons Game Engine
+// Copyright (C) 2022 Michael D Henderson
+// Copyright (C) 2021 Raven Zachary
+// Copyright (C) 2019 Casey Link, Adam Piggott
+// Copyright (C) 1999 Richard A. Morneau
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "engine.h"
+#include "starindex.h"
+#include "stario.h"
+
+
+// the stars bucketed by the cell of the grid that holds them.
+// the stars in cell c are star[first[c]] up to, but not including, star[first[c + 1]].
+static struct {
+    int built;
+    struct star_data *base;  // the star data the index was built from
+    int num_stars;
+    int min_x, min_y, min_z; // the corner of the grid
+    int cell_size;           // length of the side of a cell, in parsecs
+    int nx, ny, nz;          // number of cells along each axis
+    int *first;
+    int *star;               // star indexes, grouped by cell and in index order within a cell
+} grid;
+
+
+static int starDistanceSquared(int index, int x, int y, int z);
+
+static void starInsert(int index, int x, int y, int z, int *found, int *count, int k);
+
+static int starSearch(int x, int y, int z, int max_distance_squared, star_filter_t filter, int arg, int *found, int k);
+
+static int starToCell(int offset);
+
+
+// starIndexBuild sizes the cells so that there is about one star per cell and sorts the stars into them.
+// Searches call it when the index is missing or stale.
+void starIndexBuild(void) {
+    starIndexReset();
+    grid.built = TRUE;
+    grid.base = star_base;
+    grid.num_stars = num_stars;
+    if (num_stars == 0) {
+        return;
+    }
+
+    int max_x = star_base[0].x, max_y = star_base[0].y, max_z = star_base[0].z;
+    grid.min_x = max_x;
+    grid.min_y = max_y;
+    grid.min_z = max_z;
+    for (int i = 1; i < num_stars; i++) {
+        struct star_data *star = star_base + i;
+        if (star->x < grid.min_x) { grid.min_x = star->x; }
+        if (star->y < grid.min_y) { grid.min_y = star->y; }
+        if (star->z < grid.min_z) { grid.min_z = star->z; }
+        if (star->x > max_x) { max_x = star->x; }
+        if (star->y > max_y) { max_y = star->y; }
+        if (star->z > max_z) { max_z = star->z; }
+    }
+    long volume = (long) (max_x - grid.min_x + 1) * (max_y - grid.min_y + 1) * (max_z - grid.min_z + 1);
+    grid.cell_size = 1;
+    while ((long) grid.cell_size * grid.cell_size * grid.cell_size * num_stars < volume) {
+        grid.cell_size++;
+    }
+    grid.nx = (max_x - grid.min_x) / grid.cell_size + 1;
+    grid.ny = (max_y - grid.min_y) / grid.cell_size + 1;
+    grid.nz = (max_z - grid.min_z) / grid.cell_size + 1;
+
+    // counting sort on the cell keeps the stars in each cell in index order
+    int num_cells = grid.nx * grid.ny * grid.nz;
+    int *cell = ncalloc(__FUNCTION__, __LINE__, num_stars, sizeof(int));
+    grid.first = ncalloc(__FUNCTION__, __LINE__, num_cells + 1, sizeof(int));
+    grid.star = ncalloc(__FUNCTION__, __LINE__, num_stars, sizeof(int));
+    for (int i = 0; i < num_stars; i++) {
+        struct star_data *star = star_base + i;
+        int gx = starToCell(star->x - grid.min_x);
+        int gy = starToCell(star->y - grid.min_y);
+        int gz = starToCell(star->z - grid.min_z);
+        cell[i] = (gz * grid.ny + gy) * grid.nx + gx;
+        grid.first[cell[i] + 1]++;
+    }
+    for (int c = 0; c < num_cells; c++) {
+        grid.first[c + 1] += grid.first[c];
+    }
+    int *next = ncalloc(__FUNCTION__, __LINE__, num_cells, sizeof(int));
+    memcpy(next, grid.first, num_cells * sizeof(int));
+    for (int i = 0; i < num_stars; i++) {
+        grid.star[next[cell[i]]++] = i;
+    }
+    free(next);
+    free(cell);
+}
+
+
+// starIndexReset throws the index away. It is rebuilt from the star data when it is next used.
+void starIndexReset(void) {
+    free(grid.first);
+    free(grid.star);
+    memset(&grid, 0, sizeof(grid));
+}
+
+
+// starNearest finds up to k stars that pass the filter (NULL for all stars) and are no more than
+// sqrt(max_distance_squared) parsecs from the coordinates. It stores their indexes, nearest first,
+// in found and returns the number of stars found.
+int starNearest(int x, int y, int z, int max_distance_squared, star_filter_t filter, int arg, int *found, int k) {
+    return starSearch(x, y, z, max_distance_squared, filter, arg, found, k);
+}
+
+
+// starsWithin finds every star that passes the filter (NULL for all stars) and is no more than
+// sqrt(max_distance_squared) parsecs from the coordinates. found must have room for num_stars indexes.
+int starsWithin(int x, int y, int z, int max_distance_squared, star_filter_t filter, int arg, int *found) {
+    return starSearch(x, y, z, max_distance_squared, filter, arg, found, num_stars);
+}
+
+
+// starDistanceSquared returns the square of the distance from a star to the coordinates.
+static int starDistanceSquared(int index, int x, int y, int z) {
+    struct star_data *star = star_base + index;
+    int dx = star->x - x;
+    int dy = star->y - y;
+    int dz = star->z - z;
+    return dx * dx + dy * dy + dz * dz;
+}
+
+
+// starInsert adds the star to the list of stars found if it is nearer than the last one,
+// keeping the list ordered by distance and then by index and no longer than k.
+static void starInsert(int index, int x, int y, int z, int *found, int *count, int k) {
+    int distance_squared = starDistanceSquared(index, x, y, z);
+    int lo = 0, hi = *count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        int d = starDistanceSquared(found[mid], x, y, z);
+        if (d < distance_squared || (d == distance_squared && found[mid] < index)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == k) {
+        return;
+    }
+    int moving = (*count < k ? *count : k - 1) - lo;
+    memmove(&found[lo + 1], &found[lo], moving * sizeof(int));
+    found[lo] = index;
+    if (*count < k) {
+        (*count)++;
+    }
+}
+
+
+// starSearch visits the cells in rings of growing size around the cell holding the coordinates.
+// It stops when every star outside the rings visited is too far away to be in the list.
+static int starSearch(int x, int y, int z, int max_distance_squared, star_filter_t filter, int arg, int *found, int k) {
+    if (!grid.built || grid.base != star_base || grid.num_stars != num_stars) {
+        starIndexBuild();
+    }
+    int count = 0;
+    if (k < 1 || max_distance_squared < 0 || grid.num_stars == 0) {
+        return 0;
+    }
+
+    // the coordinates may be outside the grid, so the cell may be too
+    int cx = starToCell(x - grid.min_x);
+    int cy = starToCell(y - grid.min_y);
+    int cz = starToCell(z - grid.min_z);
+    int last_ring = 0;
+    int extent[6] = {cx, grid.nx - 1 - cx, cy, grid.ny - 1 - cy, cz, grid.nz - 1 - cz};
+    for (int i = 0; i < 6; i++) {
+        int n = extent[i] < 0 ? -extent[i] : extent[i];
+        if (n > last_ring) {
+            last_ring = n;
+        }
+    }
+
+    for (int ring = 0; ring <= last_ring; ring++) {
+        for (int dz = -ring; dz <= ring; dz++) {
+            int gz = cz + dz;
+            if (gz < 0 || gz >= grid.nz) {
+                continue;
+            }
+            for (int dy = -ring; dy <= ring; dy++) {
+                int gy = cy + dy;
+                if (gy < 0 || gy >= grid.ny) {
+                    continue;
+                }
+                // inside the faces of the ring only the cells at the two ends of the row are on it
+                int step = (dz == -ring || dz == ring || dy == -ring || dy == ring) ? 1 : 2 * ring;
+                for (int dx = -ring; dx <= ring; dx += step) {
+                    int gx = cx + dx;
+                    if (gx < 0 || gx >= grid.nx) {
+                        continue;
+                    }
+                    int c = (gz * grid.ny + gy) * grid.nx + gx;
+                    for (int i = grid.first[c]; i < grid.first[c + 1]; i++) {
+                        int index = grid.star[i];
+                        if (starDistanceSquared(index, x, y, z) > max_distance_squared) {
+                            continue;
+                        } else if (filter != NULL && filter(star_base + index, arg) == FALSE) {
+                            continue;
+                        }
+                        starInsert(index, x, y, z, found, &count, k);
+                    }
+                }
+            }
+        }
+
+        // a star in a cell outside this ring is at least this far away along one of the axes
+        long reach = (long) ring * grid.cell_size + 1;
+        if (reach * reach > max_distance_squared) {
+            break;
+        } else if (count == k && starDistanceSquared(found[k - 1], x, y, z) < reach * reach) {
+            break;
+        }
+    }
+
+    return count;
+}
+
+
+// starToCell returns the cell along one axis holding an offset from the corner of the grid.
+static int starToCell(int offset) {
+    if (offset < 0) {
+        return -((-offset + grid.cell_size - 1) / grid.cell_size);
+    }
+    return offset / grid.cell_size;
+}
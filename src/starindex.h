@@ -0,0 +1,46 @@
+// Far Horizons Game Engine
+// Copyright (C) 2022 Michael D Henderson
+// Copyright (C) 2021 Raven Zachary
+// Copyright (C) 2019 Casey Link, Adam Piggott
+// Copyright (C) 1999 Richard A. Morneau
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef FAR_HORIZONS_STARINDEX_H
+#define FAR_HORIZONS_STARINDEX_H
+
+#include "engine.h"
+
+// The star index buckets the stars into a uniform grid of cubic cells so that searches
+// only look at the cells near the search point. It is built from star_base the first
+// time it is used and is thrown away whenever the star data are loaded. Because it is
+// built on first use, a caller that searches from several threads must build it
+// before starting them.
+//
+// Searches return star indexes ordered by distance and, for stars at the same distance,
+// by index, which is the order a scan of star_base would have found them in.
+
+// star_filter_t returns TRUE if a search should return the star.
+typedef int (*star_filter_t)(star_data_t *star, int arg);
+
+void starIndexBuild(void);
+
+void starIndexReset(void);
+
+int starNearest(int x, int y, int z, int max_distance_squared, star_filter_t filter, int arg, int *found, int k);
+
+int starsWithin(int x, int y, int z, int max_distance_squared, star_filter_t filter, int arg, int *found);
+
+#endif //FAR_HORIZONS_STARINDEX_H
@@ -20,10 +20,16 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include "arena.h"
 #include "data.h"
+#include "datafile.h"
 #include "galaxy.h"
 #include "galaxyio.h"
+#include "resident.h"
+#include "sector.h"
 #include "star.h"
+#include "starindex.h"
 #include "stario.h"
 
 
@@ -33,13 +39,42 @@ struct star_data *star_base;
 
 int star_data_modified;
 
+// format of stars.dat when it was loaded; saves keep the same format
+int star_data_version = 1;
+
+// backs star_base when a version 2 file is used in place
+static datafile_t starFile;
+
 // number of natural wormholes
 int num_natural_wormholes = 0;
 
+
+static int getStarDataV2(void);
+
+static void linkWormholes(void);
+
+
 void get_star_data(void) {
     int32_t numStars;
     binary_star_data_t *starData;
 
+    // the sector and star indexes point into the star data
+    sectorReset();
+    starIndexReset();
+
+    if (galaxy_resident) {
+        residentGetStarData();
+        return;
+    }
+
+    datafileClose(&starFile);
+    if (getStarDataV2()) {
+        linkWormholes();
+        star_data_version = 2;
+        star_data_modified = FALSE;
+        return;
+    }
+
     /* Open star file. */
     FILE *fp = fopen("stars.dat", "rb");
     if (fp == NULL) {
@@ -54,7 +89,7 @@ void get_star_data(void) {
     }
 
     /* Allocate enough memory for all stars plus maybe an extra few. */
-    starData = (binary_star_data_t *) ncalloc(__FUNCTION__, __LINE__, numStars, sizeof(binary_star_data_t));
+    starData = (binary_star_data_t *) arenaAlloc(__FUNCTION__, __LINE__, numStars, sizeof(binary_star_data_t));
     if (starData == NULL) {
         fprintf(stderr, "\nCannot allocate enough memory for star file!\n");
         fprintf(stderr, "\n\tattempted to allocate %d star entries\n\n", numStars);
@@ -103,7 +138,39 @@ void get_star_data(void) {
 
     }
 
-    // link wormholes
+    linkWormholes();
+    star_data_version = 1;
+
+    star_data_modified = FALSE;
+}
+
+
+// getStarDataV2 loads stars.dat if it is a version 2 file.
+// Returns FALSE if it is not.
+static int getStarDataV2(void) {
+    datafile_t df;
+    if (!datafileOpen("stars.dat", &df)) {
+        return FALSE;
+    }
+    struct star_data *records = datafileSection(&df, 0, sizeof(struct star_data), &num_stars);
+    if (map_data_in_place) {
+        star_base = records;
+        starFile = df;
+    } else {
+        star_base = (struct star_data *) ncalloc(__FUNCTION__, __LINE__, num_stars + NUM_EXTRA_STARS, sizeof(struct star_data));
+        memcpy(star_base, records, num_stars * sizeof(struct star_data));
+        datafileClose(&df);
+    }
+    for (int i = 0; i < num_stars; i++) {
+        star_base[i].id = i + 1;
+        star_base[i].index = i;
+    }
+    return TRUE;
+}
+
+
+// linkWormholes sets wormholeExit on both ends of every natural wormhole.
+static void linkWormholes(void) {
     num_natural_wormholes = 0;
     for (int i = 0; i < num_stars; i++) {
         struct star_data *s = &star_base[i];
@@ -119,14 +186,22 @@ void get_star_data(void) {
             }
         }
     }
-
-    star_data_modified = FALSE;
-
-    free(starData);
 }
 
 
 void save_star_data(void) {
+    if (galaxy_resident) {
+        residentSaveStarData();
+        star_data_modified = FALSE;
+        return;
+    }
+
+    if (star_data_version == 2) {
+        saveStarDataV2(star_base, num_stars, "stars.dat");
+        star_data_modified = FALSE;
+        return;
+    }
+
     // open star file for writing
     FILE *fp = fopen("stars.dat", "wb");
     if (fp == NULL) {
@@ -149,7 +224,7 @@ void saveStarData(star_data_t *starBase, int numStars, FILE *fp) {
         fprintf(stderr, "error: saveStarData: internal error: passed null file pointer\n");
         exit(2);
     }
-    binary_star_data_t *starData = (binary_star_data_t *) ncalloc(__FUNCTION__, __LINE__, numStars, sizeof(binary_star_data_t));
+    binary_star_data_t *starData = (binary_star_data_t *) arenaAlloc(__FUNCTION__, __LINE__, numStars, sizeof(binary_star_data_t));
     if (starData == NULL) {
         perror("saveStarData:");
         fprintf(stderr, "error: cannot allocate enough memory to convert stars data\n");
@@ -196,8 +271,6 @@ void saveStarData(star_data_t *starBase, int numStars, FILE *fp) {
 
     // we no longer do this; the caller is responsible
     // star_data_modified = FALSE;
-
-    free(starData);
 }
 
 
@@ -228,3 +301,18 @@ void starDataAsSExpr(star_data_t *starBase, int numStars, FILE *fp) {
     fprintf(fp, ")\n");
 }
 
+
+// saveStarDataV2 writes the stars as a version 2 file.
+void saveStarDataV2(star_data_t *starBase, int numStars, const char *filename) {
+    star_data_t *records = (star_data_t *) ncalloc(__FUNCTION__, __LINE__, numStars + 1, sizeof(star_data_t));
+    memcpy(records, starBase, numStars * sizeof(star_data_t));
+    for (int i = 0; i < numStars; i++) {
+        records[i].wormholeExit = NULL;
+        memset(records[i].planets, 0, sizeof(records[i].planets));
+    }
+    void *sections[1] = {records};
+    int recordSize[1] = {sizeof(star_data_t)};
+    int numRecords[1] = {numStars};
+    datafileWrite(filename, NULL, 1, sections, recordSize, numRecords);
+    free(records);
+}
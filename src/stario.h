@@ -30,6 +30,8 @@ void save_star_data(void);
 
 void saveStarData(star_data_t *starBase, int numStars, FILE *fp);
 
+void saveStarDataV2(star_data_t *starBase, int numStars, const char *filename);
+
 void starDataAsSExpr(star_data_t *starBase, int numStars, FILE *fp);
 
 
@@ -38,5 +40,6 @@ void starDataAsSExpr(star_data_t *starBase, int numStars, FILE *fp);
 extern int num_stars;
 extern struct star_data *star_base;
 extern int star_data_modified;
+extern int star_data_version;
 
 #endif //FAR_HORIZONS_STARIO_H
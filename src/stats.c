@@ -19,6 +19,7 @@
 
 #include <stdio.h>
 #include "commandvars.h"
+#include "datafile.h"
 #include "galaxy.h"
 #include "galaxyio.h"
 #include "namplavars.h"
@@ -33,6 +34,7 @@
 int statsCommand(int argc, char *argv[]) {
     const char *cmdName = argv[0];
 
+    map_data_in_place = TRUE;
     printf("fh: %s: loading   galaxy   data...\n", cmdName);
     get_galaxy_data();
     printf("fh: %s: loading   planet   data...\n", cmdName);
@@ -22,8 +22,6 @@
 
 /* Interspecies transactions. */
 
-#define MAX_TRANSACTIONS        1000
-
 #define EU_TRANSFER                1
 #define MESSAGE_TO_SPECIES         2
 #define BESIEGE_PLANET             3
@@ -22,13 +22,34 @@
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
+#include "arena.h"
 #include "engine.h"
+#include "resident.h"
 #include "transactionio.h"
 
+// the number of transaction types, including the unused type zero
+#define TRANSACTION_TYPES 16
 
+#define TO   0
+#define FROM 1
+
+
+// the transactions, in the order they were added. the array grows as needed.
 int num_transactions;
+struct trans_data *transaction;
 
-struct trans_data transaction[MAX_TRANSACTIONS];
+// the transactions are chained together by recipient and by donor, in the order they were added.
+// for each species there is one chain with all of its transactions and one for each type, so
+// first[TO][species][0] is the first transaction for the species and first[TO][species][type] is
+// the first one of that type. callers fill in a transaction after adding it, so the chains are
+// extended to the new transactions the next time they are walked.
+static struct {
+    int max_transactions;
+    int num_chained;                                    // number of transactions on the chains
+    int (*next)[2][2];                                  // [index][TO or FROM][all or same type], or -1
+    int first[2][MAX_SPECIES + 1][TRANSACTION_TYPES];   // index plus one, or zero if the chain is empty
+    int last[2][MAX_SPECIES + 1][TRANSACTION_TYPES];    // index plus one, or zero if the chain is empty
+} trans;
 
 
 typedef struct {
@@ -48,36 +69,52 @@ typedef struct {
     uint8_t name3[40];
 } binary_ship_data_t;
 
+
+static void transactionChain(void);
+
+static int transactionDonor(const trans_data_t *t);
+
+static int transactionFirst(int direction, int species_number, int type);
+
+static void transactionGrow(void);
+
+static int transactionNext(int direction, int index, int type);
+
+static int transactionRecipient(const trans_data_t *t);
+
+
 /* Read transactions from file. */
 void get_transaction_data(void) {
+    if (galaxy_resident) {
+        residentGetTransactionData();
+        return;
+    }
+
+    transactionReset();
+
     /* Get size of file. */
     struct stat sb;
     if (stat("interspecies.dat", &sb) != 0) {
-        num_transactions = 0;
         return;
     }
 
     // get number of records in the file
-    num_transactions = sb.st_size / sizeof(binary_ship_data_t);
-    if (sb.st_size != num_transactions * sizeof(binary_ship_data_t)) {
+    int numRecords = sb.st_size / sizeof(binary_ship_data_t);
+    if (sb.st_size != numRecords * sizeof(binary_ship_data_t)) {
         fprintf(stderr, "\nFile interspecies.dat contains extra bytes (%ld > %ld)!\n\n",
-                sb.st_size, num_transactions * sizeof(binary_ship_data_t));
+                sb.st_size, numRecords * sizeof(binary_ship_data_t));
         exit(-1);
-    } else if (num_transactions == 0) {
+    } else if (numRecords == 0) {
         // nothing to do
         return;
-    } else if (num_transactions > MAX_TRANSACTIONS) {
-        fprintf(stderr, "\nFile interspecies.dat contains too many records (%d > %d)!\n\n", num_transactions,
-                MAX_TRANSACTIONS);
-        exit(-1);
     }
 
     /* Allocate enough memory for all records. */
-    binary_ship_data_t *binData = (binary_ship_data_t *) ncalloc(__FUNCTION__, __LINE__, num_transactions, sizeof(binary_ship_data_t));
+    binary_ship_data_t *binData = (binary_ship_data_t *) arenaAlloc(__FUNCTION__, __LINE__, numRecords, sizeof(binary_ship_data_t));
     if (binData == NULL) {
         perror("get_transaction_data");
         fprintf(stderr, "\nCannot allocate enough memory for transaction data!\n");
-        fprintf(stderr, "\n\tattempted to allocate %d transaction entries\n\n", num_transactions);
+        fprintf(stderr, "\n\tattempted to allocate %d transaction entries\n\n", numRecords);
         exit(-1);
     }
 
@@ -90,37 +127,42 @@ void get_transaction_data(void) {
     }
 
     /* Read it all into memory. */
-    if (fread(binData, sizeof(binary_ship_data_t), num_transactions, fp) != num_transactions) {
+    if (fread(binData, sizeof(binary_ship_data_t), numRecords, fp) != numRecords) {
         fprintf(stderr, "\nCannot read file 'interspecies.dat' into memory!\n");
-        fprintf(stderr, "\n\tattempted to read %d transaction entries\n\n", num_transactions);
+        fprintf(stderr, "\n\tattempted to read %d transaction entries\n\n", numRecords);
         exit(-1);
     }
 
     /* translate data */
-    for (int i = 0; i < num_transactions; i++) {
-        transaction[i].type = binData[i].type;
-        transaction[i].donor = binData[i].donor;
-        transaction[i].recipient = binData[i].recipient;
-        transaction[i].value = binData[i].value;
-        transaction[i].x = binData[i].x;
-        transaction[i].y = binData[i].y;
-        transaction[i].z = binData[i].z;
-        transaction[i].pn = binData[i].pn;
-        transaction[i].number1 = binData[i].number1;
-        transaction[i].number2 = binData[i].number2;
-        transaction[i].number3 = binData[i].number3;
-        memcpy(transaction[i].name1, binData[i].name1, 40);
-        memcpy(transaction[i].name2, binData[i].name2, 40);
-        memcpy(transaction[i].name3, binData[i].name3, 40);
+    for (int i = 0; i < numRecords; i++) {
+        int n = transactionAdd();
+        trans_data_t *t = &transaction[n];
+        t->type = binData[i].type;
+        t->donor = binData[i].donor;
+        t->recipient = binData[i].recipient;
+        t->value = binData[i].value;
+        t->x = binData[i].x;
+        t->y = binData[i].y;
+        t->z = binData[i].z;
+        t->pn = binData[i].pn;
+        t->number1 = binData[i].number1;
+        t->number2 = binData[i].number2;
+        t->number3 = binData[i].number3;
+        memcpy(t->name1, binData[i].name1, 40);
+        memcpy(t->name2, binData[i].name2, 40);
+        memcpy(t->name3, binData[i].name3, 40);
     }
 
     fclose(fp);
-
-    free(binData);
 }
 
 
 void save_transaction_data(void) {
+    if (galaxy_resident) {
+        residentSaveTransactionData();
+        return;
+    }
+
     /* Open file 'interspecies.dat' for writing. */
     FILE *fp = fopen("interspecies.dat", "wb");
     if (fp == NULL) {
@@ -131,7 +173,7 @@ void save_transaction_data(void) {
 
     if (num_transactions > 0) {
         /* Allocate enough memory for all records. */
-        binary_ship_data_t *binData = (binary_ship_data_t *) ncalloc(__FUNCTION__, __LINE__, num_transactions, sizeof(binary_ship_data_t));
+        binary_ship_data_t *binData = (binary_ship_data_t *) arenaAlloc(__FUNCTION__, __LINE__, num_transactions, sizeof(binary_ship_data_t));
         if (binData == NULL) {
             perror("save_transaction_data");
             fprintf(stderr, "\nCannot allocate enough memory for transaction data!\n");
@@ -166,12 +208,22 @@ void save_transaction_data(void) {
             }
         }
 
-        free(binData);
     }
     fclose(fp);
 }
 
 
+// transactionAdd adds an empty transaction to the end of the array and returns its index.
+int transactionAdd(void) {
+    if (num_transactions == trans.max_transactions) {
+        transactionGrow();
+    }
+    int index = num_transactions++;
+    memset(&transaction[index], 0, sizeof(trans_data_t));
+    return index;
+}
+
+
 void transactionDataAsJson(FILE *fp) {
     fprintf(fp, "[\n");
     for (int i = 0; i < num_transactions; i++) {
@@ -205,3 +257,148 @@ void transactionDataAsSExpr(FILE *fp) {
     }
     fprintf(fp, ")\n");
 }
+
+
+// transactionFirstFrom returns the index of the first transaction of the type that the species is the donor of,
+// or -1 if there isn't one. A type of zero matches every type.
+// Use transactionNextFrom with the same type to visit the others, in the order they appear in the transaction array.
+int transactionFirstFrom(int species_number, int type) {
+    return transactionFirst(FROM, species_number, type);
+}
+
+
+// transactionFirstTo returns the index of the first transaction of the type that is meant for the species,
+// or -1 if there isn't one. A type of zero matches every type.
+// Use transactionNextTo with the same type to visit the others, in the order they appear in the transaction array.
+int transactionFirstTo(int species_number, int type) {
+    return transactionFirst(TO, species_number, type);
+}
+
+
+// transactionNextFrom returns the index of the next transaction with the same donor, or -1 if there are no more.
+int transactionNextFrom(int index, int type) {
+    return transactionNext(FROM, index, type);
+}
+
+
+// transactionNextTo returns the index of the next transaction for the same species, or -1 if there are no more.
+int transactionNextTo(int index, int type) {
+    return transactionNext(TO, index, type);
+}
+
+
+// transactionReplace replaces all the transactions with a copy of the given ones.
+void transactionReplace(const trans_data_t *data, int count) {
+    transactionReset();
+    for (int i = 0; i < count; i++) {
+        int n = transactionAdd();
+        transaction[n] = data[i];
+    }
+}
+
+
+// transactionReset removes all the transactions.
+void transactionReset(void) {
+    num_transactions = 0;
+    trans.num_chained = 0;
+    memset(trans.first, 0, sizeof(trans.first));
+    memset(trans.last, 0, sizeof(trans.last));
+}
+
+
+// transactionChain adds the transactions that are not on the chains yet to the end of their chains.
+static void transactionChain(void) {
+    for (; trans.num_chained < num_transactions; trans.num_chained++) {
+        int index = trans.num_chained;
+        trans_data_t *t = &transaction[index];
+        for (int direction = TO; direction <= FROM; direction++) {
+            trans.next[index][direction][0] = -1;
+            trans.next[index][direction][1] = -1;
+            int species_number = direction == TO ? transactionRecipient(t) : transactionDonor(t);
+            if (species_number < 1 || species_number > MAX_SPECIES) {
+                continue;
+            }
+            for (int chain = 0; chain < 2; chain++) {
+                int type = chain == 0 ? 0 : t->type;
+                if (type < 0 || type >= TRANSACTION_TYPES || (chain == 1 && type == 0)) {
+                    continue;
+                }
+                int last = trans.last[direction][species_number][type];
+                if (last == 0) {
+                    trans.first[direction][species_number][type] = index + 1;
+                } else {
+                    trans.next[last - 1][direction][chain] = index;
+                }
+                trans.last[direction][species_number][type] = index + 1;
+            }
+        }
+    }
+}
+
+
+// transactionDonor returns the number of the species that a transaction comes from.
+static int transactionDonor(const trans_data_t *t) {
+    switch (t->type) {
+        case BESIEGE_PLANET:
+        case MESSAGE_TO_SPECIES:
+            return t->number1;
+        default:
+            return t->donor;
+    }
+}
+
+
+// transactionFirst returns the index of the first transaction on a chain, or -1 if the chain is empty.
+static int transactionFirst(int direction, int species_number, int type) {
+    transactionChain();
+    if (species_number < 1 || species_number > MAX_SPECIES || type < 0 || type >= TRANSACTION_TYPES) {
+        return -1;
+    }
+    return trans.first[direction][species_number][type] - 1;
+}
+
+
+// transactionGrow doubles the space for transactions.
+static void transactionGrow(void) {
+    int size = trans.max_transactions == 0 ? 1024 : 2 * trans.max_transactions;
+    trans_data_t *data = (trans_data_t *) ncalloc(__FUNCTION__, __LINE__, size, sizeof(trans_data_t));
+    int (*next)[2][2] = ncalloc(__FUNCTION__, __LINE__, size, sizeof(*next));
+    if (num_transactions > 0) {
+        memcpy(data, transaction, num_transactions * sizeof(trans_data_t));
+        memcpy(next, trans.next, num_transactions * sizeof(*next));
+    }
+    free(transaction);
+    free(trans.next);
+    transaction = data;
+    trans.next = next;
+    trans.max_transactions = size;
+}
+
+
+// transactionNext returns the index of the next transaction on the chain that the transaction is on, or -1 if there are no more.
+static int transactionNext(int direction, int index, int type) {
+    transactionChain();
+    return trans.next[index][direction][type == 0 ? 0 : 1];
+}
+
+
+// transactionRecipient returns the number of the species that a transaction is meant for.
+// Most types use the recipient field, but some name the species in one of the other fields.
+static int transactionRecipient(const trans_data_t *t) {
+    switch (t->type) {
+        case SHIP_MISHAP:
+        case ALIEN_JUMP_PORTAL_USAGE:
+        case TELESCOPE_DETECTION:
+        case LANDING_REQUEST:
+            return t->number1;
+        case BESIEGE_PLANET:
+        case MESSAGE_TO_SPECIES:
+            return t->number2;
+        case DETECTION_DURING_SIEGE:
+            return t->number3;
+        case ASSIMILATION:
+            return t->value;
+        default:
+            return t->recipient;
+    }
+}
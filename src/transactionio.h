@@ -27,14 +27,28 @@ void get_transaction_data(void);
 
 void save_transaction_data(void);
 
+int transactionAdd(void);
+
 void transactionDataAsJson(FILE *fp);
 
 void transactionDataAsSExpr(FILE *fp);
 
+int transactionFirstFrom(int species_number, int type);
+
+int transactionFirstTo(int species_number, int type);
+
+int transactionNextFrom(int index, int type);
+
+int transactionNextTo(int index, int type);
+
+void transactionReplace(const trans_data_t *data, int count);
+
+void transactionReset(void);
+
 
 // globals. ugh.
 
 extern int num_transactions;
-extern struct trans_data transaction[MAX_TRANSACTIONS];
+extern struct trans_data *transaction;
 
 #endif //FAR_HORIZONS_TRANSACTIONIO_H